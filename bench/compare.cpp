@@ -0,0 +1,146 @@
+#include "microbench.h"
+
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+using namespace LIB_RATSS_NAMESPACE;
+using namespace LIB_RATSS_NAMESPACE::bench;
+
+struct Config {
+	std::string baselineFileName;
+	std::string currentFileName;
+	std::string filter;
+	///allowed slowdown in percent
+	double threshold;
+	double confidence;
+
+	Config() : threshold(10), confidence(0.95) {}
+
+	void help(std::ostream & out) const {
+		out << "prg OPTIONS baseline.json current.json\n"
+			"Compares benchmark results written by micro -j.\n"
+			"A case regresses if its median is more than threshold percent slower than the baseline\n"
+			"and the confidence intervals of both medians do not overlap.\n"
+			"Cases of the baseline without a current result are missing and fail as well.\n"
+			"Options:\n"
+			"\t-t percent\tallowed slowdown, default 10\n"
+			"\t-c confidence\tconfidence of the median intervals, default 0.95\n"
+			"\t-f str\tonly compare cases whose key contains str\n"
+			<< std::endl;
+	}
+
+	int parse(int argc, char ** argv) {
+		std::vector<std::string> files;
+		for(int i(1); i < argc; ++i) {
+			std::string token(argv[i]);
+			if (token == "-h" || token == "--help") {
+				help(std::cout);
+				return 0;
+			}
+			else if ((token == "-t" || token == "-c" || token == "-f") && i+1 < argc) {
+				std::string value(argv[i+1]);
+				++i;
+				if (token == "-t") {
+					threshold = ::atof(value.c_str());
+				}
+				else if (token == "-c") {
+					confidence = ::atof(value.c_str());
+				}
+				else {
+					filter = value;
+				}
+			}
+			else {
+				files.push_back(token);
+			}
+		}
+		if (files.size() != 2) {
+			help(std::cerr);
+			return -1;
+		}
+		baselineFileName = files[0];
+		currentFileName = files[1];
+		return 1;
+	}
+};
+
+std::vector<Result> read(const std::string & fileName) {
+	std::ifstream in(fileName);
+	if (!in.is_open()) {
+		throw std::runtime_error("Could not open " + fileName);
+	}
+	return readJson(in);
+}
+
+int main(int argc, char ** argv) {
+	Config cfg;
+	int ret = cfg.parse(argc, argv);
+	if (ret <= 0) {
+		return ret;
+	}
+
+	std::map<std::string, Result> baseline;
+	std::vector<Result> current;
+	try {
+		for(Result & r : read(cfg.baselineFileName)) {
+			baseline[r.key()] = std::move(r);
+		}
+		current = read(cfg.currentFileName);
+	}
+	catch (const std::exception & e) {
+		std::cerr << e.what() << std::endl;
+		return -1;
+	}
+
+	std::size_t regressions = 0;
+	std::size_t compared = 0;
+	std::size_t missing = 0;
+	std::set<std::string> seen;
+	std::cout << std::fixed << std::setprecision(1);
+	for(const Result & cur : current) {
+		std::string key = cur.key();
+		if (cfg.filter.size() && key.find(cfg.filter) == std::string::npos) {
+			continue;
+		}
+		auto it = baseline.find(key);
+		if (it == baseline.end()) {
+			std::cout << "NEW        " << key << ": " << cur.median() << " ns/op\n";
+			continue;
+		}
+		const Result & base = it->second;
+		seen.insert(key);
+		++compared;
+
+		auto baseCi = medianConfidenceInterval(base.samples, cfg.confidence);
+		auto curCi = medianConfidenceInterval(cur.samples, cfg.confidence);
+		double change = (base.median() > 0 ? 100*(cur.median()/base.median() - 1) : 0);
+		bool slower = change > cfg.threshold && curCi.first > baseCi.second;
+		bool faster = change < -cfg.threshold && curCi.second < baseCi.first;
+		if (slower) {
+			++regressions;
+		}
+		std::cout << (slower ? "REGRESSION " : (faster ? "IMPROVED   " : "OK         "))
+			<< key << ": "
+			<< base.median() << " [" << baseCi.first << ", " << baseCi.second << "] -> "
+			<< cur.median() << " [" << curCi.first << ", " << curCi.second << "] ns/op ("
+			<< std::showpos << change << std::noshowpos << "%)\n";
+	}
+	//a renamed or crashed benchmark must not pass the gate
+	for(const auto & x : baseline) {
+		if (cfg.filter.size() && x.first.find(cfg.filter) == std::string::npos) {
+			continue;
+		}
+		if (!seen.count(x.first)) {
+			++missing;
+			std::cout << "MISSING    " << x.first << ": " << x.second.median() << " ns/op\n";
+		}
+	}
+	std::cout << compared << " cases compared, " << regressions << " regressions, " << missing << " missing" << std::endl;
+	if (!compared) {
+		std::cerr << "No case of the current run matches the baseline" << std::endl;
+	}
+	return (regressions || missing || !compared ? 1 : 0);
+}
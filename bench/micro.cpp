@@ -0,0 +1,773 @@
+#include <libratss/ProjectSN.h>
+#include <libratss/ProjectSNBatch.h>
+#include <libratss/GeoCalc.h>
+#include <libratss/SpherePredicates.h>
+#include <libratss/util/InputOutputPoints.h>
+
+#include "microbench.h"
+
+#ifdef LIB_RATSS_WITH_CGAL
+#include <libratss/CGAL/ExtendedInt64z.h>
+#include <libratss/CGAL/ExtendedInt64q.h>
+#include <libratss/CGAL/ExtendedInt64Cartesian.h>
+#include <libratss/CGAL/ExtendedInt64Pool.h>
+#include <libratss/CGAL/FixedRational.h>
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+#include <CGAL/Delaunay_triangulation_2.h>
+#endif
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace LIB_RATSS_NAMESPACE;
+using namespace LIB_RATSS_NAMESPACE::bench;
+
+///number of distinct inputs each case cycles through
+constexpr std::size_t NUM_INPUTS = 64;
+
+struct Config {
+	std::vector<int> dimensions;
+	std::vector<int> significands;
+	Runner::Options opts;
+	std::string jsonFileName;
+	bool table;
+	bool limbPool;
+
+	Config() : dimensions{3, 5, 10}, significands{31, 53, 64, 128}, table(true), limbPool(false) {}
+
+	static std::vector<int> parseList(const std::string & str) {
+		std::vector<int> result;
+		std::stringstream ss(str);
+		std::string item;
+		while (std::getline(ss, item, ',')) {
+			result.push_back(::atoi(item.c_str()));
+		}
+		return result;
+	}
+
+	void help(std::ostream & out) const {
+		out << "prg OPTIONS\n"
+			"Options:\n"
+			"\t-d d1,d2,...\tdimensions to benchmark\n"
+			"\t-e e1,e2,...\tsignificands to benchmark\n"
+			"\t-r num\trepetitions of each benchmark\n"
+			"\t-t ms\tminimal time of a single repetition in milliseconds\n"
+			"\t-f str\tonly run benchmarks whose key contains str\n"
+			"\t-j path\twrite results as json to path, - for stdout\n"
+			"\t-v\tverbose\n"
+			"\t-l\tpool the limb buffers of gmp (CGAL::GmpLimbPool)\n"
+			<< std::endl;
+	}
+
+	int parse(int argc, char ** argv) {
+		for(int i(1); i < argc; ++i) {
+			std::string token(argv[i]);
+			if (token == "-h" || token == "--help") {
+				help(std::cout);
+				return 0;
+			}
+			else if (token == "-v") {
+				opts.verbose = true;
+				continue;
+			}
+			else if (token == "-l") {
+				limbPool = true;
+				continue;
+			}
+			if (i+1 >= argc) {
+				help(std::cerr);
+				return -1;
+			}
+			std::string value(argv[i+1]);
+			++i;
+			if (token == "-d") {
+				dimensions = parseList(value);
+			}
+			else if (token == "-e") {
+				significands = parseList(value);
+			}
+			else if (token == "-r") {
+				opts.repetitions = std::max(1, ::atoi(value.c_str()));
+			}
+			else if (token == "-t") {
+				opts.minTime = ::atof(value.c_str());
+			}
+			else if (token == "-f") {
+				opts.filter = value;
+			}
+			else if (token == "-j") {
+				jsonFileName = value;
+				table = (value != "-");
+			}
+			else {
+				std::cerr << "Unknown option: " << token << std::endl;
+				help(std::cerr);
+				return -1;
+			}
+		}
+		return 1;
+	}
+};
+
+///Deterministic random inputs
+class Inputs {
+public:
+	Inputs() : m_rnd(gmp_randinit_default) {
+		m_rnd.seed(0xBEEF);
+	}
+	///uniform in [-1, 1]
+	mpfr::mpreal value(int precision) {
+		mpz_class bits = m_rnd.get_z_bits(precision);
+		mpfr::mpreal v(0, precision);
+		mpfr_set_z_2exp(v.mpfr_ptr(), bits.get_mpz_t(), -precision, MPFR_RNDN);
+		return 2*v-1;
+	}
+	///points on the unit sphere
+	std::vector< std::vector<mpfr::mpreal> > points(int dimension, int precision, std::size_t count = NUM_INPUTS) {
+		Calc calc;
+		std::vector< std::vector<mpfr::mpreal> > result(count);
+		for(auto & p : result) {
+			for(int i(0); i < dimension; ++i) {
+				p.push_back(value(precision));
+			}
+			calc.normalize(p.begin(), p.end(), p.begin());
+			for(auto & x : p) {
+				x.setPrecision(precision, MPFR_RNDZ);
+			}
+		}
+		return result;
+	}
+	std::vector<mpq_class> rationals(int precision) {
+		std::vector<mpq_class> result;
+		for(std::size_t i(0); i < NUM_INPUTS; ++i) {
+			result.push_back(Conversion<mpfr::mpreal>::toMpq(value(precision)));
+		}
+		return result;
+	}
+private:
+	gmp_randclass m_rnd;
+};
+
+int precisionFor(int significands) {
+	return std::max(53, 2*significands);
+}
+
+void benchConversion(Runner & runner, const Config & cfg) {
+	Inputs inputs;
+	std::vector<double> doubles;
+	for(std::size_t i(0); i < NUM_INPUTS; ++i) {
+		doubles.push_back(inputs.value(53).toDouble());
+	}
+	runner.run("Conversion<double>::toMpq", "", 1, 53, 53, [&](std::size_t i) {
+		mpq_class r = Conversion<double>::toMpq(doubles[i % NUM_INPUTS]);
+		doNotOptimize(r);
+	});
+	for(int e : cfg.significands) {
+		int prec = precisionFor(e);
+		std::vector<mpfr::mpreal> values;
+		for(std::size_t i(0); i < NUM_INPUTS; ++i) {
+			values.push_back(inputs.value(prec));
+		}
+		runner.run("Conversion<mpfr::mpreal>::toMpq", "", 1, e, prec, [&](std::size_t i) {
+			mpq_class r = Conversion<mpfr::mpreal>::toMpq(values[i % NUM_INPUTS]);
+			doNotOptimize(r);
+		});
+		mpq_class out;
+		runner.run("Conversion<mpfr::mpreal>::toMpq", "reuse", 1, e, prec, [&](std::size_t i) {
+			Conversion<mpfr::mpreal>::toMpq(values[i % NUM_INPUTS], out);
+			doNotOptimize(out);
+		});
+		//power of two denominators as produced by ST_FX and general ones as produced by ST_CF
+		Calc calc;
+		std::vector<mpq_class> pow2(inputs.rationals(prec)), rationals;
+		for(const mpq_class & v : pow2) {
+			rationals.push_back(calc.contFrac(v, e));
+		}
+		for(const auto & x : {std::make_pair("pow2", &pow2), std::make_pair("", &rationals)}) {
+			const std::vector<mpq_class> & src = *x.second;
+			std::string variant(x.first);
+			runner.run("Conversion<mpq_class>::toMpreal", variant, 1, e, prec, [&](std::size_t i) {
+				mpfr::mpreal r = Conversion<mpq_class>::toMpreal(src[i % NUM_INPUTS], prec);
+				doNotOptimize(r);
+			});
+			mpfr::mpreal fout(0, prec);
+			runner.run("Conversion<mpq_class>::toMpreal", (variant.size() ? variant + " " : variant) + "reuse", 1, e, prec, [&](std::size_t i) {
+				Conversion<mpq_class>::toMpreal(src[i % NUM_INPUTS], fout.mpfr_ptr());
+				doNotOptimize(fout);
+			});
+		}
+	}
+}
+
+void benchCalc(Runner & runner, const Config & cfg) {
+	Calc calc;
+	Inputs inputs;
+	for(int e : cfg.significands) {
+		int prec = precisionFor(e);
+		std::vector<mpq_class> values = inputs.rationals(prec);
+		std::vector<mpq_class> values2 = inputs.rationals(prec);
+		mpq_class eps(mpz_class(1), mpz_class(1) << e);
+
+		runner.run("Calc::contFrac", "", 1, e, prec, [&](std::size_t i) {
+			mpq_class r = calc.contFrac(values[i % NUM_INPUTS], e);
+			doNotOptimize(r);
+		});
+		runner.run("Calc::within", "", 1, e, prec, [&](std::size_t i) {
+			const mpq_class & v = values[i % NUM_INPUTS];
+			mpq_class r = calc.within(v-eps, v+eps);
+			doNotOptimize(r);
+		});
+		runner.run("Calc::jacobiPerron2D", "", 2, e, prec, [&](std::size_t i) {
+			mpq_class r1, r2;
+			calc.jacobiPerron2D(abs(values[i % NUM_INPUTS]), abs(values2[i % NUM_INPUTS]), r1, r2, e);
+			doNotOptimize(r1);
+			doNotOptimize(r2);
+		});
+#ifdef LIB_RATSS_WITH_FPLLL
+		for(int d : cfg.dimensions) {
+			std::vector< std::vector<mpq_class> > vectors(NUM_INPUTS);
+			for(auto & v : vectors) {
+				for(int j(0); j < d; ++j) {
+					v.push_back(abs(inputs.rationals(prec).front()));
+				}
+			}
+			runner.run("Calc::lll", "", d, e, prec, [&](std::size_t i) {
+				const std::vector<mpq_class> & v = vectors[i % NUM_INPUTS];
+				std::vector<mpz_class> nums(v.size());
+				mpz_class denom;
+				calc.lll(v.begin(), v.end(), nums.begin(), denom, e);
+				doNotOptimize(denom);
+			});
+		}
+#endif
+	}
+}
+
+void benchSnap(Runner & runner, const Config & cfg) {
+	ProjectSN proj;
+	Inputs inputs;
+	std::vector<int> snapTypes = {
+		ProjectSN::ST_CF, ProjectSN::ST_FX, ProjectSN::ST_FL, ProjectSN::ST_JP,
+#ifdef LIB_RATSS_WITH_FPLLL
+		ProjectSN::ST_FPLLL,
+#endif
+	};
+	std::vector<int> locations = {ProjectSN::ST_PLANE, ProjectSN::ST_SPHERE};
+	for(int d : cfg.dimensions) {
+		for(int e : cfg.significands) {
+			int prec = precisionFor(e);
+			auto points = inputs.points(d, prec);
+			std::vector<mpq_class> out(d);
+			auto runSnap = [&](int st, const std::string & variant) {
+				runner.run("ProjectSN::snap", variant, d, e, prec, [&](std::size_t i) {
+					const auto & p = points[i % NUM_INPUTS];
+					proj.snap(p.begin(), p.end(), out.begin(), st, e);
+					doNotOptimize(out);
+				});
+			};
+			for(int loc : locations) {
+				for(int st : snapTypes) {
+					runSnap(st | loc, ProjectSN::toString((ProjectSN::SnapType)(st | loc)));
+				}
+			}
+			runSnap(ProjectSN::ST_PAPER | ProjectSN::ST_FX, ProjectSN::toString((ProjectSN::SnapType)(ProjectSN::ST_PAPER | ProjectSN::ST_FX)));
+			runSnap(
+				ProjectSN::ST_PLANE | ProjectSN::ST_AUTO | ProjectSN::ST_AUTO_CF | ProjectSN::ST_AUTO_FX | ProjectSN::ST_AUTO_FL | ProjectSN::ST_AUTO_POLICY_MIN_SUM_DENOM,
+				"ST_PLANE|ST_AUTO_CF|ST_AUTO_FX|ST_AUTO_FL|MIN_SUM_DENOM"
+			);
+			runSnap(
+				ProjectSN::ST_PLANE | ProjectSN::ST_AUTO | ProjectSN::ST_AUTO_CF | ProjectSN::ST_AUTO_FX | ProjectSN::ST_AUTO_FL | ProjectSN::ST_AUTO_POLICY_MIN_SQUARED_DISTANCE,
+				"ST_PLANE|ST_AUTO_CF|ST_AUTO_FX|ST_AUTO_FL|MIN_SQUARED_DISTANCE"
+			);
+			runSnap(
+				ProjectSN::ST_PLANE | ProjectSN::ST_AUTO | ProjectSN::ST_AUTO_CF | ProjectSN::ST_AUTO_FX | ProjectSN::ST_AUTO_FL | ProjectSN::ST_AUTO_POLICY_MIN_MAX_NORM,
+				"ST_PLANE|ST_AUTO_CF|ST_AUTO_FX|ST_AUTO_FL|MIN_MAX_NORM"
+			);
+
+			//plane2Sphere on snapped points in the plane
+			std::vector< std::vector<mpq_class> > planePoints(NUM_INPUTS);
+			std::vector<PositionOnSphere> positions(NUM_INPUTS);
+			for(std::size_t i(0); i < NUM_INPUTS; ++i) {
+				std::vector<mpfr::mpreal> tmp(d);
+				positions[i] = proj.sphere2Plane(points[i].begin(), points[i].end(), tmp.begin());
+				planePoints[i].resize(d);
+				proj.calc().toRational(tmp.begin(), tmp.end(), planePoints[i].begin(), ProjectSN::ST_FX, e);
+			}
+			runner.run("ProjectSN::plane2Sphere", "", d, e, prec, [&](std::size_t i) {
+				const auto & p = planePoints[i % NUM_INPUTS];
+				proj.plane2Sphere(p.begin(), p.end(), positions[i % NUM_INPUTS], out.begin());
+				doNotOptimize(out);
+			});
+
+			//the projection round trip of ST_SPHERE on points snapped on the sphere
+			std::vector<mpq_class> plane(d);
+			std::vector< std::vector<mpq_class> > spherePoints(NUM_INPUTS, std::vector<mpq_class>(d));
+			for(int st : {ProjectSN::ST_CF, ProjectSN::ST_FX}) {
+				std::string variant = ProjectSN::toString((ProjectSN::SnapType) st);
+				for(std::size_t i(0); i < NUM_INPUTS; ++i) {
+					proj.calc().toRational(points[i].begin(), points[i].end(), spherePoints[i].begin(), st, e);
+				}
+				runner.run("ProjectSN::sphere2Plane2Sphere", variant + " mpq", d, e, prec, [&](std::size_t i) {
+					const auto & p = spherePoints[i % NUM_INPUTS];
+					PositionOnSphere pos = proj.sphere2Plane(p.begin(), p.end(), plane.begin());
+					proj.plane2Sphere(plane.begin(), plane.end(), pos, out.begin());
+					doNotOptimize(out);
+				});
+				runner.run("ProjectSN::sphere2Plane2Sphere", variant + " homogeneous", d, e, prec, [&](std::size_t i) {
+					out = spherePoints[i % NUM_INPUTS];
+					PositionOnSphere pos = proj.sphere2Plane2Sphere(out);
+					doNotOptimize(pos);
+					doNotOptimize(out);
+				});
+			}
+
+			//grades of the auto snapping policies, spherePoints are snapped with ST_FX
+			mpfr::mpreal lower(0, 64), upper(0, 64);
+			runner.run("Calc::squaredDistance", "mpq", d, e, prec, [&](std::size_t i) {
+				const auto & p = points[i % NUM_INPUTS];
+				mpq_class r = proj.calc().squaredDistance(p.begin(), p.end(), spherePoints[i % NUM_INPUTS].begin());
+				doNotOptimize(r);
+			});
+			runner.run("Calc::squaredDistance", "bounds", d, e, prec, [&](std::size_t i) {
+				const auto & p = points[i % NUM_INPUTS];
+				proj.calc().squaredDistance(p.begin(), p.end(), spherePoints[i % NUM_INPUTS].begin(), lower, upper);
+				doNotOptimize(lower);
+				doNotOptimize(upper);
+			});
+			runner.run("Calc::maxNorm", "mpq", d, e, prec, [&](std::size_t i) {
+				const auto & p = points[i % NUM_INPUTS];
+				mpq_class r = proj.calc().maxNorm(p.begin(), p.end(), spherePoints[i % NUM_INPUTS].begin());
+				doNotOptimize(r);
+			});
+			runner.run("Calc::maxNorm", "bounds", d, e, prec, [&](std::size_t i) {
+				const auto & p = points[i % NUM_INPUTS];
+				proj.calc().maxNorm(p.begin(), p.end(), spherePoints[i % NUM_INPUTS].begin(), lower, upper);
+				doNotOptimize(lower);
+				doNotOptimize(upper);
+			});
+		}
+	}
+}
+
+void benchBatch(Runner & runner, const Config & cfg) {
+	constexpr std::size_t BATCH_SIZE = 4096;
+	ProjectSN proj;
+	Inputs inputs;
+	for(int d : cfg.dimensions) {
+		ProjectSNBatch batch(d);
+		batch.resize(BATCH_SIZE);
+		std::vector< std::vector<double> > points(BATCH_SIZE);
+		auto mpPoints = inputs.points(d, 53, BATCH_SIZE);
+		for(std::size_t j(0); j < BATCH_SIZE; ++j) {
+			for(const mpfr::mpreal & x : mpPoints[j]) {
+				points[j].push_back(x.toDouble());
+			}
+			batch.set(j, points[j].begin());
+		}
+		std::vector<double> plane(d);
+		//both process the whole batch
+		runner.run("ProjectSN::sphere2Plane", "double", d, 53, 53, [&](std::size_t) {
+			for(const std::vector<double> & p : points) {
+				PositionOnSphere pos = proj.sphere2Plane(p.begin(), p.end(), plane.begin());
+				doNotOptimize(pos);
+				doNotOptimize(plane);
+			}
+		});
+		runner.run("ProjectSN::sphere2Plane", "batch", d, 53, 53, [&](std::size_t) {
+			batch.sphere2Plane();
+			doNotOptimize(batch);
+		});
+	}
+}
+
+void benchGeoCalc(Runner & runner, const Config & cfg) {
+	GeoCalc gc;
+	Inputs inputs;
+	for(int e : cfg.significands) {
+		int prec = precisionFor(e);
+		std::vector<mpfr::mpreal> lat, lon;
+		for(std::size_t i(0); i < NUM_INPUTS; ++i) {
+			lat.push_back(inputs.value(prec)*90);
+			lon.push_back(inputs.value(prec)*180);
+		}
+		runner.run("GeoCalc::cartesian", "", 3, e, prec, [&](std::size_t i) {
+			mpfr::mpreal x, y, z;
+			gc.cartesian(lat[i % NUM_INPUTS], lon[i % NUM_INPUTS], x, y, z);
+			doNotOptimize(x);
+		});
+	}
+}
+
+///Predicates on snapped points, the mpq variant evaluates the same determinants on the rational coordinates
+void benchSpherePredicates(Runner & runner, const Config & cfg) {
+	ProjectSN proj;
+	Inputs inputs;
+	for(int e : cfg.significands) {
+		std::vector< std::vector<mpq_class> > snapped;
+		std::vector<SpherePoint> points;
+		for(const auto & p : inputs.points(3, precisionFor(e))) {
+			snapped.emplace_back(3);
+			proj.snap(p.begin(), p.end(), snapped.back().begin(), ProjectSN::ST_FX | ProjectSN::ST_PLANE, e);
+			points.emplace_back(snapped.back()[0], snapped.back()[1], snapped.back()[2]);
+		}
+		runner.run("SpherePredicates::orientation", "", 3, e, 0, [&](std::size_t i) {
+			int r = SpherePredicates::orientation(points[i % NUM_INPUTS], points[(i+1) % NUM_INPUTS], points[(i+2) % NUM_INPUTS]);
+			doNotOptimize(r);
+		});
+		runner.run("SpherePredicates::orientation", "mpq", 3, e, 0, [&](std::size_t i) {
+			const auto & p = snapped[i % NUM_INPUTS];
+			const auto & q = snapped[(i+1) % NUM_INPUTS];
+			const auto & r = snapped[(i+2) % NUM_INPUTS];
+			mpq_class det = p[0]*(q[1]*r[2] - q[2]*r[1]) - p[1]*(q[0]*r[2] - q[2]*r[0]) + p[2]*(q[0]*r[1] - q[1]*r[0]);
+			doNotOptimize(det);
+		});
+		runner.run("SpherePredicates::inCircle", "", 3, e, 0, [&](std::size_t i) {
+			int r = SpherePredicates::inCircle(points[i % NUM_INPUTS], points[(i+1) % NUM_INPUTS], points[(i+2) % NUM_INPUTS], points[(i+3) % NUM_INPUTS]);
+			doNotOptimize(r);
+		});
+	}
+}
+
+void benchParsers(Runner & runner, const Config & cfg) {
+	ProjectSN proj;
+	Inputs inputs;
+	for(int d : cfg.dimensions) {
+		for(int e : cfg.significands) {
+			int prec = precisionFor(e);
+			auto points = inputs.points(d, prec);
+			std::vector<std::string> floatLines, rationalLines, splitLines;
+			for(const auto & p : points) {
+				RationalPoint rp(d);
+				proj.snap(p.begin(), p.end(), rp.coords.begin(), ProjectSN::ST_FX | ProjectSN::ST_PLANE, e);
+				std::stringstream fss, rss, sss;
+				fss.precision(17);
+				for(std::size_t j(0); j < p.size(); ++j) {
+					fss << (j ? " " : "") << p[j].toDouble();
+				}
+				rp.print(rss, PointBase::FM_RATIONAL);
+				rp.print(sss, PointBase::FM_SPLIT_RATIONAL);
+				floatLines.push_back(fss.str());
+				rationalLines.push_back(rss.str());
+				splitLines.push_back(sss.str());
+			}
+			auto runParser = [&](const std::string & variant, const std::vector<std::string> & lines, PointBase::Format fmt) {
+				runner.run("RationalPoint::assign", variant, d, e, prec, [&, fmt](std::size_t i) {
+					std::istringstream is(lines[i % NUM_INPUTS]);
+					RationalPoint rp;
+					rp.assign(is, fmt, prec);
+					doNotOptimize(rp);
+				});
+				runner.run("RationalPoint::assign", variant + "-tokenizer", d, e, prec, [&, fmt](std::size_t i) {
+					Tokenizer tokenizer(lines[i % NUM_INPUTS]);
+					RationalPoint rp;
+					rp.assign(tokenizer, fmt, prec);
+					doNotOptimize(rp);
+				});
+			};
+			runParser("float", floatLines, PointBase::FM_FLOAT);
+			runParser("rational", rationalLines, PointBase::FM_RATIONAL);
+			runParser("split", splitLines, PointBase::FM_SPLIT_RATIONAL);
+
+			std::vector<RationalPoint> rationalPoints;
+			for(const std::string & line : rationalLines) {
+				rationalPoints.emplace_back(line, PointBase::FM_RATIONAL);
+			}
+			auto runPrinter = [&](const std::string & variant, PointBase::Format fmt) {
+				std::ostringstream os;
+				runner.run("RationalPoint::print", variant, d, e, prec, [&, fmt](std::size_t i) {
+					os.seekp(0);
+					rationalPoints[i % NUM_INPUTS].print(os, fmt);
+					doNotOptimize(os);
+				});
+				runner.run("RationalPoint::print", variant + "-buffer", d, e, prec, [&, fmt](std::size_t i) {
+					os.seekp(0);
+					OutputBuffer out(os, 4096);
+					rationalPoints[i % NUM_INPUTS].print(out, fmt);
+					doNotOptimize(out);
+				});
+			};
+			runPrinter("rational", PointBase::FM_RATIONAL);
+			runPrinter("split", PointBase::FM_SPLIT_RATIONAL);
+		}
+	}
+}
+
+#ifdef LIB_RATSS_WITH_CGAL
+///Numerators and denominators of snapped points in the plane, these are typical inputs of CGAL predicates
+std::vector<CGAL::ExtendedInt64z> snappedIntegers(ProjectSN & proj, Inputs & inputs, int snapType, int significands) {
+	std::vector<CGAL::ExtendedInt64z> result;
+	auto points = inputs.points(3, precisionFor(significands));
+	std::vector<mpq_class> out(3);
+	for(const auto & p : points) {
+		proj.snap(p.begin(), p.end(), out.begin(), snapType | ProjectSN::ST_PLANE, significands);
+		for(const mpq_class & v : out) {
+			result.emplace_back(v.get_num().get_str());
+			result.emplace_back(v.get_den().get_str());
+		}
+	}
+	return result;
+}
+
+void benchExtendedInt64(Runner & runner, const Config & cfg) {
+	using CGAL::ExtendedInt64z;
+	ProjectSN proj;
+	Inputs inputs;
+	std::vector<int> snapTypes = {ProjectSN::ST_FX, ProjectSN::ST_CF};
+	for(int e : cfg.significands) {
+		for(int st : snapTypes) {
+			std::vector<ExtendedInt64z> values = snappedIntegers(proj, inputs, st, e);
+			std::size_t n = values.size();
+			std::string variant = ProjectSN::toString((ProjectSN::SnapType) st);
+			runner.run("ExtendedInt64z::operator+=", variant, 1, e, 0, [&](std::size_t i) {
+				ExtendedInt64z r(values[i % n]);
+				r += values[(i+1) % n];
+				doNotOptimize(r);
+			});
+			runner.run("ExtendedInt64z::operator-=", variant, 1, e, 0, [&](std::size_t i) {
+				ExtendedInt64z r(values[i % n]);
+				r -= values[(i+1) % n];
+				doNotOptimize(r);
+			});
+			runner.run("ExtendedInt64z::operator*=", variant, 1, e, 0, [&](std::size_t i) {
+				ExtendedInt64z r(values[i % n]);
+				r *= values[(i+1) % n];
+				doNotOptimize(r);
+			});
+			//2x2 determinant as in orientation predicates
+			runner.run("ExtendedInt64z::det2", variant, 2, e, 0, [&](std::size_t i) {
+				ExtendedInt64z r(values[i % n]);
+				ExtendedInt64z tmp(values[(i+1) % n]);
+				r *= values[(i+2) % n];
+				tmp *= values[(i+3) % n];
+				r -= tmp;
+				doNotOptimize(r);
+			});
+		}
+	}
+}
+
+///Coordinates of snapped points in the plane
+template<typename T_EXTENSION_TYPE>
+std::vector< CGAL::ExtendedInt64q<T_EXTENSION_TYPE> > snappedRationals(ProjectSN & proj, Inputs & inputs, int snapType, int significands) {
+	using FT = CGAL::ExtendedInt64q<T_EXTENSION_TYPE>;
+	std::vector<FT> result;
+	auto points = inputs.points(3, precisionFor(significands));
+	std::vector<mpq_class> out(3);
+	for(const auto & p : points) {
+		proj.snap(p.begin(), p.end(), out.begin(), snapType | ProjectSN::ST_PLANE, significands);
+		for(const mpq_class & v : out) {
+			result.emplace_back(Conversion<FT>::moveFrom(v));
+		}
+	}
+	return result;
+}
+
+///Representation of the ExtendedInt64q arithmetic results of each case
+class TierReport {
+public:
+	bool run(Runner & runner, CGAL::ExtendedInt64Stats::Kind kind, const std::string & name, const std::string & variant, int dimension, int significands, const Runner::Operation & op) {
+		CGAL::ExtendedInt64Stats::reset();
+		if (!runner.run(name, variant, dimension, significands, 0, op)) {
+			return false;
+		}
+		m_cases.emplace_back(runner.results().back().key(), CGAL::ExtendedInt64Stats::get(kind));
+		return true;
+	}
+	void print(std::ostream & out) const {
+		if (m_cases.empty()) {
+			return;
+		}
+		if (!CGAL::ExtendedInt64Stats::enabled) {
+			out << "\nNo tier hit rates: libratss was built without LIBRATSS_WITH_EI64_STATS\n";
+			return;
+		}
+		std::size_t keyWidth = 0;
+		for(const auto & c : m_cases) {
+			keyWidth = std::max(keyWidth, c.first.size());
+		}
+		out << '\n' << std::left << std::setw(keyWidth) << "tier hit rates" << std::right
+			<< std::setw(10) << "int64" << std::setw(10) << "int128" << std::setw(10) << "extended" << '\n';
+		out << std::fixed << std::setprecision(3);
+		for(const auto & c : m_cases) {
+			out << std::left << std::setw(keyWidth) << c.first << std::right;
+			for(int tier(0); tier < CGAL::ExtendedInt64Stats::T_NUM_TIERS; ++tier) {
+				out << std::setw(10) << c.second.tierHitRate(CGAL::ExtendedInt64Stats::Tier(tier));
+			}
+			out << '\n';
+		}
+	}
+private:
+	std::vector< std::pair<std::string, CGAL::ExtendedInt64Stats::Counters> > m_cases;
+};
+
+template<typename T_EXTENSION_TYPE>
+void benchExtendedInt64q(Runner & runner, const std::string & prefix, int e, TierReport & tiers) {
+	using ExtendedInt64q = CGAL::ExtendedInt64q<T_EXTENSION_TYPE>;
+	constexpr CGAL::ExtendedInt64Stats::Kind kind = ExtendedInt64q::config_traits::stats_kind;
+	ProjectSN proj;
+	Inputs inputs;
+	std::vector<int> snapTypes = {ProjectSN::ST_FX, ProjectSN::ST_CF};
+	for(int st : snapTypes) {
+		std::vector<ExtendedInt64q> values = snappedRationals<T_EXTENSION_TYPE>(proj, inputs, st, e);
+		std::size_t n = values.size();
+		std::string variant = ProjectSN::toString((ProjectSN::SnapType) st);
+		tiers.run(runner, kind, prefix + "::operator+=", variant, 1, e, [&](std::size_t i) {
+			ExtendedInt64q r(values[i % n]);
+			r += values[(i+1) % n];
+			doNotOptimize(r);
+		});
+		tiers.run(runner, kind, prefix + "::operator*=", variant, 1, e, [&](std::size_t i) {
+			ExtendedInt64q r(values[i % n]);
+			r *= values[(i+1) % n];
+			doNotOptimize(r);
+		});
+		tiers.run(runner, kind, prefix + "::operator/=", variant, 1, e, [&](std::size_t i) {
+			ExtendedInt64q r(values[i % n]);
+			r /= values[(i+1) % n];
+			doNotOptimize(r);
+		});
+		//2x2 determinant of point differences as in orientation predicates
+		tiers.run(runner, kind, prefix + "::orientation", variant, 2, e, [&](std::size_t i) {
+			ExtendedInt64q r(values[i % n] - values[(i+2) % n]);
+			r *= values[(i+3) % n] - values[(i+5) % n];
+			ExtendedInt64q tmp(values[(i+1) % n] - values[(i+2) % n]);
+			tmp *= values[(i+4) % n] - values[(i+5) % n];
+			r -= tmp;
+			doNotOptimize(r);
+		});
+	}
+}
+
+///The fixed width extension types only hold the coordinates of points with few significands
+void benchExtendedInt64q(Runner & runner, const Config & cfg, TierReport & tiers) {
+	for(int e : cfg.significands) {
+		benchExtendedInt64q<CGAL::Gmpq>(runner, "ExtendedInt64q", e, tiers);
+#ifdef LIB_RATSS_WITH_FIXED_RATIONAL
+		switch (CGAL::fixedRationalBits(e)) {
+		case 256:
+			benchExtendedInt64q< CGAL::FixedRational<256> >(runner, "ExtendedInt64q<FixedRational<256>>", e, tiers);
+			break;
+		case 512:
+			benchExtendedInt64q< CGAL::FixedRational<512> >(runner, "ExtendedInt64q<FixedRational<512>>", e, tiers);
+			break;
+		case 1024:
+			benchExtendedInt64q< CGAL::FixedRational<1024> >(runner, "ExtendedInt64q<FixedRational<1024>>", e, tiers);
+			break;
+		default:
+			break;
+		}
+#endif
+	}
+}
+
+///number of points of the benchmarked triangulations
+constexpr std::size_t NUM_DELAUNAY_POINTS = 1000;
+
+///Snapped points of the upper hemisphere, projected to the xy-plane
+template<typename T_KERNEL>
+std::vector<typename T_KERNEL::Point_2> planePoints(const std::vector< std::vector<mpq_class> > & snapped) {
+	using FT = typename T_KERNEL::FT;
+	std::vector<typename T_KERNEL::Point_2> result;
+	for(const auto & p : snapped) {
+		if (p[2] >= 0) {
+			result.emplace_back(Conversion<FT>::moveFrom(p[0]), Conversion<FT>::moveFrom(p[1]));
+		}
+	}
+	return result;
+}
+
+template<typename T_KERNEL>
+void benchDelaunay(Runner & runner, const std::string & variant, int significands, const std::vector< std::vector<mpq_class> > & snapped) {
+	std::vector<typename T_KERNEL::Point_2> points = planePoints<T_KERNEL>(snapped);
+	runner.run("Delaunay_triangulation_2::insert", variant, 2, significands, 0, [&](std::size_t) {
+		CGAL::Delaunay_triangulation_2<T_KERNEL> dt(points.begin(), points.end());
+		doNotOptimize(dt);
+	});
+}
+
+///Delaunay triangulations of snapped points, the exact kernels overflow into the extension types all the time
+void benchDelaunay(Runner & runner, const Config & cfg) {
+	ProjectSN proj;
+	Inputs inputs;
+	for(int e : cfg.significands) {
+		std::vector< std::vector<mpq_class> > snapped;
+		for(const auto & p : inputs.points(3, precisionFor(e), NUM_DELAUNAY_POINTS)) {
+			snapped.emplace_back(3);
+			proj.snap(p.begin(), p.end(), snapped.back().begin(), ProjectSN::ST_FX | ProjectSN::ST_PLANE, e);
+		}
+		benchDelaunay<CGAL::Epeceik>(runner, "Epeceik", e, snapped);
+		benchDelaunay<CGAL::Simple_cartesian_extended_integer_kernel>(runner, "Simple_cartesian_extended_integer_kernel", e, snapped);
+		if (CGAL::fixedRationalBits(e) == 1024) {
+			benchDelaunay<CGAL::Simple_cartesian_extended_1024_integer_kernel>(runner, "Simple_cartesian_extended_1024_integer_kernel", e, snapped);
+		}
+#ifdef LIB_RATSS_WITH_FIXED_RATIONAL
+		switch (CGAL::fixedRationalBits(e)) {
+		case 256:
+			benchDelaunay<CGAL::Simple_cartesian_extended_fixed_256_integer_kernel>(runner, "Simple_cartesian_extended_fixed_256_integer_kernel", e, snapped);
+			break;
+		case 512:
+			benchDelaunay<CGAL::Simple_cartesian_extended_fixed_512_integer_kernel>(runner, "Simple_cartesian_extended_fixed_512_integer_kernel", e, snapped);
+			break;
+		case 1024:
+			benchDelaunay<CGAL::Simple_cartesian_extended_fixed_1024_integer_kernel>(runner, "Simple_cartesian_extended_fixed_1024_integer_kernel", e, snapped);
+			break;
+		default:
+			break;
+		}
+#endif
+		benchDelaunay<CGAL::Epeck>(runner, "Epeck", e, snapped);
+	}
+}
+#endif
+
+int main(int argc, char ** argv) {
+	AllocationCounter::install();
+	Config cfg;
+	int ret = cfg.parse(argc, argv);
+	if (ret <= 0) {
+		return ret;
+	}
+	if (cfg.limbPool) {
+#ifdef LIB_RATSS_WITH_CGAL
+		CGAL::GmpLimbPool::install();
+#else
+		std::cerr << "The gmp limb pool needs CGAL support" << std::endl;
+		return -1;
+#endif
+	}
+
+	Runner runner(cfg.opts);
+	benchConversion(runner, cfg);
+	benchCalc(runner, cfg);
+	benchSnap(runner, cfg);
+	benchBatch(runner, cfg);
+	benchGeoCalc(runner, cfg);
+	benchSpherePredicates(runner, cfg);
+	benchParsers(runner, cfg);
+#ifdef LIB_RATSS_WITH_CGAL
+	benchExtendedInt64(runner, cfg);
+	TierReport tiers;
+	benchExtendedInt64q(runner, cfg, tiers);
+	benchDelaunay(runner, cfg);
+#endif
+
+	if (cfg.table) {
+		runner.printTable(std::cout);
+#ifdef LIB_RATSS_WITH_CGAL
+		tiers.print(std::cout);
+#endif
+	}
+	if (cfg.jsonFileName == "-") {
+		runner.writeJson(std::cout);
+	}
+	else if (cfg.jsonFileName.size()) {
+		std::ofstream out(cfg.jsonFileName);
+		if (!out.is_open()) {
+			std::cerr << "Could not open " << cfg.jsonFileName << std::endl;
+			return -1;
+		}
+		runner.writeJson(out);
+	}
+	return 0;
+}
@@ -0,0 +1,420 @@
+#include "microbench.h"
+
+#include <gmp.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::size_t g_allocations = 0;
+std::size_t g_bytes = 0;
+
+void * countedMalloc(std::size_t size) {
+	++g_allocations;
+	g_bytes += size;
+	void * p = std::malloc(size ? size : 1);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void * gmpAlloc(std::size_t size) {
+	return countedMalloc(size);
+}
+
+void * gmpRealloc(void * ptr, std::size_t /*oldSize*/, std::size_t newSize) {
+	++g_allocations;
+	g_bytes += newSize;
+	void * p = std::realloc(ptr, newSize);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void gmpFree(void * ptr, std::size_t /*size*/) {
+	std::free(ptr);
+}
+
+} //end namespace
+
+void * operator new(std::size_t size) {
+	return countedMalloc(size);
+}
+
+void * operator new[](std::size_t size) {
+	return countedMalloc(size);
+}
+
+void operator delete(void * ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+namespace LIB_RATSS_NAMESPACE {
+namespace bench {
+
+//BEGIN AllocationCounter
+
+void AllocationCounter::install() {
+	mp_set_memory_functions(&gmpAlloc, &gmpRealloc, &gmpFree);
+}
+
+std::size_t AllocationCounter::allocations() {
+	return g_allocations;
+}
+
+std::size_t AllocationCounter::bytes() {
+	return g_bytes;
+}
+
+//END AllocationCounter
+//BEGIN Result
+
+Result::Result() :
+dimension(0),
+significands(0),
+precision(0),
+iterations(0),
+allocsPerOp(0),
+bytesPerOp(0)
+{}
+
+double Result::median() const {
+	if (!samples.size()) {
+		return 0;
+	}
+	std::vector<double> tmp(samples);
+	std::sort(tmp.begin(), tmp.end());
+	std::size_t s = tmp.size();
+	return (s % 2 ? tmp[s/2] : (tmp[s/2-1]+tmp[s/2])/2);
+}
+
+double Result::min() const {
+	return samples.size() ? *std::min_element(samples.begin(), samples.end()) : 0;
+}
+
+double Result::max() const {
+	return samples.size() ? *std::max_element(samples.begin(), samples.end()) : 0;
+}
+
+std::string Result::key() const {
+	std::stringstream ss;
+	ss << name << '/' << variant << "/d=" << dimension << "/e=" << significands << "/p=" << precision;
+	return ss.str();
+}
+
+//END Result
+//BEGIN Runner
+
+Runner::Options::Options() :
+minTime(100),
+repetitions(5),
+verbose(false)
+{}
+
+Runner::Runner(const Options & options) :
+m_opts(options)
+{}
+
+double Runner::measure(const Operation & op, std::size_t iterations) const {
+	using clock = std::chrono::steady_clock;
+	auto begin = clock::now();
+	for(std::size_t i(0); i < iterations; ++i) {
+		op(i);
+	}
+	auto end = clock::now();
+	return std::chrono::duration<double, std::nano>(end-begin).count();
+}
+
+bool Runner::run(const std::string & name, const std::string & variant, int dimension, int significands, int precision, const Operation & op) {
+	Result r;
+	r.name = name;
+	r.variant = variant;
+	r.dimension = dimension;
+	r.significands = significands;
+	r.precision = precision;
+
+	if (m_opts.filter.size() && r.key().find(m_opts.filter) == std::string::npos) {
+		return false;
+	}
+
+	try {
+		op(0);
+	}
+	catch (const std::exception & e) {
+		if (m_opts.verbose) {
+			std::cerr << "Skipping " << r.key() << ": " << e.what() << std::endl;
+		}
+		return false;
+	}
+
+	//calibrate the number of iterations such that a repetition takes at least minTime
+	const double minTimeNs = m_opts.minTime*1000*1000;
+	std::size_t iterations = 1;
+	while (true) {
+		double t = measure(op, iterations);
+		if (t >= minTimeNs/10 || iterations >= (std::size_t(1) << 30)) {
+			iterations = std::max<std::size_t>(1, std::size_t(double(iterations) * (minTimeNs / std::max(t, 1.0))));
+			break;
+		}
+		iterations *= 10;
+	}
+	r.iterations = iterations;
+
+	for(int rep(0); rep < m_opts.repetitions; ++rep) {
+		std::size_t allocs = AllocationCounter::allocations();
+		std::size_t bytes = AllocationCounter::bytes();
+		double t = measure(op, iterations);
+		if (rep == 0) {
+			r.allocsPerOp = double(AllocationCounter::allocations() - allocs) / iterations;
+			r.bytesPerOp = double(AllocationCounter::bytes() - bytes) / iterations;
+		}
+		r.samples.push_back(t / iterations);
+	}
+	if (m_opts.verbose) {
+		std::cerr << r.key() << ": " << r.median() << " ns/op" << std::endl;
+	}
+	m_results.push_back(std::move(r));
+	return true;
+}
+
+const std::vector<Result> & Runner::results() const {
+	return m_results;
+}
+
+void Runner::printTable(std::ostream & out) const {
+	std::size_t keyWidth = 0;
+	for(const Result & r : m_results) {
+		keyWidth = std::max(keyWidth, r.key().size());
+	}
+	out << std::left << std::setw(keyWidth) << "benchmark" << std::right
+		<< std::setw(14) << "ns/op"
+		<< std::setw(14) << "min"
+		<< std::setw(14) << "max"
+		<< std::setw(12) << "allocs/op"
+		<< std::setw(12) << "bytes/op" << '\n';
+	out << std::fixed << std::setprecision(1);
+	for(const Result & r : m_results) {
+		out << std::left << std::setw(keyWidth) << r.key() << std::right
+			<< std::setw(14) << r.median()
+			<< std::setw(14) << r.min()
+			<< std::setw(14) << r.max()
+			<< std::setw(12) << r.allocsPerOp
+			<< std::setw(12) << r.bytesPerOp << '\n';
+	}
+	out << std::defaultfloat << std::flush;
+}
+
+void Runner::writeJson(std::ostream & out) const {
+	out << "{\n\t\"min_time_ms\": " << m_opts.minTime << ",\n";
+	out << "\t\"repetitions\": " << m_opts.repetitions << ",\n";
+	out << "\t\"benchmarks\": [";
+	for(std::size_t i(0); i < m_results.size(); ++i) {
+		const Result & r = m_results[i];
+		out << (i ? ",\n" : "\n");
+		out << "\t\t{"
+			<< "\"key\": \"" << r.key() << "\", "
+			<< "\"name\": \"" << r.name << "\", "
+			<< "\"variant\": \"" << r.variant << "\", "
+			<< "\"dimension\": " << r.dimension << ", "
+			<< "\"significands\": " << r.significands << ", "
+			<< "\"precision\": " << r.precision << ", "
+			<< "\"iterations\": " << r.iterations << ", "
+			<< "\"ns_per_op\": " << r.median() << ", "
+			<< "\"allocs_per_op\": " << r.allocsPerOp << ", "
+			<< "\"bytes_per_op\": " << r.bytesPerOp << ", "
+			<< "\"samples\": [";
+		for(std::size_t j(0); j < r.samples.size(); ++j) {
+			out << (j ? ", " : "") << r.samples[j];
+		}
+		out << "]}";
+	}
+	out << "\n\t]\n}" << std::endl;
+}
+
+//END Runner
+//BEGIN json
+
+namespace {
+
+class JsonReader {
+public:
+	explicit JsonReader(const std::string & data) : m_data(data), m_pos(0) {}
+	void skipWs() {
+		while (m_pos < m_data.size() && std::isspace((unsigned char) m_data[m_pos])) {
+			++m_pos;
+		}
+	}
+	bool consume(char c) {
+		skipWs();
+		if (m_pos < m_data.size() && m_data[m_pos] == c) {
+			++m_pos;
+			return true;
+		}
+		return false;
+	}
+	void expect(char c) {
+		if (!consume(c)) {
+			throw std::runtime_error(std::string("ratss::bench::readJson: expected ") + c + " at position " + std::to_string(m_pos));
+		}
+	}
+	std::string string() {
+		expect('"');
+		std::size_t end = m_data.find('"', m_pos);
+		if (end == std::string::npos) {
+			throw std::runtime_error("ratss::bench::readJson: unterminated string");
+		}
+		std::string result = m_data.substr(m_pos, end-m_pos);
+		m_pos = end+1;
+		return result;
+	}
+	double number() {
+		skipWs();
+		const char * begin = m_data.c_str() + m_pos;
+		char * end = 0;
+		double result = std::strtod(begin, &end);
+		if (end == begin) {
+			throw std::runtime_error("ratss::bench::readJson: expected a number at position " + std::to_string(m_pos));
+		}
+		m_pos += end-begin;
+		return result;
+	}
+	std::vector<double> numbers() {
+		std::vector<double> result;
+		expect('[');
+		if (consume(']')) {
+			return result;
+		}
+		do {
+			result.push_back(number());
+		} while (consume(','));
+		expect(']');
+		return result;
+	}
+	Result result() {
+		Result r;
+		expect('{');
+		if (consume('}')) {
+			return r;
+		}
+		do {
+			std::string name = string();
+			expect(':');
+			if (name == "name") {
+				r.name = string();
+			}
+			else if (name == "variant") {
+				r.variant = string();
+			}
+			else if (name == "key") {
+				string();
+			}
+			else if (name == "samples") {
+				r.samples = numbers();
+			}
+			else {
+				double v = number();
+				if (name == "dimension") {
+					r.dimension = int(v);
+				}
+				else if (name == "significands") {
+					r.significands = int(v);
+				}
+				else if (name == "precision") {
+					r.precision = int(v);
+				}
+				else if (name == "iterations") {
+					r.iterations = std::size_t(v);
+				}
+				else if (name == "allocs_per_op") {
+					r.allocsPerOp = v;
+				}
+				else if (name == "bytes_per_op") {
+					r.bytesPerOp = v;
+				}
+			}
+		} while (consume(','));
+		expect('}');
+		return r;
+	}
+	std::vector<Result> results() {
+		std::vector<Result> result;
+		std::size_t p = m_data.find("\"benchmarks\"");
+		if (p == std::string::npos) {
+			throw std::runtime_error("ratss::bench::readJson: no benchmarks found");
+		}
+		m_pos = p;
+		string();
+		expect(':');
+		expect('[');
+		if (consume(']')) {
+			return result;
+		}
+		do {
+			result.push_back(this->result());
+		} while (consume(','));
+		expect(']');
+		return result;
+	}
+private:
+	const std::string & m_data;
+	std::size_t m_pos;
+};
+
+} //end namespace
+
+std::vector<Result> readJson(std::istream & in) {
+	std::stringstream ss;
+	ss << in.rdbuf();
+	std::string data = ss.str();
+	return JsonReader(data).results();
+}
+
+//END json
+
+std::pair<double, double> medianConfidenceInterval(const std::vector<double> & samples, double confidence) {
+	if (!samples.size()) {
+		return std::pair<double, double>(0, 0);
+	}
+	std::vector<double> tmp(samples);
+	std::sort(tmp.begin(), tmp.end());
+	const std::size_t n = tmp.size();
+	//the number of samples below the median is X ~ binomial(n, 1/2)
+	//[x_k, x_(n-k-1)] (0-based) covers the median with probability 1-2*P(X <= k)
+	//find the largest such k with P(X <= k) <= (1-confidence)/2
+	const double alpha = (1-confidence)/2;
+	double p = std::pow(0.5, double(n)); //P(X = 0)
+	double cdf = p;
+	std::size_t k = 0;
+	while (k+1 < n/2) {
+		p = p * double(n-k) / double(k+1);
+		if (cdf + p > alpha) {
+			break;
+		}
+		cdf += p;
+		++k;
+	}
+	return std::pair<double, double>(tmp.at(k), tmp.at(n-k-1));
+}
+
+
+}} //end namespace LIB_RATSS_NAMESPACE::bench
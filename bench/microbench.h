@@ -0,0 +1,96 @@
+#ifndef LIB_RATSS_BENCH_MICRO_BENCH_H
+#define LIB_RATSS_BENCH_MICRO_BENCH_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace bench {
+
+///Counts allocations done by operator new and by gmp/mpfr.
+///install() has to be called before the first gmp number is created.
+class AllocationCounter {
+public:
+	static void install();
+	static std::size_t allocations();
+	static std::size_t bytes();
+};
+
+///Keeps the compiler from optimizing away the computation of v
+template<typename T>
+inline void doNotOptimize(const T & v) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r"(&v) : "memory");
+#else
+	static volatile const void * sink;
+	sink = &v;
+#endif
+}
+
+struct Result {
+	std::string name;
+	std::string variant;
+	int dimension;
+	int significands;
+	int precision;
+	///iterations of each repetition
+	std::size_t iterations;
+	///ns/op of each repetition
+	std::vector<double> samples;
+	double allocsPerOp;
+	double bytesPerOp;
+	Result();
+	double median() const;
+	double min() const;
+	double max() const;
+	///unique identifier of a benchmark case, used to match results of different runs
+	std::string key() const;
+};
+
+class Runner {
+public:
+	struct Options {
+		///minimal time of a single repetition in milliseconds
+		double minTime;
+		int repetitions;
+		///only cases whose key contains filter are run
+		std::string filter;
+		bool verbose;
+		Options();
+	};
+	///Called for every iteration with the iteration number
+	using Operation = std::function<void(std::size_t)>;
+public:
+	explicit Runner(const Options & options);
+	///Runs op, op is called once beforehand, cases throwing during this call are skipped
+	///@return false if the case was skipped
+	bool run(const std::string & name, const std::string & variant, int dimension, int significands, int precision, const Operation & op);
+	const std::vector<Result> & results() const;
+	void printTable(std::ostream & out) const;
+	void writeJson(std::ostream & out) const;
+private:
+	double measure(const Operation & op, std::size_t iterations) const;
+private:
+	Options m_opts;
+	std::vector<Result> m_results;
+};
+
+///Reads results written by Runner::writeJson
+std::vector<Result> readJson(std::istream & in);
+
+///Distribution free confidence interval of the median of samples
+///@return the bounds of the interval, or min/max if there are too few samples for the requested confidence
+std::pair<double, double> medianConfidenceInterval(const std::vector<double> & samples, double confidence = 0.95);
+
+}} //end namespace LIB_RATSS_NAMESPACE::bench
+
+#endif
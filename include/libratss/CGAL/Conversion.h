@@ -11,6 +11,9 @@
 #include <CGAL/Gmpq.h>
 #include <CGAL/Lazy_exact_nt.h>
 #include <libratss/CGAL/ExtendedInt64q.h>
+#ifdef LIB_RATSS_WITH_FIXED_RATIONAL
+#include <libratss/CGAL/FixedRational.h>
+#endif
 #include <gmpxx.h>
 
 namespace LIB_RATSS_NAMESPACE {
@@ -44,10 +47,45 @@ struct Conversion<
 	static mpfr::mpreal toMpreal(const type & v, int precision);
 };
 
+#ifdef LIB_RATSS_WITH_FIXED_RATIONAL
+//the FixedRational specializations are instantiated for 256, 512 and 1024 bits
+
+template<int T_BITS>
+struct Conversion< CGAL::FixedRational<T_BITS> > {
+	using type = CGAL::FixedRational<T_BITS>;
+	static type moveFrom(const mpq_class & v);
+	static mpq_class toMpq(const type & v);
+	static mpfr::mpreal toMpreal(const type & v, int precision);
+};
+
+template<int T_BITS>
+struct Conversion< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > > {
+	using type = CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> >;
+	static type moveFrom(const mpq_class & v);
+	static mpq_class toMpq(const type & v);
+	static mpfr::mpreal toMpreal(const type & v, int precision);
+};
+
+template<int T_BITS>
+struct Conversion<
+	CGAL::Lazy_exact_nt<
+		CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> >
+	>
+>
+{
+	using type = CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > >;
+	static type moveFrom(const mpq_class & v);
+	static mpq_class toMpq(const type & v);
+	static mpfr::mpreal toMpreal(const type & v, int precision);
+};
+#endif
+
 template<>
 struct Conversion< CGAL::ExtendedInt64q<CGAL::Gmpq> > {
 	using type = CGAL::ExtendedInt64q<CGAL::Gmpq>;
 	static type moveFrom(const mpq_class & v);
+	///stays inline if v fits, otherwise the limbs of v are moved into the result
+	static type moveFrom(mpq_class && v);
 	static mpq_class toMpq(const type & v);
 	static mpfr::mpreal toMpreal(const type & v, int precision);
 };
@@ -61,6 +99,7 @@ struct Conversion<
 {
 	using type = CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q<CGAL::Gmpq> >;
 	static type moveFrom(const mpq_class & v);
+	static type moveFrom(mpq_class && v);
 	static mpq_class toMpq(const type & v);
 	static mpfr::mpreal toMpreal(const type & v, int precision);
 };
@@ -69,6 +108,8 @@ template<>
 struct Conversion<CGAL::Gmpq> {
 	using type = CGAL::Gmpq;
 	static type moveFrom(const mpq_class & v);
+	///moves the limbs of v into the result
+	static type moveFrom(mpq_class && v);
 	static mpq_class toMpq(const type & v);
 	static mpfr::mpreal toMpreal(const type & v, int precision);
 };
@@ -77,6 +118,7 @@ template<>
 struct Conversion< CGAL::Lazy_exact_nt<CGAL::Gmpq> > {
 	using type = CGAL::Lazy_exact_nt<CGAL::Gmpq>;
 	static type moveFrom(const mpq_class & v);
+	static type moveFrom(mpq_class && v);
 	static mpq_class toMpq(const type & v);
 	static mpfr::mpreal toMpreal(const type & v, int precision);
 };
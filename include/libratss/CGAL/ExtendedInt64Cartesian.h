@@ -36,6 +36,9 @@
 #include <CGAL/Triangulation_structural_filtering_traits.h>
 
 #include <libratss/CGAL/ExtendedInt64_arithemtic_kernel.h>
+#ifdef LIB_RATSS_WITH_FIXED_RATIONAL
+#include <libratss/CGAL/FixedRational.h>
+#endif
 
 #ifndef CGAL_DONT_USE_LAZY_KERNEL
 #  include <CGAL/Lazy_kernel.h>
@@ -45,6 +48,12 @@ namespace CGAL {
 
 typedef ExtendedInt64q<CGAL::Gmpq> Epeceik_ft;
 typedef ExtendedInt64q<internal::boost_int1024q> Epecei1024k_ft;
+#ifdef LIB_RATSS_WITH_FIXED_RATIONAL
+///Use fixedRationalBits(significands) to choose the width for snapped points
+typedef ExtendedInt64q< FixedRational<256> > Epecei256fk_ft;
+typedef ExtendedInt64q< FixedRational<512> > Epecei512fk_ft;
+typedef ExtendedInt64q< FixedRational<1024> > Epecei1024fk_ft;
+#endif
 
 // The following are redefined kernels instead of simple typedefs in order to shorten
 // template name length (for error messages, mangling...).
@@ -99,6 +108,14 @@ typedef Filtered_kernel< Simple_cartesian< Lazy_exact_nt<Epeceik_ft> > > Filtere
 typedef Simple_cartesian<Epecei1024k_ft> Simple_cartesian_extended_1024_integer_kernel;
 typedef Filtered_kernel< Simple_cartesian<Epecei1024k_ft> > Filtered_simple_cartesian_extended_1024_integer_kernel;
 typedef Filtered_kernel< Simple_cartesian< Lazy_exact_nt<Epecei1024k_ft> > > Filtered_lazy_cartesian_extended_1024_integer_kernel;
+#ifdef LIB_RATSS_WITH_FIXED_RATIONAL
+typedef Simple_cartesian<Epecei256fk_ft> Simple_cartesian_extended_fixed_256_integer_kernel;
+typedef Simple_cartesian<Epecei512fk_ft> Simple_cartesian_extended_fixed_512_integer_kernel;
+typedef Simple_cartesian<Epecei1024fk_ft> Simple_cartesian_extended_fixed_1024_integer_kernel;
+typedef Filtered_kernel< Simple_cartesian<Epecei256fk_ft> > Filtered_simple_cartesian_extended_fixed_256_integer_kernel;
+typedef Filtered_kernel< Simple_cartesian<Epecei512fk_ft> > Filtered_simple_cartesian_extended_fixed_512_integer_kernel;
+typedef Filtered_kernel< Simple_cartesian<Epecei1024fk_ft> > Filtered_simple_cartesian_extended_fixed_1024_integer_kernel;
+#endif
 
 template <>
 struct Triangulation_structural_filtering_traits<Epeceik> {
@@ -0,0 +1,135 @@
+#ifndef LIBRATSS_CGAL_EXTENDED_INT64_POOL_H
+#define LIBRATSS_CGAL_EXTENDED_INT64_POOL_H
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace CGAL {
+
+///Thread local free lists for the limb buffers of gmp, one list per buffer size in limbs.
+///CGAL::Gmpz and CGAL::Gmpq are reference counted handles, recycling them does not recycle their limbs.
+///Their limbs are pooled below them instead, by routing the memory functions of gmp through the pool.
+///There is no global lock, buffers may be freed by another thread than the one that allocated them.
+class GmpLimbPool final {
+public:
+	///largest pooled buffer in limbs
+	static constexpr std::size_t MAX_LIMBS = 32;
+	///maximum number of free buffers kept per thread and size
+	static constexpr std::size_t MAX_FREE = 64;
+public:
+	///Routes the memory functions of gmp (and hence mpfr) through the pool.
+	///The previous memory functions serve the pool and all buffers that are not pooled.
+	///Buffers allocated before are fine since only buffers of the exact same size are handed out again.
+	///Not thread-safe: call it at program start before other threads use gmp. Later calls do nothing.
+	static void install();
+	static bool installed();
+private:
+	static void * allocate(std::size_t size);
+	static void * reallocate(void * ptr, std::size_t oldSize, std::size_t newSize);
+	static void deallocate(void * ptr, std::size_t size);
+};
+
+namespace internal {
+
+///Thread local free list for the extension objects of ExtendedInt64z and ExtendedInt64q.
+///There is one list per extension type, hence per size class, and no global lock.
+///Released objects stay constructed, so assigning the next value reuses their storage.
+///This recycles boost_int1024q and FixedRational objects completely, the limbs of Gmpz and Gmpq are left to GmpLimbPool.
+///Objects may be released by another thread than the one that created them.
+template<typename T>
+class ExtendedInt64Pool {
+public:
+	///maximum number of free objects kept per thread
+	static constexpr std::size_t MAX_FREE = 256;
+public:
+	inline static T * create(const T & v);
+	inline static T * create(T && v);
+	inline static void release(T * v);
+private:
+	struct FreeList {
+		std::vector<T*> objects;
+		FreeList();
+		~FreeList();
+	};
+	///@return 0 if the list of this thread was already destroyed
+	inline static FreeList * freeList();
+private:
+	static thread_local bool m_destroyed;
+};
+
+}} //end namespace CGAL::internal
+
+//definitions
+
+namespace CGAL {
+namespace internal {
+
+template<typename T>
+constexpr std::size_t ExtendedInt64Pool<T>::MAX_FREE;
+
+template<typename T>
+thread_local bool ExtendedInt64Pool<T>::m_destroyed = false;
+
+template<typename T>
+ExtendedInt64Pool<T>::FreeList::FreeList() {
+	objects.reserve(MAX_FREE);
+}
+
+template<typename T>
+ExtendedInt64Pool<T>::FreeList::~FreeList() {
+	m_destroyed = true;
+	for(T * v : objects) {
+		delete v;
+	}
+}
+
+template<typename T>
+typename ExtendedInt64Pool<T>::FreeList *
+ExtendedInt64Pool<T>::freeList() {
+	if (m_destroyed) {
+		return 0;
+	}
+	static thread_local FreeList fl;
+	return &fl;
+}
+
+template<typename T>
+T * ExtendedInt64Pool<T>::create(const T & v) {
+	FreeList * fl = freeList();
+	if (fl && fl->objects.size()) {
+		T * result = fl->objects.back();
+		fl->objects.pop_back();
+		*result = v;
+		return result;
+	}
+	return new T(v);
+}
+
+template<typename T>
+T * ExtendedInt64Pool<T>::create(T && v) {
+	FreeList * fl = freeList();
+	if (fl && fl->objects.size()) {
+		T * result = fl->objects.back();
+		fl->objects.pop_back();
+		*result = std::move(v);
+		return result;
+	}
+	return new T(std::move(v));
+}
+
+template<typename T>
+void ExtendedInt64Pool<T>::release(T * v) {
+	FreeList * fl = freeList();
+	if (fl && fl->objects.size() < MAX_FREE) {
+		fl->objects.push_back(v);
+	}
+	else {
+		delete v;
+	}
+}
+
+}} //end namespace CGAL::internal
+
+#endif
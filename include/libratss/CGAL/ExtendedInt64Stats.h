@@ -0,0 +1,209 @@
+#ifndef LIBRATSS_CGAL_EXTENDED_INT64_STATS_H
+#define LIBRATSS_CGAL_EXTENDED_INT64_STATS_H
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+namespace CGAL {
+
+///Allocation statistics of ExtendedInt64z and ExtendedInt64q.
+///Every thread counts into its own block of counters which only this thread writes to.
+///get() sums up the blocks of all threads, including the ones that already exited.
+///Counting is compiled out unless LIB_RATSS_WITH_EI64_STATS is defined (cmake -DLIBRATSS_WITH_EI64_STATS=ON).
+class ExtendedInt64Stats {
+public:
+#ifdef LIB_RATSS_WITH_EI64_STATS
+	static constexpr bool enabled = true;
+#else
+	static constexpr bool enabled = false;
+#endif
+
+	enum Kind : int {
+		K_INTEGER=0, //ExtendedInt64z
+		K_RATIONAL=1, //ExtendedInt64q<CGAL::Gmpq>
+		K_RATIONAL_BOOST=2, //ExtendedInt64q<boost_int1024q>
+		K_RATIONAL_FIXED=3, //ExtendedInt64q<FixedRational<*>>
+		K_RATIONAL_OTHER=4,
+		K_NUM_KINDS=5
+	};
+	///representation of an ExtendedInt64q value
+	enum Tier : int {
+		T_INT64=0, //64 bit numerator and denominator
+		T_INT128=1, //128 bit numerator and denominator
+		T_EXTENDED=2, //heap allocated extension type
+		T_NUM_TIERS=3
+	};
+	///bucket i counts values with 64*i+1 to 64*(i+1) bits, the last bucket counts everything larger
+	static constexpr int NUM_BIT_BUCKETS = 17;
+	using Histogram = std::array<uint64_t, NUM_BIT_BUCKETS>;
+	using TierHistogram = std::array<uint64_t, T_NUM_TIERS>;
+	struct Counters {
+		///constructed and destroyed objects, ExtendedInt64z does not count these
+		uint64_t allocations;
+		uint64_t deallocations;
+		///heap allocated extension objects
+		uint64_t extendedAllocations;
+		uint64_t extendedDeallocations;
+		///arithmetic on machine words that overflowed into the extension type
+		uint64_t promotions;
+		///extended values that were switched back to machine words
+		uint64_t demotions;
+		uint32_t maxNumeratorBits;
+		uint32_t maxDenominatorBits;
+		///bit sizes of values stored in the extension type
+		Histogram numeratorBits;
+		Histogram denominatorBits;
+		///representation of the results of arithmetic operations
+		TierHistogram tierHits;
+		Counters();
+		Counters & operator+=(const Counters & other);
+		///objects alive at the moment, only meaningful for the sum of all threads
+		int64_t liveAllocations() const;
+		int64_t liveExtendedAllocations() const;
+		///fraction of arithmetic results with representation tier
+		double tierHitRate(Tier tier) const;
+		void print(std::ostream & out) const;
+	};
+public:
+	///sum of the counters of all threads
+	static Counters get(Kind kind);
+	///counters of the calling thread
+	static Counters local(Kind kind);
+	///Resets the counters of all threads.
+	///Counts of threads that use ExtendedInt64 types concurrently may be slightly off afterwards.
+	static void reset();
+	inline static int bucket(uint32_t bits);
+public:
+	inline static void onAllocation(Kind kind);
+	inline static void onDeallocation(Kind kind);
+	inline static void onExtendedAllocation(Kind kind);
+	inline static void onExtendedDeallocation(Kind kind);
+	inline static void onPromotion(Kind kind);
+	inline static void onDemotion(Kind kind);
+	inline static void onExtendedValue(Kind kind, uint32_t numeratorBits, uint32_t denominatorBits = 0);
+	inline static void onTierHit(Kind kind, Tier tier);
+public: //implementation details
+	struct BlockCounters {
+		std::atomic<uint64_t> allocations;
+		std::atomic<uint64_t> deallocations;
+		std::atomic<uint64_t> extendedAllocations;
+		std::atomic<uint64_t> extendedDeallocations;
+		std::atomic<uint64_t> promotions;
+		std::atomic<uint64_t> demotions;
+		std::atomic<uint32_t> maxNumeratorBits;
+		std::atomic<uint32_t> maxDenominatorBits;
+		std::array<std::atomic<uint64_t>, NUM_BIT_BUCKETS> numeratorBits;
+		std::array<std::atomic<uint64_t>, NUM_BIT_BUCKETS> denominatorBits;
+		std::array<std::atomic<uint64_t>, T_NUM_TIERS> tierHits;
+	};
+	struct alignas(64) Block {
+		std::array<BlockCounters, K_NUM_KINDS> counters;
+		Block();
+		Counters get(Kind kind) const;
+		void set(Kind kind, const Counters & v);
+		void reset();
+	};
+private:
+	///Only the owning thread writes to its block, hence there is no need for an atomic increment.
+	///The atomics just make concurrent reads in get() well defined.
+	template<typename T>
+	inline static void inc(std::atomic<T> & v);
+	template<typename T>
+	inline static void max(std::atomic<T> & v, T value);
+	inline static BlockCounters & localBlock(Kind kind);
+	static Block & registerThread();
+private:
+	struct ThreadBlock;
+	static thread_local Block * m_local;
+};
+
+}//end namespace CGAL
+
+//definitions
+
+namespace CGAL {
+
+template<typename T>
+void ExtendedInt64Stats::inc(std::atomic<T> & v) {
+	v.store(v.load(std::memory_order_relaxed)+1, std::memory_order_relaxed);
+}
+
+template<typename T>
+void ExtendedInt64Stats::max(std::atomic<T> & v, T value) {
+	if (v.load(std::memory_order_relaxed) < value) {
+		v.store(value, std::memory_order_relaxed);
+	}
+}
+
+int ExtendedInt64Stats::bucket(uint32_t bits) {
+	return (bits ? std::min<int>((bits-1)/64, NUM_BIT_BUCKETS-1) : 0);
+}
+
+ExtendedInt64Stats::BlockCounters & ExtendedInt64Stats::localBlock(Kind kind) {
+	Block * b = m_local;
+	if (!b) {
+		b = &registerThread();
+	}
+	return b->counters[kind];
+}
+
+#ifdef LIB_RATSS_WITH_EI64_STATS
+
+void ExtendedInt64Stats::onAllocation(Kind kind) {
+	inc(localBlock(kind).allocations);
+}
+
+void ExtendedInt64Stats::onDeallocation(Kind kind) {
+	inc(localBlock(kind).deallocations);
+}
+
+void ExtendedInt64Stats::onExtendedAllocation(Kind kind) {
+	inc(localBlock(kind).extendedAllocations);
+}
+
+void ExtendedInt64Stats::onExtendedDeallocation(Kind kind) {
+	inc(localBlock(kind).extendedDeallocations);
+}
+
+void ExtendedInt64Stats::onPromotion(Kind kind) {
+	inc(localBlock(kind).promotions);
+}
+
+void ExtendedInt64Stats::onDemotion(Kind kind) {
+	inc(localBlock(kind).demotions);
+}
+
+void ExtendedInt64Stats::onExtendedValue(Kind kind, uint32_t numeratorBits, uint32_t denominatorBits) {
+	BlockCounters & c = localBlock(kind);
+	inc(c.numeratorBits[bucket(numeratorBits)]);
+	max(c.maxNumeratorBits, numeratorBits);
+	if (denominatorBits) {
+		inc(c.denominatorBits[bucket(denominatorBits)]);
+		max(c.maxDenominatorBits, denominatorBits);
+	}
+}
+
+void ExtendedInt64Stats::onTierHit(Kind kind, Tier tier) {
+	inc(localBlock(kind).tierHits[tier]);
+}
+
+#else
+
+void ExtendedInt64Stats::onAllocation(Kind) {}
+void ExtendedInt64Stats::onDeallocation(Kind) {}
+void ExtendedInt64Stats::onExtendedAllocation(Kind) {}
+void ExtendedInt64Stats::onExtendedDeallocation(Kind) {}
+void ExtendedInt64Stats::onPromotion(Kind) {}
+void ExtendedInt64Stats::onDemotion(Kind) {}
+void ExtendedInt64Stats::onExtendedValue(Kind, uint32_t, uint32_t) {}
+void ExtendedInt64Stats::onTierHit(Kind, Tier) {}
+
+#endif
+
+}//end namespace CGAL
+
+#endif
@@ -67,9 +67,114 @@ namespace internal {
 		static CGAL::ExtendedInt64z::extension_type to_ei64z(const numerator_type & v);
 		static CGAL::ExtendedInt64z::extension_type to_ei64z(const denominator_type & v);
 		static uint32_t num_bits(const numerator_type &);
+		static uint32_t numerator_bits(const type & v);
+		static uint32_t denominator_bits(const type & v);
+		///@return false if the numerator or the denominator needs more than 127 bits
+		static bool to_int128(const type & v, int128 & numerator, int128 & denominator);
+		static constexpr ExtendedInt64Stats::Kind stats_kind = ExtendedInt64Stats::K_RATIONAL_OTHER;
 		static type make(CGAL::ExtendedInt64z::base_type numerator, CGAL::ExtendedInt64z::base_type denominator);
+		///numerator and denominator have to be canonical
+		static type make(int128 numerator, int128 denominator);
+		///a/b + c/d with canonical fractions, used if add128 overflows
+		static type add(int128 a, int128 b, int128 c, int128 d);
+		///(a*c)/(b*d) which has to be canonical, used if mul128 or div128 overflow
+		static type mul(int128 a, int128 b, int128 c, int128 d);
+		///a/b * c/d with canonical fractions that were not reduced by mul128, used if mul128_overflows
+		static type mul_unreduced(int128 a, int128 b, int128 c, int128 d);
 	};
 	
+	///binary gcd of two machine words
+	inline uint64_t gcd64(uint64_t u, uint64_t v) {
+		if (!u || !v) {
+			return u | v;
+		}
+		int shift = __builtin_ctzll(u | v);
+		u >>= __builtin_ctzll(u);
+		do {
+			v >>= __builtin_ctzll(v);
+			if (u > v) {
+				std::swap(u, v);
+			}
+			v -= u;
+		} while (v);
+		return u << shift;
+	}
+	
+	inline uint64_t abs64(int64_t v) {
+		return (v < 0 ? uint64_t(0) - uint64_t(v) : uint64_t(v));
+	}
+	
+#ifdef __SIZEOF_INT128__
+	using uint128 = unsigned __int128;
+#else
+	using uint128 = boost::multiprecision::uint128_t;
+#endif
+	
+	///two's complement high*2^64 + low
+	inline int128 join128(int64_t high, uint64_t low) {
+#ifdef __SIZEOF_INT128__
+		return int128((uint128(uint64_t(high)) << 64) | low);
+#else
+		return int128(high) * (int128(1) << 64) + int128(low);
+#endif
+	}
+	
+	inline void split128(int128 v, int64_t & high, uint64_t & low) {
+#ifdef __SIZEOF_INT128__
+		high = int64_t(v >> 64);
+		low = uint64_t(v);
+#else
+		int128 base = int128(1) << 64;
+		int128 h = v / base;
+		int128 l = v - h*base;
+		if (l < 0) {
+			l += base;
+			h -= 1;
+		}
+		high = static_cast<int64_t>(h);
+		low = static_cast<uint64_t>(l);
+#endif
+	}
+	
+	///true iff |v| < 2^127, these are the numerators of the 128 bit representation of ExtendedInt64q
+	inline bool fits127(int128 v) {
+#ifdef __SIZEOF_INT128__
+		return v != int128(uint128(1) << 127);
+#else
+		return v == 0 || boost::multiprecision::msb(boost::multiprecision::abs(v)) < 127;
+#endif
+	}
+	
+	inline uint128 abs128(int128 v) {
+#ifdef __SIZEOF_INT128__
+		return (v < 0 ? uint128(0) - uint128(v) : uint128(v));
+#else
+		return uint128(boost::multiprecision::abs(v));
+#endif
+	}
+	
+	uint128 gcd128(uint128 u, uint128 v);
+	
+	//Rational arithmetic on 128 bit numerators and positive denominators as in mpq_add, mpq_mul and mpq_div.
+	//Operands with |numerator| < 2^127 and canonical fractions result in canonical fractions.
+	//These return false if an intermediate result does not fit into 127 bits.
+	
+	///num/den = a/b + c/d
+	bool add128(int128 a, int128 b, int128 c, int128 d, int128 & num, int128 & den);
+	///num/den = a/b * c/d
+	///On overflow the arguments are reduced such that (a*c)/(b*d) is canonical.
+	bool mul128(int128 & a, int128 & b, int128 & c, int128 & d, int128 & num, int128 & den);
+	///num/den = (a/b) / (c/d), c must not be zero
+	///On overflow the arguments are changed like in mul128 such that (a*c)/(b*d) is the result.
+	bool div128(int128 & a, int128 & b, int128 & c, int128 & d, int128 & num, int128 & den);
+	///sets result to the sign of a*d - c*b
+	bool cmp128(int128 a, int128 b, int128 c, int128 d, int & result);
+	///Cheap test before mul128 whether a/b * c/d overflows anyway, in which case its gcds are wasted.
+	///The powers of two of the gcds are taken into account exactly, their odd parts are assumed to be below 2^MAX_ODD_GCD_BITS.
+	///A false positive only costs a detour through the extension type whose result is demoted again.
+	///There is no such test for div128: coordinates of snapped points share denominators, so gcd(b, d) is large all the time.
+	bool mul128_overflows(int128 a, int128 b, int128 c, int128 d);
+	
 	template<typename T_EXTENSION_TYPE>
 	struct Exact_field_selector< ExtendedInt64q<T_EXTENSION_TYPE> > {
 		typedef ExtendedInt64q<T_EXTENSION_TYPE> Type;
@@ -110,10 +215,18 @@ public:
 	struct PQ;
 	
 public:
-	static uint64_t number_of_extended_allocations;
-	static uint64_t number_of_allocations;
-	static uint32_t max_numerator_bits;
-	static uint32_t max_denominator_bits;
+	///allocation statistics summed up over all threads
+	static ExtendedInt64Stats::Counters stats();
+	///objects alive at the moment
+	[[deprecated("use stats().liveAllocations()")]]
+	static uint64_t number_of_allocations();
+	///extension objects alive at the moment
+	[[deprecated("use stats().liveExtendedAllocations()")]]
+	static uint64_t number_of_extended_allocations();
+	[[deprecated("use stats().maxNumeratorBits")]]
+	static uint32_t max_numerator_bits();
+	[[deprecated("use stats().maxDenominatorBits")]]
+	static uint32_t max_denominator_bits();
 public:
 	ExtendedInt64q();
 	ExtendedInt64q(const ExtendedInt64q & other);
@@ -171,10 +284,15 @@ public:
 	bool operator< (const ExtendedInt64q &q) const;
 
 	double to_double() const;
+	std::pair<double, double> to_interval() const;
 	Sign sign() const;
 
 	bool isExtended() const;
+	///true iff numerator and denominator are stored inline with 128 bits
+	bool isInt128() const;
+	ExtendedInt64Stats::Tier tier() const;
 	const extension_type & getExtended() const;
+	///only valid if the value is neither extended nor stored with 128 bits
 	const PQ & getPq() const;
 	extension_type asExtended() const;
 	
@@ -247,8 +365,6 @@ private:
 	static constexpr base_type btmin = std::numeric_limits<base_type>::min();
 	static constexpr base_type btmax = std::numeric_limits<base_type>::max();
 public:
-	//the denomintator also stores if ptr is used
-	//If den == 0, then ptr is set and valid
 	struct PQ {
 		PQ() : num(0), den(1) {}
 		PQ(base_type num, base_type den) : num(num), den(den) {}
@@ -256,32 +372,54 @@ public:
 		base_type den;
 	};
 private:
-	#ifdef __SIZEOF_INT128__
-	using int128 = __int128_t;
-	#else 
-	using int128 = internal::boost_int128;
-	#endif
+	using int128 = internal::int128;
+	///numerator and lower half of the denominator of the 128 bit representation
+	struct PQ128 {
+		uint64_t numLow;
+		base_type numHigh;
+		uint64_t denLow;
+	};
 	struct Ext {
-		Ext() : ptr(0) {}
 		extension_type * ptr;
-		char dummy[2*sizeof(base_type)-sizeof(extension_type*)];
 	};
-	union Storage {
-		Storage() : pq() {}
+	union Value {
+		Value() : pq() {}
 		PQ pq;
+		PQ128 pq128;
 		Ext ext;
 	};
-	static_assert(sizeof(extension_type*) <= sizeof(base_type), "extension_type* needs to be smaller or equal than base_type");
+	//The tag selects the representation.
+	//A non-negative tag is the upper half of the denominator of the 128 bit representation.
+	static constexpr base_type TAG_PQ = -1;
+	static constexpr base_type TAG_EXT = -2;
+	struct Storage {
+		Storage() : tag(TAG_PQ) {}
+		Value v;
+		base_type tag;
+	};
 private:
 	PQ & getPq();
 	extension_type & getExtended();
 	extension_type * ptr() const;
+	bool isPq() const;
+	///numerator and denominator of the 64 or 128 bit representation
+	int128 num128() const;
+	int128 den128() const;
 	void set(const PQ & pq);
 	void set(base_type num, base_type den);
+	///den has to be positive, picks the smallest representation that fits.
+	///num and den have to be canonical if they do not fit into 64 bits
+	void setFromInt128(int128 num, int128 den);
+	///|num| < 2^127 and den > 0
+	void set128(int128 num, int128 den);
 	void set(const extension_type & v);
 	void set(extension_type && v);
 	void set(extension_type * v);
+	///switch back to 64 or 128 bits if the extended value fits
+	void demote();
 	void deleteExt();
+	///interval containing v
+	static Interval_nt<> interval(int128 v);
 private:
 	Storage m_v;
 };
@@ -334,6 +472,9 @@ public:
 			if (x.isExtended()) {
 				return m_pe(x.getExtended());
 			}
+			else if (x.isInt128()) {
+				return m_pe(x.asExtended());
+			}
 			else {
 				return m_pb( BaseTypeQuotient(x.getPq().num, x.getPq().den) );
 			}
@@ -381,18 +522,8 @@ public:
 	class To_interval: public std::unary_function< Type, std::pair< double, double > > {
 	public:
 		std::pair<double, double> operator()(const Type & x ) const {
-			if (x.isExtended()) {
-				return m_p( x.getExtended() );
-			}
-			else {
-				Interval_nt<> quot =
-				Interval_nt<>(CGAL_NTS to_interval(x.getPq().num)) /
-				Interval_nt<>(CGAL_NTS to_interval(x.getPq().den));
-				return std::make_pair(quot.inf(), quot.sup());
-			}
+			return x.to_interval();
 		}
-	private:
-		typename RetExt::To_interval m_p;
 	};
 };
 
@@ -435,24 +566,40 @@ public:
 
 namespace CGAL {
 
-#define WITH_EI64_STATS
-#ifdef WITH_EI64_STATS
-	#define EI64_INC_NUM_E_ALLOC {++number_of_extended_allocations;}
-	#define EI64_DEC_NUM_E_ALLOC {--number_of_extended_allocations;}
-	#define EI64_INC_NUM_ALLOC {++number_of_allocations;}
-	#define EI64_DEC_NUM_ALLOC {--number_of_allocations;}
-	#define EI64_UPDATE_MAX_BITS(__x) {{ \
-		max_numerator_bits = std::max<uint32_t>(max_numerator_bits, config_traits::num_bits(config_traits::numerator(__x))); \
-		max_denominator_bits = std::max<uint32_t>(max_denominator_bits, config_traits::num_bits(config_traits::denominator( __x))); \
+#ifdef LIB_RATSS_WITH_EI64_STATS
+	#define EI64_INC_NUM_E_ALLOC {ExtendedInt64Stats::onExtendedAllocation(config_traits::stats_kind);}
+	#define EI64_DEC_NUM_E_ALLOC {ExtendedInt64Stats::onExtendedDeallocation(config_traits::stats_kind);}
+	#define EI64_INC_NUM_ALLOC {ExtendedInt64Stats::onAllocation(config_traits::stats_kind);}
+	#define EI64_DEC_NUM_ALLOC {ExtendedInt64Stats::onDeallocation(config_traits::stats_kind);}
+	#define EI64_INC_NUM_PROMOTIONS {ExtendedInt64Stats::onPromotion(config_traits::stats_kind);}
+	#define EI64_INC_NUM_DEMOTIONS {ExtendedInt64Stats::onDemotion(config_traits::stats_kind);}
+	#define EI64_UPDATE_BITS(__x) {{ \
+		ExtendedInt64Stats::onExtendedValue(config_traits::stats_kind, config_traits::numerator_bits(__x), config_traits::denominator_bits(__x)); \
 	}}
+	#define EI64_COUNT_TIER {ExtendedInt64Stats::onTierHit(config_traits::stats_kind, tier());}
 #else
 	#define EI64_INC_NUM_E_ALLOC
 	#define EI64_DEC_NUM_E_ALLOC
 	#define EI64_INC_NUM_ALLOC
 	#define EI64_DEC_NUM_ALLOC
-	#define EI64_UPDATE_MAX_BITS
+	#define EI64_INC_NUM_PROMOTIONS
+	#define EI64_INC_NUM_DEMOTIONS
+	#define EI64_UPDATE_BITS(__x)
+	#define EI64_COUNT_TIER
 #endif
 
+EI64PQ_TPL_PARAMS
+constexpr typename EI64PQ_CLS_NAME::base_type EI64PQ_CLS_NAME::btmin;
+
+EI64PQ_TPL_PARAMS
+constexpr typename EI64PQ_CLS_NAME::base_type EI64PQ_CLS_NAME::btmax;
+
+EI64PQ_TPL_PARAMS
+constexpr typename EI64PQ_CLS_NAME::base_type EI64PQ_CLS_NAME::TAG_PQ;
+
+EI64PQ_TPL_PARAMS
+constexpr typename EI64PQ_CLS_NAME::base_type EI64PQ_CLS_NAME::TAG_EXT;
+
 EI64PQ_TPL_PARAMS
 EI64PQ_CLS_NAME::ExtendedInt64q()
 {
@@ -468,7 +615,7 @@ EI64PQ_CLS_NAME::ExtendedInt64q(const ExtendedInt64q & other)
 		set(other.getExtended());
 	}
 	else {
-		set(other.getPq());
+		m_v = other.m_v;
 	}
 }
 
@@ -481,7 +628,7 @@ EI64PQ_CLS_NAME::ExtendedInt64q(ExtendedInt64q && other)
 		other.set((extension_type*)0);
 	}
 	else {
-		set(other.getPq());
+		m_v = other.m_v;
 	}
 }
 
@@ -490,6 +637,7 @@ EI64PQ_CLS_NAME::ExtendedInt64q(const PQ & q)
 {
 	EI64_INC_NUM_ALLOC
 	set(q);
+	canonicalize();
 }
 
 EI64PQ_TPL_PARAMS
@@ -562,6 +710,7 @@ EI64PQ_CLS_NAME::ExtendedInt64q(base_type n, base_type d)
 {
 	EI64_INC_NUM_ALLOC
 	set(n, d);
+	canonicalize();
 }
 
 EI64PQ_TPL_PARAMS
@@ -570,6 +719,7 @@ EI64PQ_CLS_NAME::ExtendedInt64q(base_type n, uint64_t d)
 	EI64_INC_NUM_ALLOC
 	if (d < uint64_t(btmax) ) {
 		set(base_type(n), base_type(d));
+		canonicalize();
 	}
 	else {
 		set(config_traits::make(n, d));
@@ -582,6 +732,7 @@ EI64PQ_CLS_NAME::ExtendedInt64q(uint64_t n, uint64_t d)
 	EI64_INC_NUM_ALLOC
 	if (n < uint64_t(btmax) && d < uint64_t(btmax) ) {
 		set(base_type(n), base_type(d));
+		canonicalize();
 	}
 	else {
 		set(config_traits::make(n, d));
@@ -603,6 +754,7 @@ EI64PQ_CLS_NAME::ExtendedInt64q(const ExtendedInt64z& n, const ExtendedInt64z& d
 	}
 	else {
 		set(n.get(), d.get());
+		canonicalize();
 	}
 }
 
@@ -643,7 +795,10 @@ EI64PQ_CLS_NAME::operator=(const ExtendedInt64q & other) {
 		set(other.getExtended());
 	}
 	else {
-		set(other.getPq());
+		if (isExtended()) {
+			deleteExt();
+		}
+		m_v = other.m_v;
 	}
 	return *this;
 }
@@ -651,24 +806,49 @@ EI64PQ_CLS_NAME::operator=(const ExtendedInt64q & other) {
 EI64PQ_TPL_PARAMS
 EI64PQ_CLS_NAME&
 EI64PQ_CLS_NAME::operator=(ExtendedInt64q && other) {
-	if (isExtended() && other.isExtended()) {
+	if (isExtended()) {
 		deleteExt();
-		set(other.ptr());
-		other.set((extension_type*)0);
-	}
-	else if (isExtended()) {
-		set(other.getPq());
 	}
-	else if (other.isExtended()) {
+	if (other.isExtended()) {
 		set(other.ptr());
 		other.set((extension_type*)0);
 	}
 	else {
-		set(other.getPq());
+		m_v = other.m_v;
 	}
 	return *this;
 }
 
+EI64PQ_TPL_PARAMS
+ExtendedInt64Stats::Counters
+EI64PQ_CLS_NAME::stats() {
+	return ExtendedInt64Stats::get(config_traits::stats_kind);
+}
+
+EI64PQ_TPL_PARAMS
+uint64_t
+EI64PQ_CLS_NAME::number_of_allocations() {
+	return stats().liveAllocations();
+}
+
+EI64PQ_TPL_PARAMS
+uint64_t
+EI64PQ_CLS_NAME::number_of_extended_allocations() {
+	return stats().liveExtendedAllocations();
+}
+
+EI64PQ_TPL_PARAMS
+uint32_t
+EI64PQ_CLS_NAME::max_numerator_bits() {
+	return stats().maxNumeratorBits;
+}
+
+EI64PQ_TPL_PARAMS
+uint32_t
+EI64PQ_CLS_NAME::max_denominator_bits() {
+	return stats().maxDenominatorBits;
+}
+
 EI64PQ_TPL_PARAMS
 std::size_t
 EI64PQ_CLS_NAME::size() const {
@@ -681,10 +861,19 @@ EI64PQ_CLS_NAME::canonicalize() {
 	if (isExtended()) {
 		config_traits::simplify(getExtended());
 	}
+	else if (isInt128()) {
+		int128 num = num128(), den = den128();
+		internal::uint128 g = internal::gcd128(internal::abs128(num), internal::uint128(den));
+		if (g > 1) {
+			setFromInt128(num / int128(g), den / int128(g));
+		}
+	}
 	else {
-		auto tmp = asExtended();
-		config_traits::simplify(tmp);
-		set(tmp);
+		base_type g = internal::gcd64(internal::abs64(getPq().num), getPq().den);
+		if (g > 1) {
+			getPq().num /= g;
+			getPq().den /= g;
+		}
 	}
 }
 
@@ -694,6 +883,9 @@ EI64PQ_CLS_NAME::numerator() const {
 	if (isExtended()) {
 		return ExtendedInt64z( config_traits::to_ei64z(config_traits::numerator(getExtended())) );
 	}
+	else if (isInt128()) {
+		return ExtendedInt64z( ExtendedInt64z::config_traits::make(num128()) );
+	}
 	else {
 		return ExtendedInt64z( getPq().num );
 	}
@@ -705,6 +897,9 @@ EI64PQ_CLS_NAME::denominator() const {
 	if (isExtended()) {
 		return ExtendedInt64z( config_traits::to_ei64z( config_traits::denominator(getExtended()) ) );
 	}
+	else if (isInt128()) {
+		return ExtendedInt64z( ExtendedInt64z::config_traits::make(den128()) );
+	}
 	else {
 		return ExtendedInt64z( getPq().den );
 	}
@@ -722,155 +917,245 @@ EI64PQ_CLS_NAME::operator-() const {
 	if (isExtended()) {
 		return ExtendedInt64q( -getExtended() );
 	}
-	else {
+	else if (isPq() && getPq().num != btmin) {
 		return ExtendedInt64q( -getPq().num, getPq().den );
 	}
+	else {
+		ExtendedInt64q result;
+		result.setFromInt128(-num128(), den128());
+		return result;
+	}
 }
 
 EI64PQ_TPL_PARAMS
 EI64PQ_CLS_NAME&
 EI64PQ_CLS_NAME::operator+=(const ExtendedInt64q &q) {
-	if (isExtended() && q.isExtended()) {
+	if (isPq() && q.isPq()) {
+		base_type a = getPq().num, b = getPq().den, c = q.getPq().num, d = q.getPq().den;
+		uint64_t g = internal::gcd64(b, d);
+		if (g == 1) {
+			setFromInt128(int128(a)*d + int128(c)*b, int128(b)*d);
+		}
+		else {
+			//see mpq_add
+			int128 t = int128(a)*base_type(d/g) + int128(c)*base_type(b/g);
+			if (t == 0) {
+				set(base_type(0), base_type(1));
+			}
+			else {
+				uint64_t g2 = internal::gcd64(uint64_t((t < 0 ? -t : t) % g), g);
+				setFromInt128(t / base_type(g2), int128(base_type(b/g)) * base_type(d/g2));
+			}
+		}
+	}
+	else if (isExtended() && q.isExtended()) {
 		getExtended() += q.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() += q.asExtended();
+		demote();
 	}
 	else if (q.isExtended()) {
 		set( asExtended() + q.getExtended() );
 	}
 	else {
-		set( asExtended() + q.asExtended() );
+		int128 num, den;
+		if (internal::add128(num128(), den128(), q.num128(), q.den128(), num, den)) {
+			setFromInt128(num, den);
+		}
+		else {
+			set( config_traits::add(num128(), den128(), q.num128(), q.den128()) );
+			EI64_INC_NUM_PROMOTIONS
+		}
 	}
+	EI64_COUNT_TIER
 	return *this;
 }
 
 EI64PQ_TPL_PARAMS
 EI64PQ_CLS_NAME&
 EI64PQ_CLS_NAME::operator-=(const ExtendedInt64q &q) {
-	if (isExtended() && q.isExtended()) {
+	if (isPq() && q.isPq()) {
+		base_type a = getPq().num, b = getPq().den, c = q.getPq().num, d = q.getPq().den;
+		uint64_t g = internal::gcd64(b, d);
+		if (g == 1) {
+			setFromInt128(int128(a)*d - int128(c)*b, int128(b)*d);
+		}
+		else {
+			//see mpq_sub
+			int128 t = int128(a)*base_type(d/g) - int128(c)*base_type(b/g);
+			if (t == 0) {
+				set(base_type(0), base_type(1));
+			}
+			else {
+				uint64_t g2 = internal::gcd64(uint64_t((t < 0 ? -t : t) % g), g);
+				setFromInt128(t / base_type(g2), int128(base_type(b/g)) * base_type(d/g2));
+			}
+		}
+	}
+	else if (isExtended() && q.isExtended()) {
 		getExtended() -= q.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() -= q.asExtended();
+		demote();
 	}
 	else if (q.isExtended()) {
 		set( asExtended() - q.getExtended() );
 	}
 	else {
-		set( asExtended() - q.asExtended() );
+		int128 num, den;
+		if (internal::add128(num128(), den128(), -q.num128(), q.den128(), num, den)) {
+			setFromInt128(num, den);
+		}
+		else {
+			set( config_traits::add(num128(), den128(), -q.num128(), q.den128()) );
+			EI64_INC_NUM_PROMOTIONS
+		}
 	}
+	EI64_COUNT_TIER
 	return *this;
 }
 
 EI64PQ_TPL_PARAMS
 EI64PQ_CLS_NAME&
 EI64PQ_CLS_NAME::operator*=(const ExtendedInt64q &q) {
-	if (isExtended() && q.isExtended()) {
+	if (isPq() && q.isPq()) {
+		base_type a = getPq().num, b = getPq().den, c = q.getPq().num, d = q.getPq().den;
+		if (a == 0 || c == 0) {
+			set(base_type(0), base_type(1));
+		}
+		else {
+			//see mpq_mul
+			base_type g1 = internal::gcd64(internal::abs64(a), d);
+			base_type g2 = internal::gcd64(internal::abs64(c), b);
+			setFromInt128(int128(a/g1) * (c/g2), int128(b/g2) * (d/g1));
+		}
+	}
+	else if (isExtended() && q.isExtended()) {
 		getExtended() *= q.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() *= q.asExtended();
+		demote();
 	}
 	else if (q.isExtended()) {
 		set( asExtended() * q.getExtended() );
 	}
 	else {
-		set( asExtended() * q.asExtended() );
+		int128 a = num128(), b = den128(), c = q.num128(), d = q.den128(), num, den;
+		if (internal::mul128_overflows(a, b, c, d)) {
+			//set() demotes the result if it fits nonetheless
+			set( config_traits::mul_unreduced(a, b, c, d) );
+			EI64_INC_NUM_PROMOTIONS
+		}
+		else if (internal::mul128(a, b, c, d, num, den)) {
+			setFromInt128(num, den);
+		}
+		else {
+			set( config_traits::mul(a, b, c, d) );
+			EI64_INC_NUM_PROMOTIONS
+		}
 	}
+	EI64_COUNT_TIER
 	return *this;
 }
 
 EI64PQ_TPL_PARAMS
 EI64PQ_CLS_NAME&
 EI64PQ_CLS_NAME::operator/=(const ExtendedInt64q &q) {
-	if (isExtended() && q.isExtended()) {
+	if (isPq() && q.isPq()) {
+		base_type a = getPq().num, b = getPq().den, c = q.getPq().num, d = q.getPq().den;
+		if (c == 0) {
+			throw std::domain_error("Division by zero");
+		}
+		if (a == 0) {
+			set(base_type(0), base_type(1));
+		}
+		else {
+			//see mpq_div
+			base_type g1 = internal::gcd64(internal::abs64(a), internal::abs64(c));
+			base_type g2 = internal::gcd64(b, d);
+			int128 num = int128(a/g1) * (d/g2);
+			int128 den = int128(b/g2) * (c/g1);
+			if (den < 0) {
+				num = -num;
+				den = -den;
+			}
+			setFromInt128(num, den);
+		}
+	}
+	else if (isExtended() && q.isExtended()) {
 		getExtended() /= q.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() /= q.asExtended();
+		demote();
 	}
 	else if (q.isExtended()) {
 		set( asExtended() / q.getExtended() );
 	}
 	else {
-		set( asExtended() / q.asExtended() );
+		if (q.sign() == ZERO) {
+			throw std::domain_error("Division by zero");
+		}
+		int128 a = num128(), b = den128(), c = q.num128(), d = q.den128(), num, den;
+		if (internal::div128(a, b, c, d, num, den)) {
+			setFromInt128(num, den);
+		}
+		else {
+			set( config_traits::mul(a, b, c, d) );
+			EI64_INC_NUM_PROMOTIONS
+		}
 	}
+	EI64_COUNT_TIER
 	return *this;
 }
 
 EI64PQ_TPL_PARAMS
 EI64PQ_CLS_NAME
 EI64PQ_CLS_NAME::operator+(const ExtendedInt64q & other) const {
-	if (isExtended() && other.isExtended()) {
-		return ExtendedInt64q( getExtended() + other.getExtended() );
-	}
-	else if (isExtended()) {
-		return ExtendedInt64q( getExtended() + other.asExtended() );
-	}
-	else if (other.isExtended()) {
-		return ExtendedInt64q( asExtended() + other.getExtended() );
-	}
-	else {
-		return ExtendedInt64q( asExtended() + other.asExtended() );
-	}
+	ExtendedInt64q result(*this);
+	result += other;
+	return result;
 }
 
 EI64PQ_TPL_PARAMS
 EI64PQ_CLS_NAME
 EI64PQ_CLS_NAME::operator-(const ExtendedInt64q & other) const {
-	if (isExtended() && other.isExtended()) {
-		return ExtendedInt64q( getExtended() - other.getExtended() );
-	}
-	else if (isExtended()) {
-		return ExtendedInt64q( getExtended() - other.asExtended() );
-	}
-	else if (other.isExtended()) {
-		return ExtendedInt64q( asExtended() - other.getExtended() );
-	}
-	else {
-		return ExtendedInt64q( asExtended() - other.asExtended() );
-	}
+	ExtendedInt64q result(*this);
+	result -= other;
+	return result;
 }
 
 EI64PQ_TPL_PARAMS
 EI64PQ_CLS_NAME
 EI64PQ_CLS_NAME::operator*(const ExtendedInt64q & other) const {
-	if (isExtended() && other.isExtended()) {
-		return ExtendedInt64q( getExtended() * other.getExtended() );
-	}
-	else if (isExtended()) {
-		return ExtendedInt64q( getExtended() * other.asExtended() );
-	}
-	else if (other.isExtended()) {
-		return ExtendedInt64q( asExtended() * other.getExtended() );
-	}
-	else {
-		return ExtendedInt64q( asExtended() * other.asExtended() );
-	}
+	ExtendedInt64q result(*this);
+	result *= other;
+	return result;
 }
 
 EI64PQ_TPL_PARAMS
 EI64PQ_CLS_NAME
 EI64PQ_CLS_NAME::operator/(const ExtendedInt64q & other) const {
-	if (isExtended() && other.isExtended()) {
-		return ExtendedInt64q( getExtended() / other.getExtended() );
-	}
-	else if (isExtended()) {
-		return ExtendedInt64q( getExtended() / other.asExtended() );
-	}
-	else if (other.isExtended()) {
-		return ExtendedInt64q( asExtended() / other.getExtended() );
-	}
-	else {
-		return ExtendedInt64q( asExtended() / other.asExtended() );
-	}
+	ExtendedInt64q result(*this);
+	result /= other;
+	return result;
 }
 
 EI64PQ_TPL_PARAMS
 bool
 EI64PQ_CLS_NAME::operator==(const ExtendedInt64q & other) const {
-	if (isExtended() && other.isExtended()) {
+	int cmp;
+	if (isPq() && other.isPq()) {
+		return (int128(getPq().num) * int128(other.getPq().den)) == (int128(other.getPq().num) * int128(getPq().den));
+	}
+	else if (isExtended() && other.isExtended()) {
 		return getExtended() == other.getExtended();
 	}
 	else if (isExtended()) {
@@ -879,15 +1164,22 @@ EI64PQ_CLS_NAME::operator==(const ExtendedInt64q & other) const {
 	else if (other.isExtended()) {
 		return asExtended() == other.getExtended();
 	}
+	else if (internal::cmp128(num128(), den128(), other.num128(), other.den128(), cmp)) {
+		return cmp == 0;
+	}
 	else {
-		return (int128(getPq().num) * int128(other.getPq().den)) == (int128(other.getPq().num) * int128(getPq().den));
+		return asExtended() == other.asExtended();
 	}
 }
 
 EI64PQ_TPL_PARAMS
 bool
 EI64PQ_CLS_NAME::operator< (const ExtendedInt64q &other) const {
-	if (isExtended() && other.isExtended()) {
+	int cmp;
+	if (isPq() && other.isPq()) {
+		return (int128(getPq().num) * int128(other.getPq().den)) < (int128(other.getPq().num) * int128(getPq().den));
+	}
+	else if (isExtended() && other.isExtended()) {
 		return getExtended() < other.getExtended();
 	}
 	else if (isExtended()) {
@@ -896,8 +1188,11 @@ EI64PQ_CLS_NAME::operator< (const ExtendedInt64q &other) const {
 	else if (other.isExtended()) {
 		return asExtended() < other.getExtended();
 	}
+	else if (internal::cmp128(num128(), den128(), other.num128(), other.den128(), cmp)) {
+		return cmp < 0;
+	}
 	else {
-		return (int128(getPq().num) * int128(other.getPq().den)) < (int128(other.getPq().num) * int128(getPq().den));
+		return asExtended() < other.asExtended();
 	}
 }
 
@@ -907,17 +1202,42 @@ EI64PQ_CLS_NAME::to_double() const {
 	if (isExtended()) {
 		return config_traits::to_double(getExtended());
 	}
+	else if (isInt128()) {
+		return static_cast<double>(num128()) / static_cast<double>(den128());
+	}
 	else {
 		return CGAL::to_double( Quotient<base_type>(getPq().num, getPq().den) );
 	}
 }
 
+EI64PQ_TPL_PARAMS
+std::pair<double, double>
+EI64PQ_CLS_NAME::to_interval() const {
+	if (isExtended()) {
+		return typename Real_embeddable_traits<extension_type>::To_interval()( getExtended() );
+	}
+	else if (isInt128()) {
+		Interval_nt<> quot = interval(num128()) / interval(den128());
+		return std::make_pair(quot.inf(), quot.sup());
+	}
+	else {
+		Interval_nt<> quot =
+		Interval_nt<>(CGAL_NTS to_interval(getPq().num)) /
+		Interval_nt<>(CGAL_NTS to_interval(getPq().den));
+		return std::make_pair(quot.inf(), quot.sup());
+	}
+}
+
 EI64PQ_TPL_PARAMS
 Sign
 EI64PQ_CLS_NAME::sign() const {
 	if (isExtended()) {
 		return CGAL::sign( getExtended() );
 	}
+	else if (isInt128()) {
+		//zero is always stored with 64 bits
+		return (m_v.v.pq128.numHigh < 0 ? NEGATIVE : POSITIVE);
+	}
 	else {
 		return CGAL::sign( getPq().num );
 	}
@@ -941,19 +1261,21 @@ EI64PQ_TPL_PARAMS
 typename EI64PQ_CLS_NAME::extension_type*
 EI64PQ_CLS_NAME::ptr() const {
 	assert(isExtended());
-	return m_v.ext.ptr;
+	return m_v.v.ext.ptr;
 }
 
 EI64PQ_TPL_PARAMS
 typename EI64PQ_CLS_NAME::PQ&
 EI64PQ_CLS_NAME::getPq() {
-	return m_v.pq;
+	assert(isPq());
+	return m_v.v.pq;
 }
 
 EI64PQ_TPL_PARAMS
 typename EI64PQ_CLS_NAME::ExtendedInt64q::PQ const &
 EI64PQ_CLS_NAME::getPq() const {
-	return m_v.pq;
+	assert(isPq());
+	return m_v.v.pq;
 }
 
 EI64PQ_TPL_PARAMS
@@ -962,6 +1284,9 @@ EI64PQ_CLS_NAME::asExtended() const {
 	if (isExtended()) {
 		return getExtended();
 	}
+	else if (isInt128()) {
+		return config_traits::make(num128(), den128());
+	}
 	else {
 		return config_traits::make(getPq().num, getPq().den);
 	}
@@ -970,7 +1295,53 @@ EI64PQ_CLS_NAME::asExtended() const {
 EI64PQ_TPL_PARAMS
 bool
 EI64PQ_CLS_NAME::isExtended() const {
-	return getPq().den == 0;
+	return m_v.tag == TAG_EXT;
+}
+
+EI64PQ_TPL_PARAMS
+bool
+EI64PQ_CLS_NAME::isInt128() const {
+	return m_v.tag >= 0;
+}
+
+EI64PQ_TPL_PARAMS
+bool
+EI64PQ_CLS_NAME::isPq() const {
+	return m_v.tag == TAG_PQ;
+}
+
+EI64PQ_TPL_PARAMS
+ExtendedInt64Stats::Tier
+EI64PQ_CLS_NAME::tier() const {
+	if (isPq()) {
+		return ExtendedInt64Stats::T_INT64;
+	}
+	else if (isInt128()) {
+		return ExtendedInt64Stats::T_INT128;
+	}
+	else {
+		return ExtendedInt64Stats::T_EXTENDED;
+	}
+}
+
+EI64PQ_TPL_PARAMS
+typename EI64PQ_CLS_NAME::int128
+EI64PQ_CLS_NAME::num128() const {
+	assert(!isExtended());
+	if (isPq()) {
+		return getPq().num;
+	}
+	return internal::join128(m_v.v.pq128.numHigh, m_v.v.pq128.numLow);
+}
+
+EI64PQ_TPL_PARAMS
+typename EI64PQ_CLS_NAME::int128
+EI64PQ_CLS_NAME::den128() const {
+	assert(!isExtended());
+	if (isPq()) {
+		return getPq().den;
+	}
+	return internal::join128(m_v.tag, m_v.v.pq128.denLow);
 }
 
 EI64PQ_TPL_PARAMS
@@ -986,63 +1357,87 @@ EI64PQ_CLS_NAME::set(base_type num, base_type den) {
 		deleteExt();
 	}
 	if (den < 0) {
+		if (num == btmin || den == btmin) {
+			setFromInt128(-int128(num), -int128(den));
+			return;
+		}
 		den = -den;
 		num = -num;
 	}
 	if (den == 0) {
 		throw std::domain_error("Denominator is not allowed to be zero");
 	}
+	m_v.tag = TAG_PQ;
 	getPq().num = num;
 	getPq().den = den;
-	assert(!isExtended());
+}
+
+EI64PQ_TPL_PARAMS
+void
+EI64PQ_CLS_NAME::setFromInt128(int128 num, int128 den) {
+	assert(den > 0);
+	if (btmin <= num && num <= btmax && den <= btmax) {
+		set(base_type(num), base_type(den));
+	}
+	else if (internal::fits127(num)) {
+		set128(num, den);
+	}
+	else {
+		set(config_traits::make(num, den));
+		EI64_INC_NUM_PROMOTIONS
+	}
+}
+
+EI64PQ_TPL_PARAMS
+void
+EI64PQ_CLS_NAME::set128(int128 num, int128 den) {
+	assert(internal::fits127(num) && den > 0);
+	if (isExtended()) {
+		deleteExt();
+	}
+	internal::split128(num, m_v.v.pq128.numHigh, m_v.v.pq128.numLow);
+	internal::split128(den, m_v.tag, m_v.v.pq128.denLow);
+	assert(isInt128());
 }
 
 EI64PQ_TPL_PARAMS
 void
 EI64PQ_CLS_NAME::set(const extension_type & v) {
-	auto num = config_traits::numerator(v);
-	auto den = config_traits::denominator(v);
-	
-	if (config_traits::fits_int64(num) && config_traits::fits_int64(den)) {
-		set(config_traits::to_int64(num), config_traits::to_int64(den));
+	int128 num, den;
+	if (config_traits::to_int128(v, num, den)) {
+		setFromInt128(num, den);
 		assert(asExtended() == v);
-		assert(num == internal::ExtendedInt64zTraits<decltype(num)>::make(getPq().num));
-		assert(den == internal::ExtendedInt64zTraits<decltype(den)>::make(getPq().den));
 	}
 	else {
 		if (isExtended()) {
 			getExtended() = v;
 		}
 		else {
-			set( new extension_type(v) );
+			set( internal::ExtendedInt64Pool<extension_type>::create(v) );
 			EI64_INC_NUM_E_ALLOC
 		}
 		assert(isExtended());
-		EI64_UPDATE_MAX_BITS( getExtended() );
+		EI64_UPDATE_BITS( getExtended() );
 	}
 }
 EI64PQ_TPL_PARAMS
 void
 EI64PQ_CLS_NAME::set(extension_type && v) {
-	auto num = config_traits::numerator(v);
-	auto den = config_traits::denominator(v);
-	
-	if (config_traits::fits_int64(num) && config_traits::fits_int64(den)) {
-		set(config_traits::to_int64(num), config_traits::to_int64(den));
+	int128 num, den;
+	if (config_traits::to_int128(v, num, den)) {
+		setFromInt128(num, den);
 		assert(asExtended() == v);
-		assert(num == internal::ExtendedInt64zTraits<decltype(num)>::make(getPq().num));
-		assert(den == internal::ExtendedInt64zTraits<decltype(den)>::make(getPq().den));
 	}
 	else {
 		if (isExtended()) {
 			getExtended() = std::move(v);
 		}
 		else {
-			set( new extension_type(std::move(v)) );
+			set( internal::ExtendedInt64Pool<extension_type>::create(std::move(v)) );
 			EI64_INC_NUM_E_ALLOC
 		}
 		assert(isExtended());
-		EI64_UPDATE_MAX_BITS( getExtended() );
+		EI64_UPDATE_BITS( getExtended() );
 	}
 }
 
@@ -1050,13 +1445,24 @@ EI64PQ_TPL_PARAMS
 void
 EI64PQ_CLS_NAME::set(ExtendedInt64q::extension_type* v) {
 	if (v) {
-		getPq().den = 0;
-		m_v.ext.ptr = v;
-		EI64_UPDATE_MAX_BITS(getExtended());
+		m_v.tag = TAG_EXT;
+		m_v.v.ext.ptr = v;
 	}
 	else {
+		m_v.tag = TAG_PQ;
 		getPq().num = 0;
-		getPq().den = 0xFEFE;
+		getPq().den = 1;
+	}
+}
+
+EI64PQ_TPL_PARAMS
+void
+EI64PQ_CLS_NAME::demote() {
+	assert(isExtended());
+	int128 num, den;
+	if (config_traits::to_int128(getExtended(), num, den)) {
+		setFromInt128(num, den);
+		EI64_INC_NUM_DEMOTIONS
 	}
 }
 
@@ -1064,17 +1470,32 @@ EI64PQ_TPL_PARAMS
 void
 EI64PQ_CLS_NAME::deleteExt() {
 	assert(isExtended());
-	delete ptr();
+	internal::ExtendedInt64Pool<extension_type>::release(ptr());
 	EI64_DEC_NUM_E_ALLOC
 	set((extension_type*)0);
 }
 
+EI64PQ_TPL_PARAMS
+Interval_nt<>
+EI64PQ_CLS_NAME::interval(int128 v) {
+	base_type high;
+	uint64_t low;
+	internal::split128(v, high, low);
+	//all summands are exact doubles, only the additions round
+	return Interval_nt<>(CGAL_NTS to_interval(high)) * Interval_nt<>(18446744073709551616.0) +
+		Interval_nt<>(double(low >> 32) * 4294967296.0) +
+		Interval_nt<>(double(low & 0xFFFFFFFF));
+}
+
 EI64PQ_TPL_PARAMS
 std::ostream &
 operator<<(std::ostream & out, const EI64PQ_CLS_NAME & v) {
 	if (v.isExtended()) {
 		out << v.getExtended();
 	}
+	else if (v.isInt128()) {
+		out << v.asExtended();
+	}
 	else {
 		out << v.numerator().get() << '/' << v.denominator().get();
 	}
@@ -1085,6 +1506,10 @@ operator<<(std::ostream & out, const EI64PQ_CLS_NAME & v) {
 #undef EI64_DEC_NUM_E_ALLOC
 #undef EI64_INC_NUM_ALLOC
 #undef EI64_DEC_NUM_ALLOC
+#undef EI64_INC_NUM_PROMOTIONS
+#undef EI64_INC_NUM_DEMOTIONS
+#undef EI64_UPDATE_BITS
+#undef EI64_COUNT_TIER
 
 #undef EI64PQ_TPL_PARAMS
 #undef EI64PQ_CLS_NAME
@@ -1111,8 +1536,16 @@ struct ExtendedInt64qTraits<CGAL::Gmpq> {
 	static denominator_type denominator(const type & v);
 	static CGAL::ExtendedInt64z::extension_type const & to_ei64z(const numerator_type & v);
 	static uint32_t num_bits(const numerator_type &);
+	static uint32_t numerator_bits(const type & v);
+	static uint32_t denominator_bits(const type & v);
+	static bool to_int128(const type & v, int128 & numerator, int128 & denominator);
+	static constexpr ExtendedInt64Stats::Kind stats_kind = ExtendedInt64Stats::K_RATIONAL;
 	static type make(base_type numerator, unsigned_base_type denominator);
 	static type make(base_type numerator, base_type denominator);
+	static type make(int128 numerator, int128 denominator);
+	static type add(int128 a, int128 b, int128 c, int128 d);
+	static type mul(int128 a, int128 b, int128 c, int128 d);
+	static type mul_unreduced(int128 a, int128 b, int128 c, int128 d);
 };
 
 template<>
@@ -1130,37 +1563,20 @@ struct ExtendedInt64qTraits<boost_int1024q> {
 	static denominator_type denominator(const type & v);
 	static CGAL::ExtendedInt64z::extension_type to_ei64z(const numerator_type & v);
 	static uint32_t num_bits(const numerator_type & v);
+	static uint32_t numerator_bits(const type & v);
+	static uint32_t denominator_bits(const type & v);
+	static bool to_int128(const type & v, int128 & numerator, int128 & denominator);
+	static constexpr ExtendedInt64Stats::Kind stats_kind = ExtendedInt64Stats::K_RATIONAL_BOOST;
 	static type make(base_type numerator, unsigned_base_type denominator);
 	static type make(base_type numerator, base_type denominator);
+	static type make(int128 numerator, int128 denominator);
+	static type add(int128 a, int128 b, int128 c, int128 d);
+	static type mul(int128 a, int128 b, int128 c, int128 d);
+	static type mul_unreduced(int128 a, int128 b, int128 c, int128 d);
 };
 
 } //end namespace internal
 
-template<>
-uint64_t ExtendedInt64q<CGAL::Gmpq>::number_of_extended_allocations;
-
-template<>
-uint64_t ExtendedInt64q<CGAL::Gmpq>::number_of_allocations;
-
-template<>
-uint32_t ExtendedInt64q<CGAL::Gmpq>::max_numerator_bits;
-
-template<>
-uint32_t ExtendedInt64q<CGAL::Gmpq>::max_denominator_bits;
-
-template<>
-uint64_t ExtendedInt64q<CGAL::internal::boost_int1024q>::number_of_extended_allocations;
-
-template<>
-uint64_t ExtendedInt64q<CGAL::internal::boost_int1024q>::number_of_allocations;
-
-template<>
-uint32_t ExtendedInt64q<CGAL::internal::boost_int1024q>::max_numerator_bits;
-
-template<>
-uint32_t ExtendedInt64q<CGAL::internal::boost_int1024q>::max_denominator_bits;
-
-
 }//end namespace CGAL
 
 #if defined(BOOST_MSVC)
@@ -33,6 +33,8 @@
 #include <CGAL/Gmpz.h>
 
 #include <libratss/types.h>
+#include <libratss/CGAL/ExtendedInt64Pool.h>
+#include <libratss/CGAL/ExtendedInt64Stats.h>
 
 #include <boost/multiprecision/cpp_int.hpp>
 
@@ -44,6 +46,12 @@ namespace internal {
 using boost_int128 = boost::multiprecision::int128_t;
 using boost_int1024 = boost::multiprecision::int1024_t;
 
+#ifdef __SIZEOF_INT128__
+using int128 = __int128_t;
+#else
+using int128 = boost_int128;
+#endif
+
 
 template<typename T_EXTENSION_TYPE>
 struct ExtendedInt64zTraits {
@@ -51,6 +59,7 @@ struct ExtendedInt64zTraits {
 	using primitive_type = LIB_RATSS_NAMESPACE::gmp_int64_t;
 	static type make(int64_t v);
 	static type make(uint64_t v);
+	static type make(int128 v);
 	static primitive_type make_primitive(int64_t v);
 };
 
@@ -60,6 +69,7 @@ struct ExtendedInt64zTraits<CGAL::Gmpz> {
 	using primitive_type = LIB_RATSS_NAMESPACE::gmp_int64_t;
 	static type make(int64_t v);
 	static type make(uint64_t v);
+	static type make(int128 v);
 	static primitive_type make_primitive(int64_t v);
 };
 
@@ -69,6 +79,7 @@ struct ExtendedInt64zTraits<boost_int1024> {
 	using primitive_type = LIB_RATSS_NAMESPACE::gmp_int64_t;
 	static type make(int64_t v);
 	static type make(uint64_t v);
+	static type make(int128 v);
 	static primitive_type make_primitive(int64_t v);
 };
 
@@ -98,10 +109,12 @@ public:
 	using unsigned_base_type = typename std::make_unsigned<base_type>::type;
 	using extension_type = CGAL::Gmpz;
 	using config_traits = internal::ExtendedInt64zTraits<extension_type>;
+	using int128 = internal::int128;
 // 	static_assert( --std::numeric_limits<base_type>::min() == std::numeric_limits<base_type>::min(), "");
 public:
+	///allocation statistics summed up over all threads
+	static ExtendedInt64Stats::Counters stats();
 public:
-	static uint64_t number_of_extended_allocations;
 	ExtendedInt64z();
 	ExtendedInt64z(const ExtendedInt64z & other);
 	ExtendedInt64z(ExtendedInt64z && other);
@@ -111,6 +124,7 @@ public:
 	ExtendedInt64z(uint64_t l);
 	ExtendedInt64z(double d);
 	ExtendedInt64z(const std::string& str, int base = 10);
+	~ExtendedInt64z();
 	ExtendedInt64z& operator=(const ExtendedInt64z & other);
 	ExtendedInt64z& operator=(ExtendedInt64z && other);
 public:
@@ -194,7 +208,10 @@ private:
 	extension_type * ptr() const;
 	void set(base_type v);
 	void set(const extension_type & v);
+	void set(extension_type && v);
 	void set(extension_type * v);
+	///switches back to base_type if the extended value fits
+	void demote();
 	void deleteExt();
 private:
 	union {
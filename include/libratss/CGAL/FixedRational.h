@@ -0,0 +1,255 @@
+#ifndef LIBRATSS_CGAL_FIXED_RATIONAL_H
+#define LIBRATSS_CGAL_FIXED_RATIONAL_H
+#pragma once
+
+#include <libratss/CGAL/ExtendedInt64q.h>
+
+#include <CGAL/Gmpz.h>
+#include <CGAL/Gmpq.h>
+
+#include <gmp.h>
+#include <algorithm>
+#include <ostream>
+#include <string>
+
+namespace CGAL {
+
+///Smallest supported width of FixedRational that holds the 2D predicates
+///on points snapped with ST_FX | ST_PLANE and the given number of significands.
+///An in-circle test on such points needs about 16*significands+10 bits.
+///@return 0 if there is no such width
+constexpr int fixedRationalBits(int significands) {
+	return (significands <= 15 ? 256 : (significands <= 31 ? 512 : (significands <= 63 ? 1024 : 0)));
+}
+
+///Signed integer with at most T_BITS bits in sign magnitude representation.
+///Only the used limbs take part in the arithmetic.
+///Results that do not fit throw std::overflow_error.
+template<int T_BITS>
+class FixedInteger {
+	static_assert(T_BITS > 0 && T_BITS % GMP_NUMB_BITS == 0, "T_BITS has to be a positive multiple of the gmp limb size");
+public:
+	static constexpr int BITS = T_BITS;
+	static constexpr int LIMBS = T_BITS / GMP_NUMB_BITS;
+public:
+	FixedInteger();
+	FixedInteger(int v);
+	FixedInteger(long v);
+	FixedInteger(long long v);
+	FixedInteger(unsigned long v);
+	FixedInteger(unsigned long long v);
+	explicit FixedInteger(internal::int128 v);
+	explicit FixedInteger(const CGAL::Gmpz & v);
+	///absolute value in limbs, negative size if the value is negative
+	FixedInteger(const mp_limb_t * limbs, mp_size_t size);
+	///only copies the used limbs
+	inline FixedInteger(const FixedInteger & other) : m_size(other.m_size) { copyLimbs(other); }
+	inline FixedInteger & operator=(const FixedInteger & other) { m_size = other.m_size; copyLimbs(other); return *this; }
+public:
+	///number of used limbs, negative if the value is negative
+	inline mp_size_t size() const { return m_size; }
+	inline const mp_limb_t * limbs() const { return m_limbs; }
+	inline int sign() const { return (m_size > 0 ? 1 : (m_size < 0 ? -1 : 0)); }
+	uint32_t bits() const;
+	bool fits_int64() const;
+	int64_t to_int64() const;
+	double to_double() const;
+	///read-only mpz_t of the limbs
+	mpz_srcptr mpz(mpz_ptr view) const;
+	CGAL::Gmpz to_gmpz() const;
+public:
+	FixedInteger operator-() const;
+	FixedInteger operator*(const FixedInteger & other) const;
+	bool operator==(const FixedInteger & other) const;
+	bool operator<(const FixedInteger & other) const;
+	inline bool operator!=(const FixedInteger & other) const { return !(*this == other); }
+private:
+	inline void copyLimbs(const FixedInteger & other) {
+		std::copy(other.m_limbs, other.m_limbs + (m_size < 0 ? -m_size : m_size), m_limbs);
+	}
+	void setWords(bool negative, const uint64_t * words, int count);
+private:
+	mp_limb_t m_limbs[LIMBS];
+	mp_size_t m_size;
+};
+
+///Canonical rational number whose numerator and denominator have at most T_BITS bits each.
+///Only built with LIB_RATSS_WITH_FIXED_RATIONAL (cmake -DLIBRATSS_WITH_FIXED_RATIONAL=ON):
+///so far it is not faster than ExtendedInt64q<CGAL::Gmpq> on snapped points.
+///Replaces boost::multiprecision::int1024_t with rational_adaptor:
+///the arithmetic only runs across the used limbs and gcds use Lehmer's algorithm.
+///Results that do not fit throw std::overflow_error.
+template<int T_BITS>
+class FixedRational {
+public:
+	using numerator_type = FixedInteger<T_BITS>;
+	using denominator_type = FixedInteger<T_BITS>;
+	static constexpr int BITS = T_BITS;
+public:
+	FixedRational();
+	FixedRational(int v);
+	FixedRational(long v);
+	FixedRational(long long v);
+	FixedRational(double v);
+	explicit FixedRational(const numerator_type & n);
+	FixedRational(const numerator_type & n, const denominator_type & d);
+	explicit FixedRational(const CGAL::Gmpz & n);
+	FixedRational(const CGAL::Gmpz & n, const CGAL::Gmpz & d);
+	///v has to be canonical
+	explicit FixedRational(mpq_srcptr v);
+	FixedRational(const std::string & str, int base = 10);
+	///n/d has to be canonical with d > 0
+	static FixedRational fromCanonical(const numerator_type & n, const denominator_type & d);
+public:
+	inline const numerator_type & numerator() const { return m_num; }
+	inline const denominator_type & denominator() const { return m_den; }
+	inline int sign() const { return m_num.sign(); }
+	double to_double() const;
+	std::pair<double, double> to_interval() const;
+	///read-only mpq_t of the limbs, num and den provide the storage
+	mpq_srcptr mpq(mpq_ptr view) const;
+	CGAL::Gmpq to_gmpq() const;
+public:
+	FixedRational operator+() const;
+	FixedRational operator-() const;
+	FixedRational & operator+=(const FixedRational & other);
+	FixedRational & operator-=(const FixedRational & other);
+	FixedRational & operator*=(const FixedRational & other);
+	FixedRational & operator/=(const FixedRational & other);
+	FixedRational operator+(const FixedRational & other) const;
+	FixedRational operator-(const FixedRational & other) const;
+	FixedRational operator*(const FixedRational & other) const;
+	FixedRational operator/(const FixedRational & other) const;
+	bool operator==(const FixedRational & other) const;
+	bool operator<(const FixedRational & other) const;
+	inline bool operator!=(const FixedRational & other) const { return !(*this == other); }
+	inline bool operator>(const FixedRational & other) const { return other < *this; }
+	inline bool operator<=(const FixedRational & other) const { return !(other < *this); }
+	inline bool operator>=(const FixedRational & other) const { return !(*this < other); }
+private:
+	///sets this to the canonical form of n/d, the sizes are signed and have to be at most LIMBS
+	void assign(const mp_limb_t * n, mp_size_t nsize, const mp_limb_t * d, mp_size_t dsize);
+	///canonicalizes and clears v
+	void assignAndClear(mpq_ptr v);
+	void add(const FixedRational & other, bool subtract);
+	void mul(const FixedRational & other, bool divide);
+private:
+	numerator_type m_num;
+	denominator_type m_den;
+};
+
+template<int T_BITS>
+std::ostream & operator<<(std::ostream & out, const FixedInteger<T_BITS> & v);
+
+template<int T_BITS>
+std::ostream & operator<<(std::ostream & out, const FixedRational<T_BITS> & v);
+
+// AST for FixedRational
+
+template<int T_BITS>
+class Algebraic_structure_traits< FixedRational<T_BITS> > : public Algebraic_structure_traits_base< FixedRational<T_BITS>, Field_tag > {
+private:
+	typedef FixedRational<T_BITS> Type;
+	typedef Algebraic_structure_traits<CGAL::Gmpq> BaseAst;
+public:
+	typedef Tag_true            Is_exact;
+	typedef Tag_false            Is_numerical_sensitive;
+
+	class Is_square: public std::binary_function<Type, Type&, bool >  {
+	public:
+		bool operator()( const Type& x, Type& y ) const {
+			CGAL::Gmpq yq;
+			bool ret = m_p(x.to_gmpq(), yq);
+			y = Type(yq.mpq());
+			return ret;
+		}
+		bool operator()( const Type& x) const {
+			return m_p(x.to_gmpq());
+		}
+	private:
+		typename BaseAst::Is_square m_p;
+	};
+
+	class Simplify: public std::unary_function< Type&, void > {
+	public:
+		void operator()(Type& /*x*/) const {}
+	};
+};
+
+// RET for FixedRational
+
+template<int T_BITS>
+class Real_embeddable_traits< FixedRational<T_BITS> >: public INTERN_RET::Real_embeddable_traits_base< FixedRational<T_BITS>, CGAL::Tag_true > {
+private:
+	typedef FixedRational<T_BITS> Type;
+public:
+	class Sgn: public std::unary_function< Type, ::CGAL::Sign > {
+	public:
+		::CGAL::Sign operator()( const Type& x ) const {
+			return ::CGAL::Sign(x.sign());
+		}
+	};
+
+	class To_double: public std::unary_function< Type, double > {
+	public:
+		double operator()( const Type& x ) const {
+			return x.to_double();
+		}
+	};
+
+	class To_interval: public std::unary_function< Type, std::pair< double, double > > {
+	public:
+		std::pair<double, double> operator()(const Type & x) const {
+			return x.to_interval();
+		}
+	};
+};
+
+namespace internal {
+
+template<int T_BITS>
+struct ExtendedInt64qTraits< FixedRational<T_BITS> > {
+	using type = FixedRational<T_BITS>;
+	using base_type = CGAL::ExtendedInt64z::base_type;
+	using unsigned_base_type = std::make_unsigned<base_type>::type;
+	using numerator_type = typename type::numerator_type;
+	using denominator_type = typename type::denominator_type;
+	static void simplify(type & v);
+	static bool fits_int64(const numerator_type & v);
+	static int64_t to_int64(const numerator_type & v);
+	static double to_double(const type & v);
+	static numerator_type numerator(const type & v);
+	static denominator_type denominator(const type & v);
+	static CGAL::ExtendedInt64z::extension_type to_ei64z(const numerator_type & v);
+	static uint32_t num_bits(const numerator_type & v);
+	static uint32_t numerator_bits(const type & v);
+	static uint32_t denominator_bits(const type & v);
+	static bool to_int128(const type & v, int128 & numerator, int128 & denominator);
+	static constexpr ExtendedInt64Stats::Kind stats_kind = ExtendedInt64Stats::K_RATIONAL_FIXED;
+	static type make(base_type numerator, unsigned_base_type denominator);
+	static type make(base_type numerator, base_type denominator);
+	static type make(int128 numerator, int128 denominator);
+	static type add(int128 a, int128 b, int128 c, int128 d);
+	static type mul(int128 a, int128 b, int128 c, int128 d);
+	static type mul_unreduced(int128 a, int128 b, int128 c, int128 d);
+};
+
+} //end namespace internal
+
+//the definitions are in FixedRational.cpp
+#define LIBRATSS_CGAL_FIXED_RATIONAL_EXTERN(__BITS) \
+	extern template class FixedInteger<__BITS>; \
+	extern template class FixedRational<__BITS>; \
+	extern template std::ostream & operator<<(std::ostream &, const FixedInteger<__BITS> &); \
+	extern template std::ostream & operator<<(std::ostream &, const FixedRational<__BITS> &); \
+	namespace internal { extern template struct ExtendedInt64qTraits< FixedRational<__BITS> >; }
+
+LIBRATSS_CGAL_FIXED_RATIONAL_EXTERN(256)
+LIBRATSS_CGAL_FIXED_RATIONAL_EXTERN(512)
+LIBRATSS_CGAL_FIXED_RATIONAL_EXTERN(1024)
+
+#undef LIBRATSS_CGAL_FIXED_RATIONAL_EXTERN
+
+} //end namespace CGAL
+
+#endif
@@ -74,11 +74,19 @@ public:
 	mpq_class squaredDistance(T_ITERATOR_1 begin1, const T_ITERATOR_1 & end1, T_ITERATOR_2 begin2) const;
 	template<typename T_ITERATOR_1, typename T_ITERATOR_2>
 	mpq_class maxNorm(T_ITERATOR_1 begin1, const T_ITERATOR_1 & end1, T_ITERATOR_2 begin2) const;
+	///Bounds of the exact squared distance with the precision of lower and upper without rational temporaries.
+	template<typename T_ITERATOR_1, typename T_ITERATOR_2>
+	void squaredDistance(T_ITERATOR_1 begin1, const T_ITERATOR_1 & end1, T_ITERATOR_2 begin2, mpfr::mpreal & lower, mpfr::mpreal & upper) const;
+	///Bounds of the exact max norm with the precision of lower and upper without rational temporaries.
+	///lower is equal to upper if the max norm is representable with the precision of lower.
+	template<typename T_ITERATOR_1, typename T_ITERATOR_2>
+	void maxNorm(T_ITERATOR_1 begin1, const T_ITERATOR_1 & end1, T_ITERATOR_2 begin2, mpfr::mpreal & lower, mpfr::mpreal & upper) const;
 public:
 	///@return r a number satisfying the following conditions:
 	/// r is a fraction with the smallest denominator such that lower <= r <= upper
 	mpq_class within(const mpq_class& lower, const mpq_class& upper) const;
 	
+	///@return the first convergent of the continued fraction of value that is closer than 2^-significands to value
 	mpq_class contFrac(const mpq_class& value, int significands) const;
 	
 	void jacobiPerron2D(const mpq_class& input1, const mpq_class& input2, mpq_class& output1, mpq_class& output2, int significands) const;
@@ -89,8 +97,13 @@ public:
 	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 	void lll(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, mpz_class & common_denom, int significands) const;
 	
+	///ST_CF: contFrac(v, eps). If eps < 0 the fraction with the smallest denominator in [v-d, v+d]
+	///with d = 2^-(v.getPrecision()+1), i.e. half an ulp of v if 1/2 <= |v| < 1.
 	mpq_class snap(const mpfr::mpreal & v, int st, int eps = -1) const;
+	///ST_CF: contFrac(v, eps), v itself if eps < 0.
+	///ST_FX and ST_FL: snap of v rounded to an mpfr::mpreal with max(2*eps, default precision) bits.
 	mpq_class snap(const mpq_class & v, int st, int eps = -1) const;
+	///ST_CF only: the fraction with the smallest denominator in [v-eps, v+eps]
 	mpq_class snap(const mpq_class & v, int st, const mpq_class & eps) const;
 public:
 	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
@@ -118,6 +131,52 @@ public:
 	toRational(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int eps = -1) const;
 public:
 	std::size_t maxBitCount(const mpq_class &v) const;
+private:
+	///result = |a - b| rounded towards zero
+	///@return true if result is not exact
+	static bool absDifference(mpfr_ptr result, const mpfr::mpreal & a, const mpq_class & b);
+	template<typename T_FT_1, typename T_FT_2>
+	static bool absDifference(mpfr_ptr result, const T_FT_1 & a, const T_FT_2 & b);
+};
+
+///Continued fraction expansion of a rational number that can be resumed with more significands.
+///approximation(significands) is equal to Calc::contFrac(value, significands),
+///but only the partial quotients not needed by the previous call are computed.
+class ContinuedFraction {
+public:
+	ContinuedFraction();
+	explicit ContinuedFraction(const mpq_class & value);
+public:
+	///If significands is smaller than in the previous call, then the expansion starts over.
+	mpq_class approximation(int significands);
+	///the significands of the last call to approximation, -1 if there was none
+	inline int significands() const { return m_significands; }
+	///true if the approximation is the value itself
+	inline bool exact() const { return m_stage == S_EXACT; }
+private:
+	typedef enum {
+		S_START, //the fractional part was smaller than eps
+		S_NEXT, //the next partial quotient has to be computed
+		S_QUOTIENT, //the error bound of the partial quotient in m_a was too large
+		S_CONVERGENT, //the current convergent is closer than eps
+		S_EXACT //the expansion is complete
+	} Stage;
+private:
+	void reset();
+	void expand(int significands);
+private:
+	int m_sign;
+	///integral and fractional part of the absolute value
+	mpz_class m_int;
+	mpq_class m_frac;
+	///remainder of the expansion and the next partial quotient
+	mpq_class m_tmp;
+	mpz_class m_a;
+	///the current convergent is m_qn/m_pn
+	mpz_class m_pn, m_pn1, m_pn2;
+	mpz_class m_qn, m_qn1, m_qn2;
+	Stage m_stage;
+	int m_significands;
 };
 
 }//end namespace LIB_RATSS_NAMESPACE
@@ -390,6 +449,49 @@ mpq_class Calc::maxNorm(T_ITERATOR_1 begin1, const T_ITERATOR_1 & end1, T_ITERAT
 	return result;
 }
 
+template<typename T_ITERATOR_1, typename T_ITERATOR_2>
+void Calc::squaredDistance(T_ITERATOR_1 begin1, const T_ITERATOR_1 & end1, T_ITERATOR_2 begin2, mpfr::mpreal & lower, mpfr::mpreal & upper) const {
+	mpfr::mpreal diff(0, lower.getPrecision());
+	mpfr::mpreal sq(0, upper.getPrecision());
+	lower = 0;
+	upper = 0;
+	for(; begin1 != end1; ++begin1, ++begin2) {
+		bool inexact = absDifference(diff.mpfr_ptr(), *begin1, *begin2);
+		mpfr_sqr(sq.mpfr_ptr(), diff.mpfr_srcptr(), MPFR_RNDD);
+		mpfr_add(lower.mpfr_ptr(), lower.mpfr_srcptr(), sq.mpfr_srcptr(), MPFR_RNDD);
+		if (inexact) {
+			mpfr_nextabove(diff.mpfr_ptr());
+		}
+		mpfr_sqr(sq.mpfr_ptr(), diff.mpfr_srcptr(), MPFR_RNDU);
+		mpfr_add(upper.mpfr_ptr(), upper.mpfr_srcptr(), sq.mpfr_srcptr(), MPFR_RNDU);
+	}
+}
+
+template<typename T_ITERATOR_1, typename T_ITERATOR_2>
+void Calc::maxNorm(T_ITERATOR_1 begin1, const T_ITERATOR_1 & end1, T_ITERATOR_2 begin2, mpfr::mpreal & lower, mpfr::mpreal & upper) const {
+	mpfr::mpreal diff(0, lower.getPrecision());
+	lower = 0;
+	upper = 0;
+	for(; begin1 != end1; ++begin1, ++begin2) {
+		bool inexact = absDifference(diff.mpfr_ptr(), *begin1, *begin2);
+		if (mpfr_cmp(diff.mpfr_srcptr(), lower.mpfr_srcptr()) > 0) {
+			mpfr_set(lower.mpfr_ptr(), diff.mpfr_srcptr(), MPFR_RNDD);
+		}
+		if (inexact) {
+			mpfr_nextabove(diff.mpfr_ptr());
+		}
+		if (mpfr_cmp(diff.mpfr_srcptr(), upper.mpfr_srcptr()) > 0) {
+			mpfr_set(upper.mpfr_ptr(), diff.mpfr_srcptr(), MPFR_RNDU);
+		}
+	}
+}
+
+template<typename T_FT_1, typename T_FT_2>
+bool Calc::absDifference(mpfr_ptr result, const T_FT_1 & a, const T_FT_2 & b) {
+	mpq_class tmp = abs(Conversion<T_FT_1>::toMpq(a) - Conversion<T_FT_2>::toMpq(b));
+	return mpfr_set_q(result, tmp.get_mpq_t(), MPFR_RNDZ) != 0;
+}
+
 }//end namespace LIB_RATSS_NAMESPACE
 
 #endif
@@ -17,6 +17,7 @@ struct Conversion;
 // 	using type = T_FT;
 // 	this shall be a move in case T_FT == mpq_class
 // 	static type moveFrom(mpq_class && v);
+// 	types whose representation can take over the limbs of v may add an overload for mpq_class &&
 // 	
 // 	this shall return the reference to v in case T_FT == mpq_class
 // 	static mpq_class toMpq(const type & v);
@@ -34,6 +35,7 @@ template<>
 struct Conversion<double> {
 	using type = double;
 	static type moveFrom(const mpq_class & v);
+	///exact, throws std::domain_error if v is not finite
 	static mpq_class toMpq(const type & v);
 	static mpfr::mpreal toMpreal(const type & v, int precision);
 };
@@ -50,7 +52,10 @@ template<>
 struct Conversion<mpfr::mpreal> {
 	using type = mpfr::mpreal;
 	static type moveFrom(const mpq_class & v);
+	///exact, throws std::domain_error if v is not finite
 	static mpq_class toMpq(const type & v);
+	///the same as above but reuses the storage of result
+	static void toMpq(const type & v, mpq_class & result);
 	static const mpfr::mpreal & toMpreal(const type & v, int precision);
 };
 
@@ -61,6 +66,11 @@ struct Conversion<mpq_class> {
 	static type && moveFrom(mpq_class && v);
 	static const mpq_class & toMpq(const type & v);
 	static mpfr::mpreal toMpreal(const type & v, int precision);
+	///rounds v to the precision of result with the default rounding mode
+	///power of two denominators (as produced by ST_FX) only need a shift
+	static void toMpreal(const type & v, mpfr_ptr result);
+	///the same as above but reuses the storage of result
+	static void toMpreal(const type & v, mpfr::mpreal & result, int precision);
 };
 
 }//end namespace LIB_RATSS_NAMESPACE
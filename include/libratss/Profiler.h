@@ -0,0 +1,124 @@
+#ifndef LIB_RATSS_PROFILER_H
+#define LIB_RATSS_PROFILER_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <gmpxx.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#if defined(LIB_RATSS_WITH_PROFILING) && (defined(__x86_64__) || defined(__i386__))
+	#include <x86intrin.h>
+#endif
+
+namespace LIB_RATSS_NAMESPACE {
+
+///Optional instrumentation of ProjectSN::snap.
+///Recording is compiled out unless LIB_RATSS_WITH_PROFILING is defined (cmake -DLIBRATSS_WITH_PROFILING=ON).
+///Every thread records into its own counters, stats() aggregates them over all threads.
+class Profiler {
+public:
+	typedef enum {
+		PS_SNAP=0, //a complete call to ProjectSN::snap, includes all other stages
+		PS_NORMALIZE,
+		PS_SPHERE_TO_PLANE,
+		PS_TO_RATIONAL,
+		PS_PLANE_TO_SPHERE,
+		PS_SPHERE_TO_PLANE_TO_SPHERE, //the fused exact round trip of ST_SPHERE, not included in sphere2Plane and plane2Sphere
+		PS_AUTO_CANDIDATE, //snapping and grading of a single candidate during auto snapping
+		PS__NUMBER_OF_STAGES
+	} Stage;
+	static constexpr std::size_t DENOM_BITS_BUCKET_WIDTH = 8;
+	///the last bucket also holds all larger denominators
+	static constexpr std::size_t DENOM_BITS_BUCKETS = 128;
+	struct StageStats {
+		uint64_t calls;
+		uint64_t ticks;
+	};
+	class Stats {
+	public:
+		Stats();
+	public:
+		Stats & operator+=(const Stats & other);
+		void print(std::ostream & out) const;
+	public:
+		std::array<StageStats, PS__NUMBER_OF_STAGES> stages;
+		///denomBits[i] counts output coordinates with a denominator of [i, i+1)*DENOM_BITS_BUCKET_WIDTH bits
+		std::array<uint64_t, DENOM_BITS_BUCKETS> denomBits;
+	};
+	///Records the ticks spent between construction and destruction
+	class Scope final {
+	public:
+	#ifdef LIB_RATSS_WITH_PROFILING
+		inline explicit Scope(Stage stage) : m_stage(stage), m_begin(ticks()) {}
+		inline ~Scope() { record(m_stage, ticks()-m_begin); }
+	private:
+		Stage m_stage;
+		uint64_t m_begin;
+	#else
+		inline explicit Scope(Stage) {}
+	#endif
+	};
+	///Counts the nested snaps of the calling thread, e.g. the ones of snapping with a Precision target.
+	///Only the outermost one records PS_SNAP and the denominators of its results.
+	class Nesting final {
+	public:
+	#ifdef LIB_RATSS_WITH_PROFILING
+		inline Nesting() : m_outermost(depth()++ == 0) {}
+		inline ~Nesting() { --depth(); }
+		inline bool outermost() const { return m_outermost; }
+	private:
+		bool m_outermost;
+	#else
+		inline bool outermost() const { return false; }
+	#endif
+	};
+public:
+	static constexpr bool enabled() {
+	#ifdef LIB_RATSS_WITH_PROFILING
+		return true;
+	#else
+		return false;
+	#endif
+	}
+	static std::string toString(Stage stage);
+	///@return stats of all threads including threads that already finished
+	static Stats stats();
+	///@return stats of the calling thread
+	static Stats threadStats();
+	///Resetting while other threads are snapping may drop some of their records
+	static void reset();
+public:
+	///cycle counter if available, nanoseconds otherwise
+	static inline uint64_t ticks();
+	static void record(Stage stage, uint64_t ticks);
+	static void recordDenominator(const mpq_class & v);
+private:
+	///the number of snaps of the calling thread that did not return yet
+	static int & depth();
+};
+
+std::ostream & operator<<(std::ostream & out, const Profiler::Stats & stats);
+
+} //end namespace LIB_RATSS_NAMESPACE
+
+//definitions
+
+namespace LIB_RATSS_NAMESPACE {
+
+uint64_t Profiler::ticks() {
+#if defined(LIB_RATSS_WITH_PROFILING) && (defined(__x86_64__) || defined(__i386__))
+	return __rdtsc();
+#else
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+} //end namespace LIB_RATSS_NAMESPACE
+
+#endif
@@ -27,6 +27,13 @@ public:
 public:
 	using ProjectSN::snap;
 	void snap(const mpfr::mpreal& flxs, const mpfr::mpreal& flys, const mpfr::mpreal& flzs, mpq_class& xs, mpq_class& ys, mpq_class& zs, int significands, int snapType = ST_FX | ST_PLANE | ST_NORMALIZE) const;
+	///snaps directly into T_FT without intermediate mpq_class coordinates
+	template<typename T_FT>
+	void snap(const mpfr::mpreal& flxs, const mpfr::mpreal& flys, const mpfr::mpreal& flzs, T_FT& xs, T_FT& ys, T_FT& zs, int significands, int snapType = ST_FX | ST_PLANE | ST_NORMALIZE) const;
+	///snaps with the significands needed for target, see ProjectSN::snap
+	///@return the significands of the result, negated if the result misses the target
+	template<typename T_FT>
+	int snap(const mpfr::mpreal& flxs, const mpfr::mpreal& flys, const mpfr::mpreal& flzs, T_FT& xs, T_FT& ys, T_FT& zs, const Precision & target, int snapType = ST_FX | ST_PLANE | ST_NORMALIZE) const;
 public:
 	///lat and lon are in DEGREE!
 	///This function projects coordinates that are given in spherical coordinates on to the sphere
@@ -38,13 +45,16 @@ public:
 	void projectFromGeo(mpfr::mpreal lat, mpfr::mpreal lon, T_FT &xs, T_FT &ys, T_FT &zs, int precision = -1, int snapType = ST_FX | ST_PLANE | ST_NORMALIZE) const;
 
 	///the same as projectFromGeo except that one can set the desired maximum distance
+	///The significands are derived from maxDist, see ProjectSN::significands
+	///@return the distance of the snapped point to the input point
 	template<typename T_FT>
 	double projectFromGeo(mpfr::mpreal lat, mpfr::mpreal lon, T_FT &xs, T_FT &ys, T_FT &zs, double maxDist, int maxPrecision) const;
 	
 	template<typename T_FT>
 	void projectFromSpherical(mpfr::mpreal theta, mpfr::mpreal phi, T_FT &xs, T_FT &ys, T_FT &zs, int precision = -1, int snapType = ST_FX | ST_PLANE | ST_NORMALIZE) const;
 
-	///the same as projectFromGeo except that one can set the desired maximum distance
+	///the same as projectFromSpherical except that one can set the desired maximum distance
+	///@return the distance of the snapped point to the input point
 	template<typename T_FT>
 	double projectFromSpherical(mpfr::mpreal theta, mpfr::mpreal phi, T_FT &xs, T_FT &ys, T_FT &zs, double maxDist, int maxPrecision) const;
 	
@@ -57,6 +67,13 @@ public:
 	
 public:
 	inline const GeoCalc & calc() const { return m_calc; }
+private:
+	///result = v with the given precision, rationals are rounded into the storage of result
+	template<typename T_FT>
+	static void toMpreal(const T_FT & v, mpfr::mpreal & result, int precision);
+	static void toMpreal(const mpq_class & v, mpfr::mpreal & result, int precision);
+	template<typename T_FT>
+	double distance(const mpfr::mpreal & xf, const mpfr::mpreal & yf, const mpfr::mpreal & zf, const T_FT & xs, const T_FT & ys, const T_FT & zs) const;
 private:
 	GeoCalc m_calc;
 };
@@ -104,6 +121,38 @@ PositionOnSphere ProjectS2::sphere2Plane(const T_FT & xs, const T_FT & ys, const
 	return ProjectSN::sphere2Plane<ConstRefWrapIt, RefWrapIt>(inputBegin, inputEnd, outputBegin, pos);
 }
 
+template<typename T_FT>
+void ProjectS2::snap(const mpfr::mpreal& flxs, const mpfr::mpreal& flys, const mpfr::mpreal& flzs, T_FT& xs, T_FT& ys, T_FT& zs, int significands, int snapType) const {
+	using ConstRefWrap = internal::ReferenceWrapper<const mpfr::mpreal>;
+	using RefWrap = internal::ReferenceWrapper<T_FT>;
+	using ConstRefWrapIt = internal::ReferenceWrapperIterator<ConstRefWrap * >;
+	using RefWrapIt = internal::ReferenceWrapperIterator<RefWrap *>;
+	
+	ConstRefWrap input[3] = { flxs, flys, flzs};
+	RefWrap output[3] = {xs, ys, zs};
+	ConstRefWrapIt inputBegin(input);
+	ConstRefWrapIt inputEnd(input+3);
+	RefWrapIt outputBegin(output);
+	
+	ProjectSN::snap<ConstRefWrapIt, RefWrapIt>(inputBegin, inputEnd, outputBegin, snapType, significands);
+}
+
+template<typename T_FT>
+int ProjectS2::snap(const mpfr::mpreal& flxs, const mpfr::mpreal& flys, const mpfr::mpreal& flzs, T_FT& xs, T_FT& ys, T_FT& zs, const Precision & target, int snapType) const {
+	using ConstRefWrap = internal::ReferenceWrapper<const mpfr::mpreal>;
+	using RefWrap = internal::ReferenceWrapper<T_FT>;
+	using ConstRefWrapIt = internal::ReferenceWrapperIterator<ConstRefWrap * >;
+	using RefWrapIt = internal::ReferenceWrapperIterator<RefWrap *>;
+	
+	ConstRefWrap input[3] = { flxs, flys, flzs};
+	RefWrap output[3] = {xs, ys, zs};
+	ConstRefWrapIt inputBegin(input);
+	ConstRefWrapIt inputEnd(input+3);
+	RefWrapIt outputBegin(output);
+	
+	return ProjectSN::snap<ConstRefWrapIt, RefWrapIt>(inputBegin, inputEnd, outputBegin, snapType, target);
+}
+
 template<typename T_FT>
 void ProjectS2::projectFromGeo(mpfr::mpreal lat, mpfr::mpreal lon, T_FT& xs, T_FT& ys, T_FT& zs, int precision, int snapType) const {
 	if (precision < 0) {
@@ -111,7 +160,6 @@ void ProjectS2::projectFromGeo(mpfr::mpreal lat, mpfr::mpreal lon, T_FT& xs, T_F
 	}
 
 	mpfr::mpreal flxs, flys, flzs;
-	mpq_class xpq, ypq, zpq;
 
 	int tmpPrec = 4*std::max<int>( std::max<int>(lat.getPrecision(), lon.getPrecision()), precision );
 	lat.setPrecision(tmpPrec);
@@ -119,86 +167,21 @@ void ProjectS2::projectFromGeo(mpfr::mpreal lat, mpfr::mpreal lon, T_FT& xs, T_F
 
 	//clip to 3D and snap to sphere
 	m_calc.cartesian(lat, lon, flxs, flys, flzs);
-	snap(flxs, flys, flzs, xpq, ypq, zpq, precision, snapType);
+	snap(flxs, flys, flzs, xs, ys, zs, precision, snapType);
 	
 	assert(!(lat > 0) || zs >= 0);
-	xs = Conversion<T_FT>::moveFrom( std::move(xpq) );
-	ys = Conversion<T_FT>::moveFrom( std::move(ypq) );
-	zs = Conversion<T_FT>::moveFrom( std::move(zpq) );
 }
 
 template<typename T_FT>
 double ProjectS2::projectFromGeo(mpfr::mpreal lat, mpfr::mpreal lon, T_FT &xs, T_FT &ys, T_FT &zs, double maxDist, int maxPrecision) const {
-	int minSqPrec = std::max<int>(maxPrecision, 256);
-	mpfr::mpreal xf, yf, zf, xfs, yfs, zfs, sqd(std::numeric_limits<double>::max());
-	{
-		if (minSqPrec < std::max<int>(lat.getPrecision(), lon.getPrecision())) {
-			m_calc.cartesian(lat, lon, xf, yf, zf);
-		}
-		else {
-			mpfr::mpreal lattmp(lat), lontmp(lon);
-			lattmp.setPrecision(minSqPrec);
-			lontmp.setPrecision(minSqPrec);
-			m_calc.cartesian(lattmp, lontmp, xf, yf, zf);
-		}
-	}
-
-	mpfr::mpreal mD2(m_calc.sq(mpfr::mpreal(maxDist)));
-	
-	//return -1 if prec is too low, 0 if it's okay and 1 if it is too high
-	auto proj = [&, this](int prec) -> int {
-		projectFromGeo(lat, lon, xs, ys, zs, prec);
-		xfs = Conversion<T_FT>::toMpreal(xs, 2*prec);
-		yfs = Conversion<T_FT>::toMpreal(ys, 2*prec);
-		zfs = Conversion<T_FT>::toMpreal(zs, 2*prec);
-		sqd = m_calc.squaredDistance(m_calc.sub(xfs, xf), m_calc.sub(yfs, yf), m_calc.sub(zfs, zf));
-		if (sqd < mD2) {
-			return 1;
-		}
-		else {
-			return -1;
-		}
-	};
-	
-	int lowerPrec = 64;
-	
-	//first try up to 256 bits (which should suffice for 99% of all calls)
-	for (int maxPrec(std::min<int>(256, maxPrecision)); lowerPrec <= maxPrec; lowerPrec += 64) {
-		if (proj(64) == 1) {
-			return m_calc.sqrt(sqd).toDouble();
-		}
-	}
-	
-	//nothing found so far, switch to binary search
-	
-	//we increment in strides of 64 since gmp uses machine-word for mp_limb_t
-	//since this should be used on 64 bit machines we'll use 64 bits here
-	
-	int higherPrec = maxPrecision;
-	int curPrec = (lowerPrec + higherPrec) / 2;
-	curPrec = ((curPrec/64) + (curPrec % 64 == 0 ? 0 : 1))*64;
-	int prevPrec = 0;
-	
-	while (true) {
-		prevPrec = curPrec;
-		int r = proj(curPrec);
-		if (r < 0) { //not good enough
-			lowerPrec = curPrec;
-			curPrec = (lowerPrec + higherPrec) / 2;
-			curPrec = ((curPrec/64) + (curPrec % 64 == 0 ? 0 : 1))*64;
-		}
-		else { //too many bits
-			higherPrec = curPrec;
-			curPrec = (lowerPrec + higherPrec) / 2;
-			curPrec = ((curPrec/64) + (curPrec % 64 == 0 ? 0 : 1))*64;
-		}
-		
-		if (prevPrec == curPrec) {
-			break;
-		}
-	}
+	int tmpPrec = 4*std::max<int>( std::max<int>(lat.getPrecision(), lon.getPrecision()), maxPrecision );
+	lat.setPrecision(tmpPrec);
+	lon.setPrecision(tmpPrec);
 	
-	return m_calc.sqrt(sqd).toDouble();
+	mpfr::mpreal flxs, flys, flzs;
+	m_calc.cartesian(lat, lon, flxs, flys, flzs);
+	snap(flxs, flys, flzs, xs, ys, zs, Precision(2, maxPrecision, maxDist*maxDist));
+	return distance(flxs, flys, flzs, xs, ys, zs);
 }
 
 template<typename T_FT>
@@ -207,7 +190,6 @@ void ProjectS2::projectFromSpherical(mpfr::mpreal theta, mpfr::mpreal phi, T_FT&
 		precision = std::max<int>(theta.getPrecision(), phi.getPrecision());
 	}
 
-	mpq_class xpq, ypq, zpq;
 	mpfr::mpreal flxs, flys, flzs;
 	
 	int tmpPrec = 4*std::max<int>( std::max<int>(theta.getPrecision(), phi.getPrecision()), precision );
@@ -216,51 +198,42 @@ void ProjectS2::projectFromSpherical(mpfr::mpreal theta, mpfr::mpreal phi, T_FT&
 	
 	//clip to 3D and snap to sphere
 	m_calc.cartesianFromSpherical(theta, phi, flxs, flys, flzs);
-	snap(flxs, flys, flzs, xpq, ypq, zpq, precision, snapType);
-	
-	xs = Conversion<T_FT>::moveFrom( std::move(xpq) );
-	ys = Conversion<T_FT>::moveFrom( std::move(ypq) );
-	zs = Conversion<T_FT>::moveFrom( std::move(zpq) );
+	snap(flxs, flys, flzs, xs, ys, zs, precision, snapType);
 }
 
 
 template<typename T_FT>
 double ProjectS2::projectFromSpherical(mpfr::mpreal theta, mpfr::mpreal phi, T_FT &xs, T_FT &ys, T_FT &zs, double maxDist, int maxPrecision) const {
-	int minSqPrec = std::max<int>(maxPrecision, 256);
-	mpfr::mpreal xf, yf, zf, xfs, yfs, zfs, sqd(std::numeric_limits<double>::max());
-	{
-		if (minSqPrec < std::max<int>(theta.getPrecision(), phi.getPrecision())) {
-			m_calc.cartesian(theta, phi, xf, yf, zf);
-		}
-		else {
-			theta.setPrecision(minSqPrec);
-			phi.setPrecision(minSqPrec);
-			m_calc.cartesian(theta, phi, xf, yf, zf);
-		}
-	}
-
-	mpfr::mpreal mD2(m_calc.sq(mpfr::mpreal(maxDist)));
+	int tmpPrec = 4*std::max<int>( std::max<int>(theta.getPrecision(), phi.getPrecision()), maxPrecision );
+	theta.setPrecision(tmpPrec);
+	phi.setPrecision(tmpPrec);
 	
-	//we increment in strides of 64 since gmp uses machine-word for mp_limb_t
-	//since this should be used on 64 bit machines we'll use 64 bits here
-	for(int prec(64); prec < maxPrecision; prec += 64) {
-		projectFromSpherical(theta, phi, xs, ys, zs, prec);
-		xfs = Conversion<T_FT>::toMpreal(xs, minSqPrec);
-		yfs = Conversion<T_FT>::toMpreal(ys, minSqPrec);
-		zfs = Conversion<T_FT>::toMpreal(zs, minSqPrec);
-		sqd = m_calc.squaredDistance(m_calc.sub(xfs, xf), m_calc.sub(yfs, yf), m_calc.sub(zfs, zf));
-		if (sqd < mD2) {
-			break;
-		}
-	}
-	return m_calc.sqrt(sqd).toDouble();
+	mpfr::mpreal flxs, flys, flzs;
+	m_calc.cartesianFromSpherical(theta, phi, flxs, flys, flzs);
+	snap(flxs, flys, flzs, xs, ys, zs, Precision(2, maxPrecision, maxDist*maxDist));
+	return distance(flxs, flys, flzs, xs, ys, zs);
+}
+
+template<typename T_FT>
+void ProjectS2::toMpreal(const T_FT & v, mpfr::mpreal & result, int precision) {
+	result = Conversion<T_FT>::toMpreal(v, precision);
+}
+
+template<typename T_FT>
+double ProjectS2::distance(const mpfr::mpreal & xf, const mpfr::mpreal & yf, const mpfr::mpreal & zf, const T_FT & xs, const T_FT & ys, const T_FT & zs) const {
+	int prec = std::max<int>(std::max<int>(xf.getPrecision(), yf.getPrecision()), zf.getPrecision());
+	mpfr::mpreal xfs(Conversion<T_FT>::toMpreal(xs, prec));
+	mpfr::mpreal yfs(Conversion<T_FT>::toMpreal(ys, prec));
+	mpfr::mpreal zfs(Conversion<T_FT>::toMpreal(zs, prec));
+	return m_calc.sqrt(m_calc.squaredDistance(m_calc.sub(xfs, xf), m_calc.sub(yfs, yf), m_calc.sub(zfs, zf))).toDouble();
 }
 
 template<typename T_FT>
 void ProjectS2::toSpherical(const T_FT & xs, const T_FT & ys, const T_FT & zs, double& theta, double& phi, int precision) const {
-	mpfr::mpreal xr(Conversion<T_FT>::toMpreal(xs, precision));
-	mpfr::mpreal yr(Conversion<T_FT>::toMpreal(ys, precision));
-	mpfr::mpreal zr(Conversion<T_FT>::toMpreal(zs, precision));
+	mpfr::mpreal xr(0, precision), yr(0, precision), zr(0, precision);
+	toMpreal(xs, xr, precision);
+	toMpreal(ys, yr, precision);
+	toMpreal(zs, zr, precision);
 	
 	mpfr::mpreal thetaf, phif;
 	m_calc.spherical(xr, yr, zr, thetaf, phif);
@@ -270,9 +243,10 @@ void ProjectS2::toSpherical(const T_FT & xs, const T_FT & ys, const T_FT & zs, d
 
 template<typename T_FT>
 void ProjectS2::toGeo(const T_FT & xs, const T_FT & ys, const T_FT & zs, double & lat, double & lon, int precision) const {
-	mpfr::mpreal xr(Conversion<T_FT>::toMpreal(xs, precision));
-	mpfr::mpreal yr(Conversion<T_FT>::toMpreal(ys, precision));
-	mpfr::mpreal zr(Conversion<T_FT>::toMpreal(zs, precision));
+	mpfr::mpreal xr(0, precision), yr(0, precision), zr(0, precision);
+	toMpreal(xs, xr, precision);
+	toMpreal(ys, yr, precision);
+	toMpreal(zs, zr, precision);
 	
 	mpfr::mpreal latf, lonf;
 	m_calc.geo(xr, yr, zr, latf, lonf);
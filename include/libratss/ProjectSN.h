@@ -6,11 +6,17 @@
 #include <libratss/Calc.h>
 #include <libratss/enum.h>
 #include <libratss/Conversion.h>
+#include <libratss/Profiler.h>
+#include <libratss/Precision.h>
 
 #include "internal/SkipIterator.h"
 
 #include <assert.h>
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
 namespace LIB_RATSS_NAMESPACE {
@@ -22,7 +28,7 @@ public:
 		
 		ST_SPHERE=0x1, //snap point on sphere
 		ST_PLANE=ST_SPHERE*2, //snap point on plane
-		ST_PAPER=ST_PLANE*2, //snap point on the plane based on a normalized version of the input point, computed using CORE
+		ST_PAPER=ST_PLANE*2, //snap point on the plane based on the normalized input point, rounded to 2*significands bits with certified interval arithmetic
 		
 		ST_CF=0x8, //snap by continous fraction, compatible with values defined in Calc
 		ST_FX=ST_CF*2, //snap by fix point
@@ -55,43 +61,160 @@ public:
 		SnapConfig();
 		SnapConfig(int st, int precision, int significands);
 		SnapConfig(int st, int significands);
+		///variable significands bounded by the distance to the input, see ProjectSN::snap with Precision
+		SnapConfig(int st, const Precision & target);
 		SnapConfig(const SnapConfig & other);
 		SnapConfig & operator=(const SnapConfig & other);
 	public:
 		int snapType() const;
 		int precision(int dimensions) const;
+		///the a priori significands of ProjectSN::significands if target() is not fixed
 		int significands(int dimensions) const;
+		inline const Precision & target() const { return m_target; }
 	private:
 		int m_st;
 		int m_precision;
 		int m_significands;
+		Precision m_target;
+	};
+	///Symmetries of the coordinates that snapping commutes with
+	typedef enum {
+		SY_NONE=0x0,
+		SY_SIGNS=0x1, //sign changes of single coordinates
+		SY_PERMUTATIONS=0x2, //permutations of the coordinates
+		SY_ALL=SY_SIGNS|SY_PERMUTATIONS
+	} SymmetryType;
+	///Sign changes and a permutation of the coordinates of a point.
+	///canonicalize maps a point to its representative in the positive orthant
+	///whose coordinates are sorted by decreasing magnitude, restore maps it back.
+	class Symmetry {
+	public:
+		///@param permute sort the coordinates, otherwise only the signs are changed
+		///[begin, end) may not point to the same storage as out
+		template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+		void canonicalize(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, bool permute = true);
+		///@param begin random access iterator to the coordinates in the canonical order
+		///@param out an iterator accepting T_FT or pointing to a number type with a Conversion if T_FT is mpq_class
+		template<typename T_RANDOM_ACCESS_ITERATOR, typename T_OUTPUT_ITERATOR>
+		void restore(T_RANDOM_ACCESS_ITERATOR begin, T_OUTPUT_ITERATOR out) const;
+	private:
+		///position of the original coordinates in the canonical order
+		std::vector<std::size_t> m_index;
+		std::vector<bool> m_negative;
+	};
+	///Snapping of a single point that can be refined to more significands.
+	///The input is normalized and projected only once.
+	///ST_CF keeps the continued fractions of the coordinates and only computes the additional partial quotients,
+	///ST_FX and ST_FL round the stored coordinates again.
+	///Only ST_CF, ST_FX and ST_FL together with ST_PLANE or ST_SPHERE and optionally ST_NORMALIZE are supported.
+	class Refinement {
+	public:
+		Refinement();
+		///@param begin iterator to the coordinates of type mpfr::mpreal
+		///The precision of the coordinates bounds the significands of refine just like for snap.
+		template<typename T_INPUT_ITERATOR>
+		Refinement(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, int snapType);
+	public:
+		static bool supports(int snapType);
+	public:
+		inline int snapType() const { return m_st; }
+		///the significands of the last call to refine, -1 if there was none
+		inline int significands() const { return m_significands; }
+		inline std::size_t dimension() const { return m_coords.size(); }
+		///Snaps the point with significands, the result is the same as the one of ProjectSN::snap.
+		///Refining to fewer significands than before starts over.
+		///If ST_SPHERE snaps all coordinates to zero, then there is no result like with ProjectSN::snap:
+		///result() and significands() keep the values of the previous call.
+		const std::vector<mpq_class> & refine(int significands);
+		///@param out an iterator accepting mpq_class or pointing to a number type with a Conversion
+		///out is left untouched if there is no result
+		template<typename T_OUTPUT_ITERATOR>
+		void refine(int significands, T_OUTPUT_ITERATOR out);
+		///the result of the last call to refine
+		inline const std::vector<mpq_class> & result() const { return m_result; }
+	private:
+		void init();
+	private:
+		int m_st;
+		int m_significands;
+		///pole of the projection if ST_PLANE is set
+		PositionOnSphere m_pos;
+		///the normalized input if ST_SPHERE is set, otherwise the coordinates on the plane
+		std::vector<mpfr::mpreal> m_coords;
+		///one for every coordinate if ST_CF is set
+		std::vector<ContinuedFraction> m_cf;
+		std::vector<mpq_class> m_result;
 	};
 public:
 	static std::string toString(SnapType st);
+	///the symmetries that snap with snapType commutes with, i.e. snapping a mirrored point gives the mirrored result
+	///ST_SPHERE chooses the projection pole after snapping, so ties between coordinates may depend on their order
+	static int symmetries(int snapType);
+	///The significands needed such that snapping with snapType moves a point on the sphere by at most sqrt(target.maxSquaredDistance).
+	///Every snapped coordinate is off by at most eps = 2^-significands (1.5 eps for ST_FX) and
+	///the inverse stereographic projection at most doubles distances, hence ST_PLANE moves the point by at most 2 eps sqrt(dimensions-1).
+	///ST_SPHERE snaps all coordinates before the projection and moves it by at most 2 eps sqrt(2*dimensions).
+	///@param inputPrecision the precision of the coordinates whose rounding is added to eps
+	///@return target.maxBits if target is fixed, otherwise a value between target.minBits and target.maxBits
+	static int significands(int snapType, const Precision & target, std::size_t dimensions, int inputPrecision);
 public:
+	///@return SP_INVALID if all coordinates are zero
 	template<typename T_FT_ITERATOR>
 	PositionOnSphere positionOnSphere(T_FT_ITERATOR begin, const T_FT_ITERATOR & end) const WARN_UNUSED_RESULT;
 	
 	///Projects the coordinates of begin->end onto new coordinates such that one coordinate is zero
 	///If you want to reproject onto the sphere, then you need to store the return value
 	///[begin, end) may point to the same storage as out
+	///@return SP_INVALID without writing to out if all coordinates are zero
 	template<typename T_FT_INPUT_ITERATOR, typename T_FT_OUTPUT_ITERATOR>
 	PositionOnSphere sphere2Plane(T_FT_INPUT_ITERATOR begin, const T_FT_INPUT_ITERATOR & end, T_FT_OUTPUT_ITERATOR out, PositionOnSphere pos = SP_INVALID) const WARN_UNUSED_RESULT;
 	
+	///If the input is mpq_class then out may point to any number type with a Conversion.
+	///The results are then moved into it by Conversion::moveFrom.
 	template<typename T_FT_INPUT_ITERATOR, typename T_FT_OUTPUT_ITERATOR>
 	void plane2Sphere(T_FT_INPUT_ITERATOR begin, const T_FT_INPUT_ITERATOR & end, PositionOnSphere pos, T_FT_OUTPUT_ITERATOR out) const;
+
+	///Same as sphere2Plane followed by plane2Sphere, the coordinates are replaced by the result.
+	///The round trip is done on integer numerators over a common denominator and each result is canonicalized once.
+	///If the common denominator is much larger than the single ones then the rational operations are used instead.
+	///@return the position that sphere2Plane would return
+	PositionOnSphere sphere2Plane2Sphere(std::vector<mpq_class> & coords) const;
 public:
-	///@param out an iterator accepting mpq_class
+	///@param out an iterator accepting mpq_class or pointing to a number type with a Conversion
+	///If compiled with LIB_RATSS_WITH_PROFILING the stages of each call are recorded by the Profiler
 	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 	void snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands = -1) const;
 	
-	///@param out an iterator accepting mpq_class
+	///@param out an iterator accepting mpq_class or pointing to a number type with a Conversion
 	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 	void snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, const SnapConfig & sc) const;
 	
+	///Snaps with the significands of significands(snapType, target, ...) and verifies the squared distance of the result
+	///to the (normalized) input. Only if this fails the significands are increased by the missing factor of the distance.
+	///@param begin iterator to the coordinates of type mpfr::mpreal
+	///@param out an iterator accepting mpq_class or pointing to a number type with a Conversion
+	///@return the significands of the result, at most target.maxBits and the precision of the input.
+	///The negated significands if even that result is farther than sqrt(target.maxSquaredDistance) from the input.
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	int snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, const Precision & target) const;
+	
+	///Snaps the canonical representative of the input with respect to symmetries(snapType) and maps the result back.
+	///The result is the same as the one of snap, but symmetric inputs share the canonical representative.
+	///@param out an iterator accepting mpq_class or pointing to a number type with a Conversion
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	void snapCanonical(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands = -1) const;
+	
 public:
 	inline const Calc & calc() const { return m_calc; }
 private:
+	///Bounds of an exact grade computed with mpfr.
+	///The exact grades of two candidates are only computed if their bounds overlap.
+	struct GradeBounds {
+		static constexpr int precision = 64;
+		mpfr::mpreal lower;
+		mpfr::mpreal upper;
+		GradeBounds() : lower(0, precision), upper(0, precision) {}
+	};
 	template<typename GRADE_TYPE, int POLICY>
 	struct StOptimizer {
 		const ProjectSN * parent;
@@ -103,10 +226,49 @@ private:
 		int best(const T_ITERATOR & begin, const T_ITERATOR & end) const;
 		template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
 		GRADE_TYPE grade(const T_ITERATOR_INPUT & input_begin, const T_ITERATOR_INPUT & input_end, const T_ITERATOR_OUTPUT & output_begin, const T_ITERATOR_OUTPUT & output_end) const;
+		///the exact grade if GRADE_TYPE is GradeBounds
+		template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
+		mpq_class exactGrade(const T_ITERATOR_INPUT & input_begin, const T_ITERATOR_INPUT & input_end, const T_ITERATOR_OUTPUT & output_begin) const;
+		///true if the candidate has a strictly smaller grade than the best one
+		template<typename T_ITERATOR>
+		bool better(const T_ITERATOR & begin, const T_ITERATOR & end,
+					std::size_t candidateGrade, const std::vector<mpq_class> & candidate,
+					std::size_t bestGrade, const std::vector<mpq_class> & best) const;
+		template<typename T_ITERATOR>
+		bool better(const T_ITERATOR & begin, const T_ITERATOR & end,
+					const GradeBounds & candidateGrade, const std::vector<mpq_class> & candidate,
+					const GradeBounds & bestGrade, const std::vector<mpq_class> & best) const;
 	};
 private:
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	void snapImp(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands) const;
 	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 	void snapNormalized(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands, std::size_t dims) const;
+	///Replaces the coordinates by the snapped coordinates on the plane of the normalized input.
+	///Every coordinate x/(|input| + |pole|) is rounded to nearest with 2*significands bits and then snapped.
+	///The rounding is certified by mpfr intervals whose precision is only increased for coordinates where the ends round differently.
+	///This is an approximation within the bound of CORE's approx(2*significands, 2*significands) the former implementation snapped.
+	PositionOnSphere snapPaper(std::vector<mpq_class> & coords, int snapType, int significands) const;
+private:
+	///*out = v, where v is moved into the number type of out if v is mpq_class and out does not hold mpq_class
+	template<typename T_OUTPUT_ITERATOR, typename T_FT>
+	static void assign(T_OUTPUT_ITERATOR & out, T_FT && v);
+	template<typename T_OUTPUT_ITERATOR, typename T_FT>
+	static void assign(T_OUTPUT_ITERATOR & out, T_FT && v, std::false_type /*convert*/);
+	template<typename T_OUTPUT_ITERATOR>
+	static void assign(T_OUTPUT_ITERATOR & out, mpq_class && v, std::true_type /*convert*/);
+private:
+	///Output iterator that passes the values on to out and records the denominators of the rational ones
+	template<typename T_OUTPUT_ITERATOR>
+	class DenominatorRecorder;
+	///Calls snap(out). If compiled with LIB_RATSS_WITH_PROFILING and this is the outermost snap of the thread
+	///then the call is recorded as PS_SNAP together with the denominators of the values snap writes to out.
+	template<typename T_OUTPUT_ITERATOR, typename T_SNAP>
+	static auto profiled(T_OUTPUT_ITERATOR out, T_SNAP snap) -> decltype(snap(out));
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	int snapTarget(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, const Precision & target) const;
+	template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+	void snapCanonicalImp(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands) const;
 private:
 	template<typename T_FT>
 	inline T_FT add(const T_FT & a, const T_FT & b) const { return calc().add(a,b); }
@@ -151,7 +313,10 @@ PositionOnSphere ProjectSN::positionOnSphere(T_FT_ITERATOR begin, const T_FT_ITE
 			v = -*begin;
 		}
 	}
-	assert(posIndex > 0 && posSign != 0);
+	//the zero point has no position
+	if (posIndex < 0) {
+		return SP_INVALID;
+	}
 	return (PositionOnSphere) (posIndex*posSign);
 }
 
@@ -165,6 +330,9 @@ PositionOnSphere ProjectSN::sphere2Plane(T_FT_INPUT_ITERATOR begin, const T_FT_I
 	}
 	if (pos == SP_INVALID) {
 		pos = positionOnSphere(begin, end);
+		if (pos == SP_INVALID) {
+			return SP_INVALID;
+		}
 	}
 	int projCoord = abs((int) pos); //starts from 1
 	//first get the value of our projection coordinate
@@ -219,59 +387,261 @@ void ProjectSN::plane2Sphere(T_FT_INPUT_ITERATOR begin, const T_FT_INPUT_ITERATO
 	{
 		T_FT_INPUT_ITERATOR it(begin);
 		for(int i(1); i < projCoord; ++i, ++it, ++out) {
-			*out = div<FT>(2 * (*it), denom);
+			assign(out, div<FT>(2 * (*it), denom));
 		}
 		//and the projection coordinate
-		*out = (std::signbit<int>(pos) ? 1 : -1) * div<FT>(denom - 2, denom);
+		assign(out, FT((std::signbit<int>(pos) ? 1 : -1) * div<FT>(denom - 2, denom)));
 		++out;
 		assert(*it == FT(0));
 		++it;
 		//and the rest
 		for( ; it != end; ++it, ++out) {
-			*out = div<FT>(2 * (*it), denom);
+			assign(out, div<FT>(2 * (*it), denom));
 		}
 	}
 }
 
+template<typename T_OUTPUT_ITERATOR>
+class ProjectSN::DenominatorRecorder {
+public:
+	class Proxy {
+	public:
+		explicit Proxy(T_OUTPUT_ITERATOR & out) : m_out(out) {}
+		template<typename T_FT>
+		Proxy & operator=(T_FT && v) {
+			record(v);
+			ProjectSN::assign(m_out, std::forward<T_FT>(v));
+			return *this;
+		}
+	private:
+		static void record(const mpq_class & v) { Profiler::recordDenominator(v); }
+		template<typename T_FT>
+		static void record(const T_FT &) {}
+	private:
+		T_OUTPUT_ITERATOR & m_out;
+	};
+public:
+	explicit DenominatorRecorder(const T_OUTPUT_ITERATOR & out) : m_out(out) {}
+	Proxy operator*() { return Proxy(m_out); }
+	DenominatorRecorder & operator++() {
+		++m_out;
+		return *this;
+	}
+private:
+	T_OUTPUT_ITERATOR m_out;
+};
+
+template<typename T_OUTPUT_ITERATOR, typename T_SNAP>
+auto ProjectSN::profiled(T_OUTPUT_ITERATOR out, T_SNAP snap) -> decltype(snap(out)) {
+#ifdef LIB_RATSS_WITH_PROFILING
+	Profiler::Nesting nesting;
+	if (nesting.outermost()) {
+		Profiler::Scope scope(Profiler::PS_SNAP);
+		return snap(DenominatorRecorder<T_OUTPUT_ITERATOR>(out));
+	}
+#endif
+	return snap(out);
+}
+
 template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands) const {
+	profiled(out, [&](auto o) { this->snapImp(begin, end, o, snapType, significands); });
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, const SnapConfig & sc) const {
+	using std::distance;
+	if (sc.target().fixed) {
+		snap(begin, end, out, sc.snapType(), sc.significands(distance(begin, end)));
+	}
+	else {
+		snap(begin, end, out, sc.snapType(), sc.target());
+	}
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+int ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, const Precision & target) const {
+	return profiled(out, [&](auto o) { return this->snapTarget(begin, end, o, snapType, target); });
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+int ProjectSN::snapTarget(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, const Precision & target) const {
+	if (target.fixed) {
+		snap(begin, end, out, snapType, target.maxBits);
+		return target.maxBits;
+	}
+	std::vector<mpfr::mpreal> input(begin, end);
+	//the distance is measured to the normalized input, normalize only once
+	if (snapType & ST_NORMALIZE) {
+		Profiler::Scope scope(Profiler::PS_NORMALIZE);
+		calc().normalize(input.begin(), input.end(), input.begin());
+		snapType &= ~ST_NORMALIZE;
+	}
+	int inputPrecision = std::numeric_limits<int>::max();
+	for(const mpfr::mpreal & v : input) {
+		inputPrecision = std::min<int>(inputPrecision, v.getPrecision());
+	}
+	int maxSignificands = std::max<int>(target.minBits, std::min<int>(target.maxBits, inputPrecision));
+	int significands = std::min<int>(maxSignificands, ProjectSN::significands(snapType, target, input.size(), inputPrecision));
+	mpq_class maxSquaredDistance(target.maxSquaredDistance);
+	std::vector<mpq_class> result(input.size());
+	while (true) {
+		snap(input.cbegin(), input.cend(), result.begin(), snapType, significands);
+		mpq_class squaredDistance = calc().squaredDistance(result.cbegin(), result.cend(), input.cbegin());
+		if (squaredDistance <= maxSquaredDistance) {
+			break;
+		}
+		if (significands >= maxSignificands) {
+			//no more significands to try, the result misses the target
+			significands = -significands;
+			break;
+		}
+		//the distance is proportional to 2^-significands
+		double missing = std::ceil(0.5*std::log2(squaredDistance.get_d()/target.maxSquaredDistance));
+		significands = std::min<int>(maxSignificands, significands + std::max<int>(1, int(missing)));
+	}
+	for(mpq_class & v : result) {
+		assign(out, std::move(v));
+		++out;
+	}
+	return significands;
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void ProjectSN::snapCanonical(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands) const {
+	profiled(out, [&](auto o) { this->snapCanonicalImp(begin, end, o, snapType, significands); });
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void ProjectSN::snapCanonicalImp(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands) const {
 	using input_ft = typename std::iterator_traits<T_INPUT_ITERATOR>::value_type;
 	using std::distance;
+	int sym = symmetries(snapType);
+	if (sym == SY_NONE) {
+		snap(begin, end, out, snapType, significands);
+		return;
+	}
 	std::size_t dims = distance(begin, end);
-	
-	if (snapType & ST_PAPER) {
-		std::vector<CORE::Expr> ptc(dims);
-		std::vector<mpq_class> pt_snap_plane(dims);
-		
-		std::transform(begin, end, ptc.begin(), [](auto x) -> CORE::Expr { return convert<CORE::Expr>(x); });
-		
-		//normalize input
+	std::vector<input_ft> canonical(dims);
+	Symmetry symmetry;
+	//the squared length depends on the order of the coordinates, hence normalize first
+	if (snapType & ST_NORMALIZE) {
+		std::vector<input_ft> normalized(dims);
 		{
-			CORE::Expr len{0};
-			for(auto & x : ptc) {
-				len += x*x;
-			}
-			len = sqrt(len);
-			for(auto & x : ptc) {
-				x /= len;
-			}
+			Profiler::Scope scope(Profiler::PS_NORMALIZE);
+			calc().normalize(begin, end, normalized.begin());
 		}
-		
-		auto pos = this->sphere2Plane(ptc.begin(), ptc.end(), ptc.begin());
-		
-		//snap points
-		std::transform(ptc.begin(), ptc.end(), pt_snap_plane.begin(), [snapType, significands, this](auto x) -> mpq_class {
-			mpq_class apx = convert<mpq_class>( x.approx(2*significands, 2*significands) );
-			return this->calc().snap(apx, snapType, significands);
+		symmetry.canonicalize(normalized.cbegin(), normalized.cend(), canonical.begin(), sym & SY_PERMUTATIONS);
+		snapType &= ~ST_NORMALIZE;
+	}
+	else {
+		symmetry.canonicalize(begin, end, canonical.begin(), sym & SY_PERMUTATIONS);
+	}
+	std::vector<mpq_class> result(dims);
+	snap(canonical.cbegin(), canonical.cend(), result.begin(), snapType, significands);
+	symmetry.restore(result.begin(), out);
+}
+
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void ProjectSN::Symmetry::canonicalize(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, bool permute) {
+	using std::abs;
+	std::vector<T_INPUT_ITERATOR> coords;
+	for(; begin != end; ++begin) {
+		coords.push_back(begin);
+	}
+	std::vector<std::size_t> order(coords.size());
+	for(std::size_t i(0); i < order.size(); ++i) {
+		order[i] = i;
+	}
+	if (permute) {
+		//stable, so the first of equally large coordinates stays in front, just like in positionOnSphere
+		std::stable_sort(order.begin(), order.end(), [&coords](std::size_t a, std::size_t b) {
+			return abs(*coords[a]) > abs(*coords[b]);
 		});
+	}
+	m_index.resize(coords.size());
+	m_negative.resize(coords.size());
+	for(std::size_t i(0); i < order.size(); ++i, ++out) {
+		const auto & v = *coords[order[i]];
+		m_index[order[i]] = i;
+		m_negative[order[i]] = (v < 0);
+		if (v < 0) {
+			*out = -v;
+		}
+		else {
+			*out = v;
+		}
+	}
+}
+
+template<typename T_RANDOM_ACCESS_ITERATOR, typename T_OUTPUT_ITERATOR>
+void ProjectSN::Symmetry::restore(T_RANDOM_ACCESS_ITERATOR begin, T_OUTPUT_ITERATOR out) const {
+	using value_type = typename std::decay<decltype(*begin)>::type;
+	for(std::size_t i(0); i < m_index.size(); ++i, ++out) {
+		value_type v(*std::next(begin, m_index[i]));
+		if (m_negative[i]) {
+			v = -v;
+		}
+		ProjectSN::assign(out, std::move(v));
+	}
+}
+
+template<typename T_INPUT_ITERATOR>
+ProjectSN::Refinement::Refinement(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, int snapType) :
+m_st(snapType),
+m_significands(-1),
+m_pos(SP_INVALID),
+m_coords(begin, end)
+{
+	if (!supports(snapType)) {
+		throw std::runtime_error("ratss::ProjectSN::Refinement: Unsupported snap type");
+	}
+	ProjectSN proj;
+	if (m_st & ST_NORMALIZE) {
+		Profiler::Scope scope(Profiler::PS_NORMALIZE);
+		proj.calc().normalize(m_coords.begin(), m_coords.end(), m_coords.begin());
+	}
+	if (!(m_st & ST_SPHERE)) {
+		Profiler::Scope scope(Profiler::PS_SPHERE_TO_PLANE);
+		m_pos = proj.sphere2Plane(m_coords.begin(), m_coords.end(), m_coords.begin());
+	}
+	init();
+}
 
-		this->plane2Sphere(pt_snap_plane.begin(), pt_snap_plane.end(), pos, out);
+template<typename T_OUTPUT_ITERATOR>
+void ProjectSN::Refinement::refine(int significands, T_OUTPUT_ITERATOR out) {
+	refine(significands);
+	if (m_significands != significands) {
+		return;
+	}
+	for(const mpq_class & v : m_result) {
+		ProjectSN::assign(out, mpq_class(v));
+		++out;
+	}
+}
+
+//private implementations
+template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
+void ProjectSN::snapImp(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands) const {
+	using input_ft = typename std::iterator_traits<T_INPUT_ITERATOR>::value_type;
+	using std::distance;
+	std::size_t dims = distance(begin, end);
+	
+	if (snapType & ST_PAPER) {
+		std::vector<mpq_class> coords(dims);
+		std::transform(begin, end, coords.begin(), [](const input_ft & x) -> mpq_class { return convert<mpq_class>(x); });
+		PositionOnSphere pos = snapPaper(coords, snapType, significands);
+		Profiler::Scope scope(Profiler::PS_PLANE_TO_SPHERE);
+		this->plane2Sphere(coords.begin(), coords.end(), pos, out);
 	}
 	else {
 		if (snapType & ST_NORMALIZE) {
 			std::vector<input_ft> normalized(dims);
-			calc().normalize(begin, end, normalized.begin());
-			snap(normalized.begin(), normalized.end(), out, snapType & ~ST_NORMALIZE, significands);
+			{
+				Profiler::Scope scope(Profiler::PS_NORMALIZE);
+				calc().normalize(begin, end, normalized.begin());
+			}
+			snapImp(normalized.begin(), normalized.end(), out, snapType & ~ST_NORMALIZE, significands);
 			return;
 		}
 		if (snapType & ST_AUTO) {
@@ -289,11 +659,11 @@ void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITER
 				bestType = optimizer.best(begin, end);
 			}
 			else if (snapType & ST_AUTO_POLICY_MIN_MAX_NORM) {
-				StOptimizer<mpq_class, ST_AUTO_POLICY_MIN_MAX_NORM> optimizer(this, snapType, significands, dims);
+				StOptimizer<GradeBounds, ST_AUTO_POLICY_MIN_MAX_NORM> optimizer(this, snapType, significands, dims);
 				bestType = optimizer.best(begin, end);
 			}
 			else if (snapType & ST_AUTO_POLICY_MIN_SQUARED_DISTANCE) {
-				StOptimizer<mpq_class, ST_AUTO_POLICY_MIN_SQUARED_DISTANCE> optimizer(this, snapType, significands, dims);
+				StOptimizer<GradeBounds, ST_AUTO_POLICY_MIN_SQUARED_DISTANCE> optimizer(this, snapType, significands, dims);
 				bestType = optimizer.best(begin, end);
 			}
 			else {
@@ -307,13 +677,6 @@ void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITER
 	}
 }
 
-template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
-void ProjectSN::snap(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, const SnapConfig & sc) const {
-	using std::distance;
-	snap(begin, end, out, sc.snapType(), sc.significands(distance(begin, end)));
-}
-
-//private implementations
 template<typename T_INPUT_ITERATOR, typename T_OUTPUT_ITERATOR>
 void ProjectSN::snapNormalized(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_OUTPUT_ITERATOR out, int snapType, int significands, std::size_t dims) const {
 	using input_ft = typename std::iterator_traits<T_INPUT_ITERATOR>::value_type;
@@ -322,12 +685,33 @@ void ProjectSN::snapNormalized(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_O
 	PositionOnSphere pos;
 	if (snapType & ST_SPHERE) {
 		std::vector<mpq_class> coords_sphere_pq(dims);
-		calc().toRational(begin, end, coords_sphere_pq.begin(), snapType, significands);
-		pos = sphere2Plane(coords_sphere_pq.begin(), coords_sphere_pq.end(), coords_plane_pq.begin());
+		{
+			Profiler::Scope scope(Profiler::PS_TO_RATIONAL);
+			calc().toRational(begin, end, coords_sphere_pq.begin(), snapType, significands);
+		}
+		{
+			Profiler::Scope scope(Profiler::PS_SPHERE_TO_PLANE_TO_SPHERE);
+			pos = sphere2Plane2Sphere(coords_sphere_pq);
+		}
+		if (pos == SP_INVALID) {
+			return;
+		}
+		for(mpq_class & v : coords_sphere_pq) {
+			assign(out, std::move(v));
+			++out;
+		}
+		return;
 	}
 	else if (snapType & ST_PLANE) {
 		std::vector<input_ft> coords_plane(dims);
-		pos = sphere2Plane(begin, end, coords_plane.begin());
+		{
+			Profiler::Scope scope(Profiler::PS_SPHERE_TO_PLANE);
+			pos = sphere2Plane(begin, end, coords_plane.begin());
+		}
+		if (pos == SP_INVALID) {
+			return;
+		}
+		Profiler::Scope scope(Profiler::PS_TO_RATIONAL);
 		//this fixes the eps guarantee at the cost of 2 more bits. This is independent of the number of bits
 		//The question remains: why?
 // 		if (significands > 0 && snapType & (ST_CF|ST_FX)) {
@@ -350,10 +734,36 @@ void ProjectSN::snapNormalized(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, T_O
 	else {
 		throw std::runtime_error("ratss::ProjectSN::snap: Unsupported snap type");
 	}
+	Profiler::Scope scope(Profiler::PS_PLANE_TO_SPHERE);
 	plane2Sphere(coords_plane_pq.begin(), coords_plane_pq.end(), pos, out);
 }
 
 
+template<typename T_OUTPUT_ITERATOR, typename T_FT>
+void ProjectSN::assign(T_OUTPUT_ITERATOR & out, T_FT && v) {
+	using reference = decltype(*out);
+	using target_type = typename std::decay<reference>::type;
+	using source_type = typename std::decay<T_FT>::type;
+	//proxies like std::back_insert_iterator take whatever they are given
+	using convert = std::integral_constant<bool,
+		std::is_reference<reference>::value &&
+		std::is_same<source_type, mpq_class>::value &&
+		!std::is_same<target_type, mpq_class>::value
+	>;
+	assign(out, std::forward<T_FT>(v), convert());
+}
+
+template<typename T_OUTPUT_ITERATOR, typename T_FT>
+void ProjectSN::assign(T_OUTPUT_ITERATOR & out, T_FT && v, std::false_type) {
+	*out = std::forward<T_FT>(v);
+}
+
+template<typename T_OUTPUT_ITERATOR>
+void ProjectSN::assign(T_OUTPUT_ITERATOR & out, mpq_class && v, std::true_type) {
+	using target_type = typename std::decay<decltype(*out)>::type;
+	*out = Conversion<target_type>::moveFrom(std::move(v));
+}
+
 template<typename GRADE_TYPE, int POLICY>
 ProjectSN::StOptimizer<GRADE_TYPE, POLICY>::StOptimizer(const ProjectSN * _parent, int _snapType, int _significands, std::size_t _dims) :
 parent(_parent),
@@ -367,20 +777,48 @@ template<typename T_ITERATOR>
 int
 ProjectSN::StOptimizer<GRADE_TYPE, POLICY>::best(const T_ITERATOR & begin, const T_ITERATOR & end) const {
 	constexpr std::array<int, ST__INTERNAL_NUMBER_OF_SNAPPING_TYPES> snappingType = {{ST_FL, ST_FX, ST_CF, ST_JP, ST_FPLLL}};
-	std::vector<mpq_class> tmp(dims);
-	GRADE_TYPE bestGrade = GRADE_TYPE(std::numeric_limits<std::size_t>::max());
-	int bestType = ST_FX;
+	std::vector<mpq_class> tmp(dims), bestResult(dims);
+	GRADE_TYPE bestGrade = GRADE_TYPE();
+	int bestType = ST_NONE;
 	for(int st : snappingType) {
 		if ((st << ST__INTERNAL_NUMBER_OF_SNAPPING_TYPES) & snapType) {
+			Profiler::Scope scope(Profiler::PS_AUTO_CANDIDATE);
 			parent->snapNormalized(begin, end, tmp.begin(), (snapType & ~ST__INTERNAL_AUTO_ALL_WITH_POLICY) | st, significands, dims);
 			GRADE_TYPE myGrade = grade(begin, end, tmp.begin(), tmp.end());
-			if (bestGrade > myGrade) {
-				bestGrade = myGrade;
+			if (bestType == ST_NONE || better(begin, end, myGrade, tmp, bestGrade, bestResult)) {
+				bestGrade = std::move(myGrade);
+				bestResult.swap(tmp);
 				bestType = st;
 			}
 		}
 	}
-	return bestType;
+	return (bestType == ST_NONE ? ST_FX : bestType);
+}
+
+template<typename GRADE_TYPE, int POLICY>
+template<typename T_ITERATOR>
+bool
+ProjectSN::StOptimizer<GRADE_TYPE, POLICY>::better(const T_ITERATOR & /*begin*/, const T_ITERATOR & /*end*/,
+	std::size_t candidateGrade, const std::vector<mpq_class> & /*candidate*/,
+	std::size_t bestGrade, const std::vector<mpq_class> & /*best*/) const
+{
+	return bestGrade > candidateGrade;
+}
+
+template<typename GRADE_TYPE, int POLICY>
+template<typename T_ITERATOR>
+bool
+ProjectSN::StOptimizer<GRADE_TYPE, POLICY>::better(const T_ITERATOR & begin, const T_ITERATOR & end,
+	const GradeBounds & candidateGrade, const std::vector<mpq_class> & candidate,
+	const GradeBounds & bestGrade, const std::vector<mpq_class> & best) const
+{
+	if (candidateGrade.upper < bestGrade.lower) {
+		return true;
+	}
+	if (candidateGrade.lower >= bestGrade.upper || candidate == best) {
+		return false;
+	}
+	return exactGrade(begin, end, best.cbegin()) > exactGrade(begin, end, candidate.cbegin());
 }
 
 template<>
@@ -409,17 +847,37 @@ grade(const T_ITERATOR_INPUT & /*input_begin*/, const T_ITERATOR_INPUT & /*input
 
 template<>
 template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
-mpq_class
-ProjectSN::StOptimizer<mpq_class, ProjectSN::ST_AUTO_POLICY_MIN_SQUARED_DISTANCE>::
+ProjectSN::GradeBounds
+ProjectSN::StOptimizer<ProjectSN::GradeBounds, ProjectSN::ST_AUTO_POLICY_MIN_SQUARED_DISTANCE>::
 grade(const T_ITERATOR_INPUT & input_begin, const T_ITERATOR_INPUT & input_end, const T_ITERATOR_OUTPUT & output_begin, const T_ITERATOR_OUTPUT & /*output_end*/) const {
-	return parent->calc().squaredDistance(input_begin, input_end, output_begin);
+	GradeBounds result;
+	parent->calc().squaredDistance(input_begin, input_end, output_begin, result.lower, result.upper);
+	return result;
 }
 
 template<>
 template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
 mpq_class
-ProjectSN::StOptimizer<mpq_class, ProjectSN::ST_AUTO_POLICY_MIN_MAX_NORM>::
+ProjectSN::StOptimizer<ProjectSN::GradeBounds, ProjectSN::ST_AUTO_POLICY_MIN_SQUARED_DISTANCE>::
+exactGrade(const T_ITERATOR_INPUT & input_begin, const T_ITERATOR_INPUT & input_end, const T_ITERATOR_OUTPUT & output_begin) const {
+	return parent->calc().squaredDistance(input_begin, input_end, output_begin);
+}
+
+template<>
+template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
+ProjectSN::GradeBounds
+ProjectSN::StOptimizer<ProjectSN::GradeBounds, ProjectSN::ST_AUTO_POLICY_MIN_MAX_NORM>::
 grade(const T_ITERATOR_INPUT & input_begin, const T_ITERATOR_INPUT & input_end, const T_ITERATOR_OUTPUT & output_begin, const T_ITERATOR_OUTPUT & /*output_end*/) const {
+	GradeBounds result;
+	parent->calc().maxNorm(input_begin, input_end, output_begin, result.lower, result.upper);
+	return result;
+}
+
+template<>
+template<typename T_ITERATOR_INPUT, typename T_ITERATOR_OUTPUT>
+mpq_class
+ProjectSN::StOptimizer<ProjectSN::GradeBounds, ProjectSN::ST_AUTO_POLICY_MIN_MAX_NORM>::
+exactGrade(const T_ITERATOR_INPUT & input_begin, const T_ITERATOR_INPUT & input_end, const T_ITERATOR_OUTPUT & output_begin) const {
 	return parent->calc().maxNorm(input_begin, input_end, output_begin);
 }
 
@@ -0,0 +1,96 @@
+#ifndef LIB_RATSS_PROJECT_SN_BATCH_H
+#define LIB_RATSS_PROJECT_SN_BATCH_H
+#pragma once
+
+#include <libratss/constants.h>
+#include <libratss/ProjectSN.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace LIB_RATSS_NAMESPACE {
+
+///Projection of many points with double coordinates stored as structure of arrays:
+///coordinate i of point j is coords(i)[j].
+///positionOnSphere and sphere2Plane run over whole rows of a coordinate without branches so that the compiler can vectorize them.
+///Their results are the same as the ones of ProjectSN::positionOnSphere and ProjectSN::sphere2Plane with double.
+class ProjectSNBatch {
+public:
+	explicit ProjectSNBatch(int dimension);
+public:
+	inline int dimension() const { return int(m_coords.size()); }
+	inline std::size_t size() const { return m_size; }
+	///invalidates the projection
+	void resize(std::size_t size);
+	inline double * coords(int i) { return m_coords[i].data(); }
+	inline const double * coords(int i) const { return m_coords[i].data(); }
+	///sets the coordinates of point j from dimension() values
+	template<typename T_INPUT_ITERATOR>
+	void set(std::size_t j, T_INPUT_ITERATOR begin);
+public:
+	///computes the positions and the coordinates on the plane of all points
+	void sphere2Plane();
+	///SP_INVALID if all coordinates of point j are zero
+	inline PositionOnSphere pos(std::size_t j) const { return PositionOnSphere(m_pos[j]); }
+	inline const double * plane(int i) const { return m_plane[i].data(); }
+	///indices of the points grouped by their position on the sphere
+	inline const std::vector<uint32_t> & order() const { return m_order; }
+public:
+	///Snaps the coordinates on the plane and projects them back onto the sphere.
+	///The points are processed grouped by their position, the result of a point is the same as the one of
+	///ProjectSN::snap with its coordinates as mpfr::mpreal of precision 53.
+	///@param snapType ST_PLANE with one of ST_CF, ST_FX and ST_FL
+	///@param out random access iterator, point j is written to out+j*dimension(), invalid points are skipped
+	template<typename T_RANDOM_ACCESS_ITERATOR>
+	void snap(T_RANDOM_ACCESS_ITERATOR out, int snapType, int significands) const;
+private:
+	static void checkSnapType(int snapType);
+private:
+	std::size_t m_size;
+	std::vector< std::vector<double> > m_coords;
+	std::vector< std::vector<double> > m_plane;
+	///1 + the largest absolute value of a coordinate of each point
+	std::vector<double> m_denom;
+	std::vector<int32_t> m_pos;
+	std::vector<uint32_t> m_order;
+};
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+//definitions
+
+namespace LIB_RATSS_NAMESPACE {
+
+template<typename T_INPUT_ITERATOR>
+void ProjectSNBatch::set(std::size_t j, T_INPUT_ITERATOR begin) {
+	for(std::vector<double> & row : m_coords) {
+		row[j] = *begin;
+		++begin;
+	}
+}
+
+template<typename T_RANDOM_ACCESS_ITERATOR>
+void ProjectSNBatch::snap(T_RANDOM_ACCESS_ITERATOR out, int snapType, int significands) const {
+	checkSnapType(snapType);
+	ProjectSN proj;
+	std::vector<mpq_class> planePoint(dimension());
+	mpfr::mpreal tmp(0, 53);
+	for(uint32_t j : m_order) {
+		if (m_pos[j] == SP_INVALID) {
+			continue;
+		}
+		{
+			Profiler::Scope scope(Profiler::PS_TO_RATIONAL);
+			for(int i(0), s(dimension()); i < s; ++i) {
+				tmp = m_plane[i][j];
+				planePoint[i] = proj.calc().snap(tmp, snapType, significands);
+			}
+		}
+		Profiler::Scope scope(Profiler::PS_PLANE_TO_SPHERE);
+		proj.plane2Sphere(planePoint.begin(), planePoint.end(), pos(j), out + j*dimension());
+	}
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef LIB_RATSS_SNAP_SIZE_H
+#define LIB_RATSS_SNAP_SIZE_H
+#pragma once
+
+#include <libratss/constants.h>
+#include <libratss/ProjectSN.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace LIB_RATSS_NAMESPACE {
+
+///Prediction of the bit sizes of the coordinates computed by ProjectSN::snap without snapping.
+///This allows to choose the number type of a point before snapping it, e.g. ExtendedInt64q if all bits fit into 63.
+///The coordinates on the sphere are at most 1 in magnitude, hence their numerators are never larger than their denominators.
+class SnapSize {
+public:
+	///Bits of the largest numerator and of the largest denominator of the coordinates of a point, -1 if there is no bound
+	struct Bits {
+		Bits() : numerator(0), denominator(0) {}
+		Bits(int _numerator, int _denominator) : numerator(_numerator), denominator(_denominator) {}
+		static inline Bits unbounded() { return Bits(-1, -1); }
+		inline bool bounded() const { return numerator >= 0 && denominator >= 0; }
+		///the larger bit size, -1 if unbounded
+		inline int max() const { return (bounded() ? std::max(numerator, denominator) : -1); }
+		///true if numerators and denominators fit into integers with bits bits, e.g. 63 for int64_t
+		inline bool fits(int bits) const { return bounded() && max() <= bits; }
+		int numerator;
+		int denominator;
+	};
+	///Histogram of the bit sizes of points, e.g. of a sample of a data set.
+	///Points are counted by Bits::max(), unbounded ones separately.
+	class Distribution {
+	public:
+		Distribution();
+	public:
+		void add(const Bits & bits);
+		inline std::size_t size() const { return m_size; }
+		inline std::size_t unbounded() const { return m_unbounded; }
+		///number of points whose larger bit size is bits
+		std::size_t count(int bits) const;
+		///the fraction of the points that fit into bits bits
+		double fraction(int bits) const;
+		///the smallest bits such that fraction(bits) >= q, -1 if this includes unbounded points
+		int quantile(double q) const;
+		///the largest bits of the points
+		inline const Bits & max() const { return m_max; }
+	private:
+		std::vector<std::size_t> m_count;
+		std::size_t m_size;
+		std::size_t m_unbounded;
+		Bits m_max;
+	};
+public:
+	SnapSize();
+public:
+	inline const ProjectSN & proj() const { return m_proj; }
+	///Bounds for every point with dimensions coordinates snapped with sc.
+	///If sc.target() is not fixed then the bounds hold for target().maxBits.
+	///ST_PLANE and ST_PAPER hold for every point, ST_SPHERE for points on the unit sphere.
+	///ST_FL and ST_JP keep small coordinates with all their bits, they are only bounded for a given point.
+	///ST_FPLLL is not bounded and ST_AUTO is bounded by the largest bound of its candidates.
+	static Bits bound(const ProjectSN::SnapConfig & sc, int dimensions);
+	///Bounds for the point [begin, end) snapped with sc.
+	///The point is only normalized and projected onto the plane, ST_FL and ST_JP are bounded by the exponents of the coordinates.
+	///The bound of ST_JP is the size of the exact input which is coarse, use sample if the actual sizes matter.
+	///The zero point has no snapped result and is unbounded.
+	///@param begin iterator to the coordinates of type mpfr::mpreal
+	template<typename T_INPUT_ITERATOR>
+	Bits bound(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, const ProjectSN::SnapConfig & sc) const;
+	///the bits of the snapped point [begin, end) of type mpq_class
+	template<typename T_ITERATOR>
+	static Bits bits(T_ITERATOR begin, const T_ITERATOR & end);
+	///Snaps every point of a sample with sc and records the bits of the results
+	///@param begin iterator to points, i.e. containers of mpfr::mpreal
+	template<typename T_POINT_ITERATOR>
+	Distribution sample(T_POINT_ITERATOR begin, T_POINT_ITERATOR end, const ProjectSN::SnapConfig & sc) const;
+private:
+	///a coordinate that is snapped
+	struct Coordinate {
+		bool zero;
+		long exponent;
+		long precision;
+		///an upper bound of the absolute value
+		double magnitude;
+	};
+	///the snapping types, i.e. the candidates of ST_AUTO
+	static int snapTypes(int snapType);
+	static int significands(const ProjectSN::SnapConfig & sc, int dimensions);
+	///@param coords the snapped coordinates, nullptr if the bound should hold for every point
+	static Bits bound(int snapType, int significands, int dimensions, const std::vector<Coordinate> * coords);
+	///log2 of a bound of the common denominator of the snapped coordinates, -1 if unbounded
+	static long denominatorBits(int st, int snapType, int significands, int count, const std::vector<Coordinate> * coords);
+	template<typename T_ITERATOR>
+	static void describe(T_ITERATOR begin, const T_ITERATOR & end, std::vector<Coordinate> & coords);
+private:
+	ProjectSN m_proj;
+};
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+//definitions
+
+namespace LIB_RATSS_NAMESPACE {
+
+template<typename T_INPUT_ITERATOR>
+SnapSize::Bits SnapSize::bound(T_INPUT_ITERATOR begin, T_INPUT_ITERATOR end, const ProjectSN::SnapConfig & sc) const {
+	int snapType = sc.snapType();
+	std::vector<mpfr::mpreal> input(begin, end);
+	int dims = int(input.size());
+	int sig = significands(sc, dims);
+	//snap does not write the zero point, it has no position on the sphere
+	if (std::all_of(input.cbegin(), input.cend(), [](const mpfr::mpreal & v) { return mpfr::iszero(v); })) {
+		return Bits::unbounded();
+	}
+	//ST_PAPER normalizes exactly, the approximation is covered by the bounds
+	if (snapType & (ProjectSN::ST_NORMALIZE | ProjectSN::ST_PAPER)) {
+		proj().calc().normalize(input.begin(), input.end(), input.begin());
+	}
+	std::vector<Coordinate> coords;
+	coords.reserve(dims);
+	if ((snapType & ProjectSN::ST_SPHERE) && !(snapType & ProjectSN::ST_PAPER)) {
+		if (proj().positionOnSphere(input.begin(), input.end()) == SP_INVALID) {
+			return Bits::unbounded();
+		}
+		describe(input.cbegin(), input.cend(), coords);
+	}
+	else {
+		std::vector<mpfr::mpreal> plane(dims);
+		PositionOnSphere pos = proj().sphere2Plane(input.begin(), input.end(), plane.begin());
+		if (pos == SP_INVALID) {
+			return Bits::unbounded();
+		}
+		//the projection coordinate is zero on the plane and not snapped
+		plane.erase(plane.begin() + (std::abs(int(pos))-1));
+		describe(plane.cbegin(), plane.cend(), coords);
+	}
+	return bound(snapType, sig, dims, &coords);
+}
+
+template<typename T_ITERATOR>
+SnapSize::Bits SnapSize::bits(T_ITERATOR begin, const T_ITERATOR & end) {
+	Bits result;
+	for(; begin != end; ++begin) {
+		result.numerator = std::max<int>(result.numerator, int(::mpz_sizeinbase(begin->get_num().get_mpz_t(), 2)));
+		result.denominator = std::max<int>(result.denominator, int(::mpz_sizeinbase(begin->get_den().get_mpz_t(), 2)));
+	}
+	return result;
+}
+
+template<typename T_POINT_ITERATOR>
+SnapSize::Distribution SnapSize::sample(T_POINT_ITERATOR begin, T_POINT_ITERATOR end, const ProjectSN::SnapConfig & sc) const {
+	Distribution result;
+	std::vector<mpq_class> snapped;
+	for(; begin != end; ++begin) {
+		//snap does not write invalid points
+		if (std::all_of(begin->begin(), begin->end(), [](const mpfr::mpreal & v) { return mpfr::iszero(v); })) {
+			continue;
+		}
+		snapped.resize(begin->size());
+		proj().snap(begin->begin(), begin->end(), snapped.begin(), sc);
+		result.add(bits(snapped.cbegin(), snapped.cend()));
+	}
+	return result;
+}
+
+template<typename T_ITERATOR>
+void SnapSize::describe(T_ITERATOR begin, const T_ITERATOR & end, std::vector<Coordinate> & coords) {
+	for(; begin != end; ++begin) {
+		const mpfr::mpreal & v = *begin;
+		Coordinate c;
+		c.zero = mpfr_zero_p(v.mpfr_srcptr());
+		c.exponent = (c.zero ? 0 : long(mpfr_get_exp(v.mpfr_srcptr())));
+		c.precision = long(v.getPrecision());
+		c.magnitude = std::abs(v.toDouble());
+		coords.push_back(c);
+	}
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+#endif
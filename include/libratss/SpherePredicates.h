@@ -0,0 +1,73 @@
+#ifndef LIB_RATSS_SPHERE_PREDICATES_H
+#define LIB_RATSS_SPHERE_PREDICATES_H
+#pragma once
+
+#include <libratss/constants.h>
+#include <array>
+#include <cstdint>
+#include <gmpxx.h>
+
+namespace LIB_RATSS_NAMESPACE {
+
+///Point on the unit sphere in homogeneous integer coordinates (x/w, y/w, z/w) with w > 0
+///This is the representation of snapped points with a common denominator.
+///The double and machine word versions of the coordinates are computed once on construction.
+///The constructors do not check that the point is on the sphere, see isOnSphere().
+class SpherePoint {
+public:
+	SpherePoint();
+	SpherePoint(const mpz_class & x, const mpz_class & y, const mpz_class & z, const mpz_class & w);
+	///w is the least common multiple of the denominators
+	SpherePoint(const mpq_class & x, const mpq_class & y, const mpq_class & z);
+public:
+	inline const mpz_class & x() const { return m_c[0]; }
+	inline const mpz_class & y() const { return m_c[1]; }
+	inline const mpz_class & z() const { return m_c[2]; }
+	inline const mpz_class & w() const { return m_c[3]; }
+	///maximum number of bits of the coordinates
+	inline int bits() const { return m_bits; }
+	///true if x^2 + y^2 + z^2 == w^2
+	bool isOnSphere() const;
+private:
+	friend class SpherePredicates;
+	void init();
+private:
+	std::array<mpz_class, 4> m_c;
+	///coordinates truncated to double
+	std::array<double, 4> m_d;
+	///only valid if m_bits <= 63
+	std::array<int64_t, 4> m_i;
+	int m_bits;
+};
+
+///Exact predicates on snapped points on the unit sphere.
+///Every predicate tries a static double filter, whose error bound only depends on the bit size of the coordinates,
+///then exact 128 bit integer arithmetic if all coordinates fit into 63 bits and gmp only as a last resort.
+///Points snapped with ST_FX | ST_PLANE and significands <= 31 never need gmp.
+class SpherePredicates {
+public:
+	///largest coordinate bit size handled by the machine word stage
+	static constexpr int MAX_WORD_BITS = 63;
+	enum Stage : int {
+		S_DOUBLE=0,
+		S_INT128=1,
+		S_GMP=2,
+		S_NUM_STAGES=3
+	};
+public:
+	///sign of det(p, q, r), positive if p, q, r are counterclockwise seen from outside the sphere
+	static int orientation(const SpherePoint & p, const SpherePoint & q, const SpherePoint & r);
+	///positive if p is to the left of the great circle from a to b seen from outside the sphere, zero if p is on it
+	static int sideOfGreatCircle(const SpherePoint & a, const SpherePoint & b, const SpherePoint & p);
+	///positive if s is inside the circle through p, q, r where inside is the spherical cap to the left of p, q, r
+	///zero if s is on the circle
+	///All points have to be on the sphere which is asserted in debug builds.
+	static int inCircle(const SpherePoint & p, const SpherePoint & q, const SpherePoint & r, const SpherePoint & s);
+public:
+	///the stage that decided the last predicate of the calling thread
+	static Stage lastStage();
+};
+
+}//end namespace LIB_RATSS_NAMESPACE
+
+#endif
@@ -4,6 +4,8 @@
 
 #include <libratss/constants.h>
 #include <libratss/GeoCalc.h>
+#include <libratss/util/Tokenizer.h>
+#include <libratss/util/OutputBuffer.h>
 
 namespace LIB_RATSS_NAMESPACE {
 
@@ -25,6 +27,8 @@ struct FloatPoint: PointBase {
 	void normalize();
 	void setPrecision(int precision);
 	void assign(std::istream& is, ratss::PointBase::Format fmt, int precision, int dimension = -1);
+	///reads the next point of the current line
+	void assign(Tokenizer & tokenizer, Format fmt, int precision, int dimension = -1);
 	template<typename T_ITERATOR>
 	void assign(const T_ITERATOR & begin, const T_ITERATOR & end, int precision) {
 		coords.clear();
@@ -64,7 +68,11 @@ struct RationalPoint: PointBase {
 	void clear();
 	void resize(std::size_t _n);
 	void assign(std::istream & is, Format fmt, int precision, int dimension = -1);
+	///reads the next point of the current line
+	void assign(Tokenizer & tokenizer, Format fmt, int precision, int dimension = -1);
 	void print(std::ostream & out, Format fmt) const;
+	///rational formats are written directly, all others go through out.stream()
+	void print(OutputBuffer & out, Format fmt) const;
 	bool valid() const;
 };
 
@@ -0,0 +1,48 @@
+#ifndef LIB_RATSS_UTIL_OUTPUT_BUFFER_H
+#define LIB_RATSS_UTIL_OUTPUT_BUFFER_H
+#pragma once
+
+#include <libratss/constants.h>
+
+#include <gmpxx.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace LIB_RATSS_NAMESPACE {
+
+///Buffered writer for point files.
+///Numbers are converted directly into a large buffer which is handed to the stream buffer in one piece.
+///The output is the same as writing to a std::ostream with default formatting flags.
+///Since it buffers, the stream should not be written to by anyone else unless flush() was called.
+class OutputBuffer {
+public:
+	static constexpr std::size_t DEFAULT_BUFFER_SIZE = 1 << 20;
+public:
+	explicit OutputBuffer(std::ostream & out, std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+	OutputBuffer(const OutputBuffer & other) = delete;
+	OutputBuffer & operator=(const OutputBuffer & other) = delete;
+	///flushes the buffer
+	~OutputBuffer();
+public:
+	std::ostream & stream();
+	///writes the buffer to the stream, sets badbit on the stream if this fails
+	void flush();
+	void put(char c);
+	void write(const char * str, std::size_t size);
+	void write(const std::string & str);
+	void write(const mpz_class & v);
+	///writes num/den or just num if den is 1
+	void write(const mpq_class & v);
+private:
+	///makes sure that there is space for size more characters
+	inline void reserve(std::size_t size);
+private:
+	std::ostream * m_out;
+	std::vector<char> m_buf;
+	std::size_t m_size;
+};
+
+} //end namespace LIB_RATSS_NAMESPACE
+
+#endif
@@ -45,17 +45,17 @@ void FileReader::visit(T_VISITOR visitor) {
 	}
 	std::size_t counter = 0;
 
-	while( io.input().good() ) {
-		for( ; io.input().good() && io.input().peek() == '\n'; ) {
-			io.input().get();
+	Tokenizer tokenizer(io.input());
+	while( tokenizer.good() ) {
+		while (tokenizer.newline()) {
 			io.output().put('\n');
 		}
-		if (!io.input().good()) {
+		if (!tokenizer.good()) {
 			break;
 		}
 		bool opFromIp = !cfg.rationalPassThrough;
 		if (cfg.rationalPassThrough) {
-			op.assign(io.input(), cfg.inFormat, cfg.precision);
+			op.assign(tokenizer, cfg.inFormat, cfg.precision);
 			if (!op.valid()) {
 				if (!cfg.normalize) {
 					std::cerr << "Input point read that is not on sphere but no normalization was requested" << std::endl;
@@ -67,7 +67,7 @@ void FileReader::visit(T_VISITOR visitor) {
 			}
 		}
 		else {
-			ip.assign(io.input(), cfg.inFormat, cfg.precision);
+			ip.assign(tokenizer, cfg.inFormat, cfg.precision);
 		}
 		
 		if (opFromIp) {
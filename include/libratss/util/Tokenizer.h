@@ -0,0 +1,65 @@
+#ifndef LIB_RATSS_UTIL_TOKENIZER_H
+#define LIB_RATSS_UTIL_TOKENIZER_H
+#pragma once
+
+#include <libratss/constants.h>
+#include <libratss/mpreal.h>
+
+#include <gmpxx.h>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace LIB_RATSS_NAMESPACE {
+
+///Buffered whitespace tokenizer for point files.
+///Reads large blocks from the underlying stream and parses numbers directly out of the buffer.
+///Tokens are separated by spaces, tabs or carriage returns, lines by '\n'.
+///Since it reads ahead the stream should not be used by anyone else while the tokenizer is in use.
+class Tokenizer {
+public:
+	static constexpr std::size_t DEFAULT_BUFFER_SIZE = 1 << 20;
+public:
+	explicit Tokenizer(std::istream & in, std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+	///tokenize data
+	explicit Tokenizer(const std::string & data);
+	Tokenizer(const Tokenizer & other) = delete;
+	Tokenizer & operator=(const Tokenizer & other) = delete;
+	~Tokenizer();
+public:
+	///@return true if there is input left
+	bool good();
+	///@return the next character without consuming it or EOF
+	int peek();
+	///Skips blanks, but not newlines
+	///@return true if there are no more tokens in the current line
+	bool lineEnd();
+	///Skips blanks and consumes a newline if it is the next character
+	bool newline();
+	///@return the next token of the current line as null-terminated string or 0 if there is none
+	///The token is valid until the next call to any function of the tokenizer
+	const char * token();
+public:
+	///All read functions throw a std::runtime_error if the next token is not a valid number
+	void read(mpz_class & v);
+	void read(mpq_class & v);
+	///v is rounded to its current precision
+	void read(mpfr::mpreal & v);
+private:
+	///restores the character overwritten by the terminating null of the last token
+	inline void restore();
+	///@return false if no more data is available
+	bool fill();
+	const char * nextToken(const char * what);
+private:
+	std::istream * m_in;
+	std::vector<char> m_buf;
+	std::size_t m_begin;
+	std::size_t m_end;
+	char m_saved;
+	bool m_hasSaved;
+};
+
+} //end namespace LIB_RATSS_NAMESPACE
+
+#endif
@@ -3,6 +3,20 @@
 #include <libratss/types.h>
 
 namespace LIB_RATSS_NAMESPACE {
+namespace {
+
+///true if the canonical v fits into the 64 bit representation of T_EI64Q
+template<typename T_EI64Q>
+bool toPq(const mpq_class & v, typename T_EI64Q::PQ & pq) {
+	if (!::mpz_fits_slong_p(v.get_num_mpz_t()) || !::mpz_fits_slong_p(v.get_den_mpz_t())) {
+		return false;
+	}
+	pq.num = ::mpz_get_si(v.get_num_mpz_t());
+	pq.den = ::mpz_get_si(v.get_den_mpz_t());
+	return true;
+}
+
+} //end namespace
 
 //BEGIN CGAL::internal::boost_int1024q specilizations
 
@@ -26,6 +40,10 @@ Conversion<CGAL::internal::boost_int1024q>::toMpreal(const type & v, int precisi
 
 Conversion<CGAL::ExtendedInt64q<CGAL::internal::boost_int1024q>>::type
 Conversion<CGAL::ExtendedInt64q<CGAL::internal::boost_int1024q>>::moveFrom(const mpq_class & v) {
+	type::PQ pq;
+	if (toPq<type>(v, pq)) {
+		return type(pq);
+	}
 	return CGAL::ExtendedInt64q<CGAL::internal::boost_int1024q>(
 		Conversion<CGAL::ExtendedInt64q<CGAL::internal::boost_int1024q>::extension_type>::moveFrom(v)
 	);
@@ -36,6 +54,9 @@ Conversion< CGAL::ExtendedInt64q<CGAL::internal::boost_int1024q> >::toMpq(const
 	if (v.isExtended()) {
 		return Conversion<CGAL::ExtendedInt64q<CGAL::internal::boost_int1024q>::extension_type>::toMpq( v.getExtended() );
 	}
+	else if (v.isInt128()) {
+		return Conversion<CGAL::ExtendedInt64q<CGAL::internal::boost_int1024q>::extension_type>::toMpq( v.asExtended() );
+	}
 	else {
 		return mpq_class(
 			gmp_int64_t(v.numerator().get()), 
@@ -65,18 +86,121 @@ Conversion< CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q<CGAL::internal::boost_int1
 }
 
 //END CGAL::ExtendedInt64q<CGAL::internal::boost_int1024q> specilizations
+#ifdef LIB_RATSS_WITH_FIXED_RATIONAL
+//BEGIN CGAL::FixedRational specilizations
+
+template<int T_BITS>
+typename Conversion< CGAL::FixedRational<T_BITS> >::type
+Conversion< CGAL::FixedRational<T_BITS> >::moveFrom(const mpq_class & v) {
+	return type(v.get_mpq_t());
+}
+
+template<int T_BITS>
+mpq_class
+Conversion< CGAL::FixedRational<T_BITS> >::toMpq(const type & v) {
+	mpq_t view;
+	return mpq_class(v.mpq(view));
+}
+
+template<int T_BITS>
+mpfr::mpreal
+Conversion< CGAL::FixedRational<T_BITS> >::toMpreal(const type & v, int precision) {
+	mpq_t view;
+	return mpfr::mpreal(v.mpq(view), precision);
+}
+
+template<int T_BITS>
+typename Conversion< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > >::type
+Conversion< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > >::moveFrom(const mpq_class & v) {
+	typename type::PQ pq;
+	if (toPq<type>(v, pq)) {
+		return type(pq);
+	}
+	return type( Conversion< CGAL::FixedRational<T_BITS> >::moveFrom(v) );
+}
+
+template<int T_BITS>
+mpq_class
+Conversion< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > >::toMpq(const type & v) {
+	if (v.isExtended()) {
+		return Conversion< CGAL::FixedRational<T_BITS> >::toMpq( v.getExtended() );
+	}
+	else if (v.isInt128()) {
+		return Conversion< CGAL::FixedRational<T_BITS> >::toMpq( v.asExtended() );
+	}
+	else {
+		return mpq_class(
+			gmp_int64_t(v.numerator().get()),
+			gmp_uint64_t(v.denominator().get())
+		);
+	}
+}
+
+template<int T_BITS>
+mpfr::mpreal
+Conversion< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > >::toMpreal(const type & v, int precision) {
+	return Conversion< CGAL::FixedRational<T_BITS> >::toMpreal(v.asExtended(), precision);
+}
+
+template<int T_BITS>
+typename Conversion< CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > > >::type
+Conversion< CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > > >::moveFrom(const mpq_class & v) {
+	return type( Conversion< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > >::moveFrom(v) );
+}
+
+template<int T_BITS>
+mpq_class
+Conversion< CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > > >::toMpq(const type & v) {
+	return Conversion< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > >::toMpq(v.exact());
+}
+
+template<int T_BITS>
+mpfr::mpreal
+Conversion< CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > > >::toMpreal(const type & v, int precision) {
+	return Conversion< CGAL::ExtendedInt64q< CGAL::FixedRational<T_BITS> > >::toMpreal(v.exact(), precision);
+}
+
+#define LIB_RATSS_FIXED_RATIONAL_CONVERSION(__BITS) \
+	template struct Conversion< CGAL::FixedRational<__BITS> >; \
+	template struct Conversion< CGAL::ExtendedInt64q< CGAL::FixedRational<__BITS> > >; \
+	template struct Conversion< CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q< CGAL::FixedRational<__BITS> > > >;
+
+LIB_RATSS_FIXED_RATIONAL_CONVERSION(256)
+LIB_RATSS_FIXED_RATIONAL_CONVERSION(512)
+LIB_RATSS_FIXED_RATIONAL_CONVERSION(1024)
+
+#undef LIB_RATSS_FIXED_RATIONAL_CONVERSION
+
+//END CGAL::FixedRational specilizations
+#endif
 //BEGIN CGAL::ExtendedInt64q<CGAL::Gmpq> specilizations
 
 Conversion<CGAL::ExtendedInt64q<CGAL::Gmpq>>::type
 Conversion<CGAL::ExtendedInt64q<CGAL::Gmpq>>::moveFrom(const mpq_class & v) {
+	type::PQ pq;
+	if (toPq<type>(v, pq)) {
+		return type(pq);
+	}
 	return CGAL::ExtendedInt64q<CGAL::Gmpq>( Conversion<CGAL::ExtendedInt64q<CGAL::Gmpq>::extension_type>::moveFrom(v) );
 }
 
+Conversion<CGAL::ExtendedInt64q<CGAL::Gmpq>>::type
+Conversion<CGAL::ExtendedInt64q<CGAL::Gmpq>>::moveFrom(mpq_class && v) {
+	type::PQ pq;
+	if (toPq<type>(v, pq)) {
+		return type(pq);
+	}
+	return CGAL::ExtendedInt64q<CGAL::Gmpq>( Conversion<CGAL::ExtendedInt64q<CGAL::Gmpq>::extension_type>::moveFrom(std::move(v)) );
+}
+
 mpq_class
 Conversion< CGAL::ExtendedInt64q<CGAL::Gmpq> >::toMpq(const type & v) {
 	if (v.isExtended()) {
 		return Conversion<CGAL::ExtendedInt64q<CGAL::Gmpq>::extension_type>::toMpq( v.getExtended() );
 	}
+	else if (v.isInt128()) {
+		return Conversion<CGAL::ExtendedInt64q<CGAL::Gmpq>::extension_type>::toMpq( v.asExtended() );
+	}
 	else {
 		return mpq_class(
 			gmp_int64_t(v.numerator().get()),
@@ -95,6 +219,11 @@ Conversion< CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q<CGAL::Gmpq> > >::moveFrom(
 	return type( Conversion< CGAL::ExtendedInt64q<CGAL::Gmpq> >::moveFrom(v) );
 }
 
+Conversion< CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q<CGAL::Gmpq> > >::type
+Conversion< CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q<CGAL::Gmpq> > >::moveFrom(mpq_class && v) {
+	return type( Conversion< CGAL::ExtendedInt64q<CGAL::Gmpq> >::moveFrom(std::move(v)) );
+}
+
 mpq_class
 Conversion< CGAL::Lazy_exact_nt< CGAL::ExtendedInt64q<CGAL::Gmpq> > >::toMpq(const type & v) {
 	return Conversion< CGAL::ExtendedInt64q<CGAL::Gmpq> >::toMpq(v.exact());
@@ -113,6 +242,13 @@ Conversion<CGAL::Gmpq>::moveFrom(const mpq_class & v) {
 	return CGAL::Gmpq(v.get_mpq_t());
 }
 
+Conversion<CGAL::Gmpq>::type
+Conversion<CGAL::Gmpq>::moveFrom(mpq_class && v) {
+	CGAL::Gmpq result;
+	::mpq_swap(result.mpq(), v.get_mpq_t());
+	return result;
+}
+
 mpq_class
 Conversion<CGAL::Gmpq>::toMpq(const type & v) {
 	return mpq_class(v.mpq());
@@ -128,6 +264,11 @@ Conversion< CGAL::Lazy_exact_nt<CGAL::Gmpq> >::moveFrom(const mpq_class & v) {
 	return type(Conversion<CGAL::Gmpq>::moveFrom(v));
 }
 
+Conversion< CGAL::Lazy_exact_nt<CGAL::Gmpq> >::type
+Conversion< CGAL::Lazy_exact_nt<CGAL::Gmpq> >::moveFrom(mpq_class && v) {
+	return type(Conversion<CGAL::Gmpq>::moveFrom(std::move(v)));
+}
+
 mpq_class
 Conversion< CGAL::Lazy_exact_nt<CGAL::Gmpq> >::toMpq(const type & v) {
 	return Conversion<CGAL::Gmpq>::toMpq(v.exact());
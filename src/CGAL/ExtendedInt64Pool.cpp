@@ -0,0 +1,120 @@
+#include <libratss/CGAL/ExtendedInt64Pool.h>
+
+#include <gmp.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace CGAL {
+namespace {
+
+using AllocateFunction = void* (*)(std::size_t);
+using ReallocateFunction = void* (*)(void*, std::size_t, std::size_t);
+using FreeFunction = void (*)(void*, std::size_t);
+
+///memory functions of gmp before the pool was installed
+AllocateFunction g_allocate = 0;
+ReallocateFunction g_reallocate = 0;
+FreeFunction g_free = 0;
+
+///free buffers are linked through their first limb
+struct FreeBuffer {
+	FreeBuffer * next;
+};
+
+struct FreeList {
+	FreeBuffer * head;
+	std::size_t size;
+};
+
+struct FreeLists {
+	std::array<FreeList, GmpLimbPool::MAX_LIMBS> lists;
+	FreeLists();
+	~FreeLists();
+};
+
+thread_local bool g_destroyed = false;
+
+FreeLists::FreeLists() {
+	for(FreeList & fl : lists) {
+		fl.head = 0;
+		fl.size = 0;
+	}
+}
+
+FreeLists::~FreeLists() {
+	g_destroyed = true;
+	for(std::size_t i(0); i < lists.size(); ++i) {
+		while (lists[i].head) {
+			FreeBuffer * b = lists[i].head;
+			lists[i].head = b->next;
+			g_free(b, (i+1)*sizeof(mp_limb_t));
+		}
+	}
+}
+
+///@return 0 if buffers of this size are not pooled or the lists of this thread were already destroyed
+FreeList * freeList(std::size_t size) {
+	if (!size || size % sizeof(mp_limb_t) || size > GmpLimbPool::MAX_LIMBS*sizeof(mp_limb_t) || g_destroyed) {
+		return 0;
+	}
+	static thread_local FreeLists fls;
+	return &fls.lists[size/sizeof(mp_limb_t)-1];
+}
+
+} //end namespace
+
+constexpr std::size_t GmpLimbPool::MAX_LIMBS;
+constexpr std::size_t GmpLimbPool::MAX_FREE;
+
+void GmpLimbPool::install() {
+	if (installed()) {
+		return;
+	}
+	mp_get_memory_functions(&g_allocate, &g_reallocate, &g_free);
+	mp_set_memory_functions(&GmpLimbPool::allocate, &GmpLimbPool::reallocate, &GmpLimbPool::deallocate);
+}
+
+bool GmpLimbPool::installed() {
+	return g_allocate;
+}
+
+void * GmpLimbPool::allocate(std::size_t size) {
+	FreeList * fl = freeList(size);
+	if (fl && fl->head) {
+		FreeBuffer * b = fl->head;
+		fl->head = b->next;
+		--fl->size;
+		return b;
+	}
+	return g_allocate(size);
+}
+
+void * GmpLimbPool::reallocate(void * ptr, std::size_t oldSize, std::size_t newSize) {
+	if (oldSize == newSize) {
+		return ptr;
+	}
+	if (!freeList(oldSize) && !freeList(newSize)) {
+		return g_reallocate(ptr, oldSize, newSize);
+	}
+	void * result = allocate(newSize);
+	std::memcpy(result, ptr, std::min(oldSize, newSize));
+	deallocate(ptr, oldSize);
+	return result;
+}
+
+void GmpLimbPool::deallocate(void * ptr, std::size_t size) {
+	FreeList * fl = freeList(size);
+	if (fl && fl->size < MAX_FREE) {
+		FreeBuffer * b = static_cast<FreeBuffer*>(ptr);
+		b->next = fl->head;
+		fl->head = b;
+		++fl->size;
+	}
+	else {
+		g_free(ptr, size);
+	}
+}
+
+} //end namespace CGAL
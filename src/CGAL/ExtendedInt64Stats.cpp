@@ -0,0 +1,233 @@
+#include <libratss/CGAL/ExtendedInt64Stats.h>
+
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace CGAL {
+namespace {
+
+struct Registry {
+	std::mutex mutex;
+	std::vector<ExtendedInt64Stats::Block*> blocks;
+	///counters of threads that already exited
+	ExtendedInt64Stats::Block retired;
+};
+
+///never destroyed since threads may still exit during static destruction
+///Constructed in static storage: Block is over-aligned which plain new does not honor before C++17
+Registry & registry() {
+	static std::aligned_storage<sizeof(Registry), alignof(Registry)>::type storage;
+	static Registry * r = new (&storage) Registry();
+	return *r;
+}
+
+} //end namespace
+
+constexpr bool ExtendedInt64Stats::enabled;
+constexpr int ExtendedInt64Stats::NUM_BIT_BUCKETS;
+
+thread_local ExtendedInt64Stats::Block * ExtendedInt64Stats::m_local = 0;
+
+struct ExtendedInt64Stats::ThreadBlock {
+	Block block;
+	ThreadBlock() {
+		Registry & r = registry();
+		std::lock_guard<std::mutex> lck(r.mutex);
+		r.blocks.push_back(&block);
+	}
+	~ThreadBlock() {
+		Registry & r = registry();
+		std::lock_guard<std::mutex> lck(r.mutex);
+		for(int kind(0); kind < K_NUM_KINDS; ++kind) {
+			Counters c = r.retired.get(Kind(kind));
+			c += block.get(Kind(kind));
+			r.retired.set(Kind(kind), c);
+		}
+		r.blocks.erase(std::find(r.blocks.begin(), r.blocks.end(), &block));
+		//Objects destroyed after this point count into the retired block.
+		//Exiting threads may race on it which can lose a few counts, but does not crash.
+		m_local = &r.retired;
+	}
+};
+
+//BEGIN Counters
+
+ExtendedInt64Stats::Counters::Counters() :
+allocations(0),
+deallocations(0),
+extendedAllocations(0),
+extendedDeallocations(0),
+promotions(0),
+demotions(0),
+maxNumeratorBits(0),
+maxDenominatorBits(0)
+{
+	numeratorBits.fill(0);
+	denominatorBits.fill(0);
+	tierHits.fill(0);
+}
+
+ExtendedInt64Stats::Counters &
+ExtendedInt64Stats::Counters::operator+=(const Counters & other) {
+	allocations += other.allocations;
+	deallocations += other.deallocations;
+	extendedAllocations += other.extendedAllocations;
+	extendedDeallocations += other.extendedDeallocations;
+	promotions += other.promotions;
+	demotions += other.demotions;
+	maxNumeratorBits = std::max(maxNumeratorBits, other.maxNumeratorBits);
+	maxDenominatorBits = std::max(maxDenominatorBits, other.maxDenominatorBits);
+	for(int i(0); i < NUM_BIT_BUCKETS; ++i) {
+		numeratorBits[i] += other.numeratorBits[i];
+		denominatorBits[i] += other.denominatorBits[i];
+	}
+	for(int i(0); i < T_NUM_TIERS; ++i) {
+		tierHits[i] += other.tierHits[i];
+	}
+	return *this;
+}
+
+int64_t
+ExtendedInt64Stats::Counters::liveAllocations() const {
+	return int64_t(allocations - deallocations);
+}
+
+int64_t
+ExtendedInt64Stats::Counters::liveExtendedAllocations() const {
+	return int64_t(extendedAllocations - extendedDeallocations);
+}
+
+double
+ExtendedInt64Stats::Counters::tierHitRate(Tier tier) const {
+	uint64_t total = tierHits[T_INT64] + tierHits[T_INT128] + tierHits[T_EXTENDED];
+	return (total ? double(tierHits[tier])/total : 0.0);
+}
+
+void
+ExtendedInt64Stats::Counters::print(std::ostream & out) const {
+	out << "allocations: " << allocations << '\n';
+	out << "live allocations: " << liveAllocations() << '\n';
+	out << "extended allocations: " << extendedAllocations << '\n';
+	out << "live extended allocations: " << liveExtendedAllocations() << '\n';
+	out << "promotions: " << promotions << '\n';
+	out << "demotions: " << demotions << '\n';
+	out << "max numerator bits: " << maxNumeratorBits << '\n';
+	out << "max denominator bits: " << maxDenominatorBits << '\n';
+	out << "tier hits int64/int128/extended: "
+		<< tierHits[T_INT64] << '/' << tierHits[T_INT128] << '/' << tierHits[T_EXTENDED] << '\n';
+	out << "bits\tnumerators\tdenominators\n";
+	for(int i(0); i < NUM_BIT_BUCKETS; ++i) {
+		if (!numeratorBits[i] && !denominatorBits[i]) {
+			continue;
+		}
+		if (i+1 < NUM_BIT_BUCKETS) {
+			out << "<=" << 64*(i+1);
+		}
+		else {
+			out << '>' << 64*i;
+		}
+		out << '\t' << numeratorBits[i] << '\t' << denominatorBits[i] << '\n';
+	}
+}
+
+//END Counters
+//BEGIN Block
+
+ExtendedInt64Stats::Block::Block() {
+	reset();
+}
+
+ExtendedInt64Stats::Counters
+ExtendedInt64Stats::Block::get(Kind kind) const {
+	const BlockCounters & c = counters[kind];
+	Counters result;
+	result.allocations = c.allocations.load(std::memory_order_relaxed);
+	result.deallocations = c.deallocations.load(std::memory_order_relaxed);
+	result.extendedAllocations = c.extendedAllocations.load(std::memory_order_relaxed);
+	result.extendedDeallocations = c.extendedDeallocations.load(std::memory_order_relaxed);
+	result.promotions = c.promotions.load(std::memory_order_relaxed);
+	result.demotions = c.demotions.load(std::memory_order_relaxed);
+	result.maxNumeratorBits = c.maxNumeratorBits.load(std::memory_order_relaxed);
+	result.maxDenominatorBits = c.maxDenominatorBits.load(std::memory_order_relaxed);
+	for(int i(0); i < NUM_BIT_BUCKETS; ++i) {
+		result.numeratorBits[i] = c.numeratorBits[i].load(std::memory_order_relaxed);
+		result.denominatorBits[i] = c.denominatorBits[i].load(std::memory_order_relaxed);
+	}
+	for(int i(0); i < T_NUM_TIERS; ++i) {
+		result.tierHits[i] = c.tierHits[i].load(std::memory_order_relaxed);
+	}
+	return result;
+}
+
+void
+ExtendedInt64Stats::Block::set(Kind kind, const Counters & v) {
+	BlockCounters & c = counters[kind];
+	c.allocations.store(v.allocations, std::memory_order_relaxed);
+	c.deallocations.store(v.deallocations, std::memory_order_relaxed);
+	c.extendedAllocations.store(v.extendedAllocations, std::memory_order_relaxed);
+	c.extendedDeallocations.store(v.extendedDeallocations, std::memory_order_relaxed);
+	c.promotions.store(v.promotions, std::memory_order_relaxed);
+	c.demotions.store(v.demotions, std::memory_order_relaxed);
+	c.maxNumeratorBits.store(v.maxNumeratorBits, std::memory_order_relaxed);
+	c.maxDenominatorBits.store(v.maxDenominatorBits, std::memory_order_relaxed);
+	for(int i(0); i < NUM_BIT_BUCKETS; ++i) {
+		c.numeratorBits[i].store(v.numeratorBits[i], std::memory_order_relaxed);
+		c.denominatorBits[i].store(v.denominatorBits[i], std::memory_order_relaxed);
+	}
+	for(int i(0); i < T_NUM_TIERS; ++i) {
+		c.tierHits[i].store(v.tierHits[i], std::memory_order_relaxed);
+	}
+}
+
+void
+ExtendedInt64Stats::Block::reset() {
+	for(int kind(0); kind < K_NUM_KINDS; ++kind) {
+		set(Kind(kind), Counters());
+	}
+}
+
+//END Block
+//BEGIN ExtendedInt64Stats
+
+ExtendedInt64Stats::Counters
+ExtendedInt64Stats::get(Kind kind) {
+	Registry & r = registry();
+	std::lock_guard<std::mutex> lck(r.mutex);
+	Counters result = r.retired.get(kind);
+	for(const Block * b : r.blocks) {
+		result += b->get(kind);
+	}
+	return result;
+}
+
+ExtendedInt64Stats::Counters
+ExtendedInt64Stats::local(Kind kind) {
+	Block * b = m_local;
+	if (!b) {
+		b = &registerThread();
+	}
+	return b->get(kind);
+}
+
+void
+ExtendedInt64Stats::reset() {
+	Registry & r = registry();
+	std::lock_guard<std::mutex> lck(r.mutex);
+	r.retired.reset();
+	for(Block * b : r.blocks) {
+		b->reset();
+	}
+}
+
+ExtendedInt64Stats::Block &
+ExtendedInt64Stats::registerThread() {
+	thread_local ThreadBlock tb;
+	m_local = &tb.block;
+	return tb.block;
+}
+
+//END ExtendedInt64Stats
+
+}//end namespace CGAL
@@ -1,31 +1,193 @@
 #include <libratss/CGAL/ExtendedInt64q.h>
 namespace CGAL {
+namespace internal {
 
-template<>
-uint64_t ExtendedInt64q<CGAL::Gmpq>::number_of_extended_allocations = 0;
+//BEGIN 128 bit arithmetic
+namespace {
 
-template<>
-uint64_t ExtendedInt64q<CGAL::Gmpq>::number_of_allocations = 0;
+//overflow if the result does not fit into 127 bits
 
-template<>
-uint32_t ExtendedInt64q<CGAL::Gmpq>::max_numerator_bits = 0;
+bool add_overflow(int128 a, int128 b, int128 & result) {
+#ifdef __SIZEOF_INT128__
+	return __builtin_add_overflow(a, b, &result) || !fits127(result);
+#else
+	//no overflow of boost_int128 since |a|, |b| < 2^127
+	result = a + b;
+	return !fits127(result);
+#endif
+}
 
-template<>
-uint32_t ExtendedInt64q<CGAL::Gmpq>::max_denominator_bits = 0;
+bool mul_overflow(int128 a, int128 b, int128 & result) {
+#ifdef __SIZEOF_INT128__
+	return __builtin_mul_overflow(a, b, &result) || !fits127(result);
+#else
+	boost::multiprecision::int256_t tmp = boost::multiprecision::int256_t(a) * b;
+	if (tmp != 0 && boost::multiprecision::msb(boost::multiprecision::abs(tmp)) >= 127) {
+		return true;
+	}
+	result = tmp.convert_to<int128>();
+	return false;
+#endif
+}
 
-template<>
-uint64_t ExtendedInt64q<CGAL::internal::boost_int1024q>::number_of_extended_allocations = 0;
+int ctz128(uint128 v) {
+	uint64_t low = static_cast<uint64_t>(v);
+	return (low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<uint64_t>(v >> 64)));
+}
 
-template<>
-uint64_t ExtendedInt64q<CGAL::internal::boost_int1024q>::number_of_allocations = 0;
+///number of bits of v, 0 for v == 0
+int bits128(uint128 v) {
+	uint64_t high = static_cast<uint64_t>(v >> 64);
+	uint64_t low = static_cast<uint64_t>(v);
+	return (high ? 128 - __builtin_clzll(high) : (low ? 64 - __builtin_clzll(low) : 0));
+}
 
-template<>
-uint32_t ExtendedInt64q<CGAL::internal::boost_int1024q>::max_numerator_bits = 0;
+///the odd part of the gcd of unrelated operands reaches 2^MAX_ODD_GCD_BITS with a probability of about 2^-MAX_ODD_GCD_BITS
+constexpr int MAX_ODD_GCD_BITS = 16;
 
-template<>
-uint32_t ExtendedInt64q<CGAL::internal::boost_int1024q>::max_denominator_bits = 0;
+} //end namespace
 
-namespace internal {
+uint128 gcd128(uint128 u, uint128 v) {
+	if (!u || !v) {
+		return u | v;
+	}
+	int shift = ctz128(u | v);
+	u >>= ctz128(u);
+	v >>= ctz128(v);
+	//both odd, the difference is even and replaces the larger one
+	while (u != v) {
+		if (!((u | v) >> 64)) {
+			return uint128(gcd64(static_cast<uint64_t>(u), static_cast<uint64_t>(v))) << shift;
+		}
+		bool smaller = v < u;
+		uint128 diff = (smaller ? u - v : v - u);
+		u = (smaller ? v : u);
+		v = diff >> ctz128(diff);
+	}
+	return u << shift;
+}
+
+bool add128(int128 a, int128 b, int128 c, int128 d, int128 & num, int128 & den) {
+	int128 g = int128(gcd128(uint128(b), uint128(d)));
+	int128 t1, t2, t;
+	if (g == 1) {
+		return !(mul_overflow(a, d, t1) || mul_overflow(c, b, t2) || add_overflow(t1, t2, num) || mul_overflow(b, d, den));
+	}
+	if (mul_overflow(a, d/g, t1) || mul_overflow(c, b/g, t2) || add_overflow(t1, t2, t)) {
+		return false;
+	}
+	if (t == 0) {
+		num = 0;
+		den = 1;
+		return true;
+	}
+	int128 g2 = int128(gcd128(abs128(t) % uint128(g), uint128(g)));
+	num = t / g2;
+	return !mul_overflow(b/g, d/g2, den);
+}
+
+bool mul128(int128 & a, int128 & b, int128 & c, int128 & d, int128 & num, int128 & den) {
+	if (a == 0 || c == 0) {
+		num = 0;
+		den = 1;
+		return true;
+	}
+	int128 g1 = int128(gcd128(abs128(a), uint128(d)));
+	int128 g2 = int128(gcd128(abs128(c), uint128(b)));
+	a /= g1;
+	d /= g1;
+	c /= g2;
+	b /= g2;
+	return !(mul_overflow(a, c, num) || mul_overflow(b, d, den));
+}
+
+bool mul128_overflows(int128 a, int128 b, int128 c, int128 d) {
+	if (a == 0 || c == 0) {
+		return false;
+	}
+	uint128 ua = abs128(a), ub = uint128(b), uc = abs128(c), ud = uint128(d);
+	//the gcds of mul128 are gcd(a, d) and gcd(c, b)
+	int twos = std::min(ctz128(ua), ctz128(ud)) + std::min(ctz128(uc), ctz128(ub));
+	//|x| >= 2^(bits(x)-1), the reduced product does not fit if it is at least 2^127
+	int reduction = twos + MAX_ODD_GCD_BITS + 2;
+	return bits128(ua) + bits128(uc) >= 127 + reduction || bits128(ub) + bits128(ud) >= 127 + reduction;
+}
+
+bool div128(int128 & a, int128 & b, int128 & c, int128 & d, int128 & num, int128 & den) {
+	assert(c != 0);
+	if (a == 0) {
+		num = 0;
+		den = 1;
+		return true;
+	}
+	//a/b * d/c with a positive denominator
+	if (c < 0) {
+		a = -a;
+		c = -c;
+	}
+	std::swap(c, d);
+	return mul128(a, b, c, d, num, den);
+}
+
+bool cmp128(int128 a, int128 b, int128 c, int128 d, int & result) {
+	int128 ad, cb;
+	if (mul_overflow(a, d, ad) || mul_overflow(c, b, cb)) {
+		return false;
+	}
+	result = (ad < cb ? -1 : (ad > cb ? 1 : 0));
+	return true;
+}
+
+namespace {
+
+///|v| < 2^127 has to hold
+int128 make_int128(bool negative, uint64_t high, uint64_t low) {
+	int128 result = join128(int64_t(high), low);
+	return (negative ? -result : result);
+}
+
+///mpq_t of a canonical 128 bit fraction, reads directly from the limbs if possible
+class Int128Mpq {
+public:
+	Int128Mpq(int128 num, int128 den) {
+		init(mpq_numref(m_v), m_num, num);
+		init(mpq_denref(m_v), m_den, den);
+	}
+#if GMP_NUMB_BITS != 64
+	~Int128Mpq() {
+		::mpq_clear(m_v);
+	}
+#endif
+	Int128Mpq(const Int128Mpq & other) = delete;
+	Int128Mpq & operator=(const Int128Mpq & other) = delete;
+	mpq_srcptr get() const {
+		return m_v;
+	}
+private:
+	static void init(mpz_ptr dest, uint64_t * words, int128 v) {
+		uint128 absv = abs128(v);
+		words[0] = static_cast<uint64_t>(absv);
+		words[1] = static_cast<uint64_t>(absv >> 64);
+		mp_size_t size = (words[1] ? 2 : (words[0] ? 1 : 0));
+#if GMP_NUMB_BITS == 64
+		::mpz_roinit_n(dest, reinterpret_cast<mp_srcptr>(words), (v < 0 ? -size : size));
+#else
+		::mpz_init(dest);
+		::mpz_import(dest, size, -1, sizeof(uint64_t), 0, 0, words);
+		if (v < 0) {
+			::mpz_neg(dest, dest);
+		}
+#endif
+	}
+private:
+	uint64_t m_num[2];
+	uint64_t m_den[2];
+	mpq_t m_v;
+};
+
+} //end namespace
+
+//END 128 bit arithmetic
 
 void
 ExtendedInt64qTraits<CGAL::Gmpq>::simplify(type & v)
@@ -39,6 +201,23 @@ ExtendedInt64qTraits<CGAL::Gmpq>::fits_int64(const numerator_type & v)
 	return ::mpz_fits_slong_p(v.mpz());
 }
 
+bool
+ExtendedInt64qTraits<CGAL::Gmpq>::to_int128(const type & v, int128 & numerator, int128 & denominator)
+{
+	mpz_srcptr num = mpq_numref(v.mpq());
+	mpz_srcptr den = mpq_denref(v.mpq());
+	if (::mpz_sizeinbase(num, 2) > 127 || ::mpz_sizeinbase(den, 2) > 127) {
+		return false;
+	}
+	uint64_t words[2] = {0, 0};
+	::mpz_export(words, 0, -1, sizeof(uint64_t), 0, 0, num);
+	numerator = make_int128(mpz_sgn(num) < 0, words[1], words[0]);
+	words[0] = words[1] = 0;
+	::mpz_export(words, 0, -1, sizeof(uint64_t), 0, 0, den);
+	denominator = make_int128(false, words[1], words[0]);
+	return true;
+}
+
 
 int64_t
 ExtendedInt64qTraits<CGAL::Gmpq>::to_int64(const numerator_type & v) {
@@ -78,11 +257,52 @@ ExtendedInt64qTraits<CGAL::Gmpq>::make(base_type numerator, base_type denominato
 	return type(LIB_RATSS_NAMESPACE::gmp_int64_t(numerator), LIB_RATSS_NAMESPACE::gmp_int64_t(denominator));
 }
 
+uint32_t
+ExtendedInt64qTraits<CGAL::Gmpq>::numerator_bits(const type & v) {
+	return ::mpz_sizeinbase(mpq_numref(v.mpq()), 2);
+}
+
+uint32_t
+ExtendedInt64qTraits<CGAL::Gmpq>::denominator_bits(const type & v) {
+	return ::mpz_sizeinbase(mpq_denref(v.mpq()), 2);
+}
+
 ExtendedInt64qTraits<CGAL::Gmpq>::type
 ExtendedInt64qTraits<CGAL::Gmpq>::make(base_type numerator, unsigned_base_type denominator) {
 	return type(LIB_RATSS_NAMESPACE::gmp_int64_t(numerator), LIB_RATSS_NAMESPACE::gmp_uint64_t(denominator));
 }
 
+ExtendedInt64qTraits<CGAL::Gmpq>::type
+ExtendedInt64qTraits<CGAL::Gmpq>::make(int128 numerator, int128 denominator) {
+	type result;
+	::mpq_set(result.mpq(), Int128Mpq(numerator, denominator).get());
+	return result;
+}
+
+ExtendedInt64qTraits<CGAL::Gmpq>::type
+ExtendedInt64qTraits<CGAL::Gmpq>::add(int128 a, int128 b, int128 c, int128 d) {
+	type result;
+	::mpq_add(result.mpq(), Int128Mpq(a, b).get(), Int128Mpq(c, d).get());
+	return result;
+}
+
+ExtendedInt64qTraits<CGAL::Gmpq>::type
+ExtendedInt64qTraits<CGAL::Gmpq>::mul(int128 a, int128 b, int128 c, int128 d) {
+	//the fractions are already reduced, no need for the gcds of mpq_mul
+	Int128Mpq ab(a, b), cd(c, d);
+	type result;
+	::mpz_mul(mpq_numref(result.mpq()), mpq_numref(ab.get()), mpq_numref(cd.get()));
+	::mpz_mul(mpq_denref(result.mpq()), mpq_denref(ab.get()), mpq_denref(cd.get()));
+	return result;
+}
+
+ExtendedInt64qTraits<CGAL::Gmpq>::type
+ExtendedInt64qTraits<CGAL::Gmpq>::mul_unreduced(int128 a, int128 b, int128 c, int128 d) {
+	type result;
+	::mpq_mul(result.mpq(), Int128Mpq(a, b).get(), Int128Mpq(c, d).get());
+	return result;
+}
+
 //BEGIN boost_int1024q
 void
 ExtendedInt64qTraits<boost_int1024q>::simplify(type & /*v*/)
@@ -94,6 +314,19 @@ ExtendedInt64qTraits<boost_int1024q>::fits_int64(const numerator_type & v)
 	return std::numeric_limits<int64_t>::min() <= v && v <= std::numeric_limits<int64_t>::max();
 }
 
+bool
+ExtendedInt64qTraits<boost_int1024q>::to_int128(const type & v, int128 & numerator, int128 & denominator)
+{
+	numerator_type num = boost::multiprecision::abs(boost::multiprecision::numerator(v));
+	denominator_type den = boost::multiprecision::denominator(v);
+	if ((num != 0 && boost::multiprecision::msb(num) >= 127) || boost::multiprecision::msb(den) >= 127) {
+		return false;
+	}
+	numerator = make_int128(v < 0, static_cast<uint64_t>(num >> 64), static_cast<uint64_t>(num & std::numeric_limits<uint64_t>::max()));
+	denominator = make_int128(false, static_cast<uint64_t>(den >> 64), static_cast<uint64_t>(den & std::numeric_limits<uint64_t>::max()));
+	return true;
+}
+
 int64_t
 ExtendedInt64qTraits<boost_int1024q>::to_int64(const numerator_type & v) {
 	return v.convert_to<int64_t>();
@@ -126,11 +359,42 @@ ExtendedInt64qTraits<boost_int1024q>::num_bits(const numerator_type &) {
 	return 1024;
 }
 
+uint32_t
+ExtendedInt64qTraits<boost_int1024q>::numerator_bits(const type & v) {
+	numerator_type n = boost::multiprecision::abs(numerator(v));
+	return (n == 0 ? 1 : boost::multiprecision::msb(n)+1);
+}
+
+uint32_t
+ExtendedInt64qTraits<boost_int1024q>::denominator_bits(const type & v) {
+	return boost::multiprecision::msb(denominator(v))+1;
+}
+
 ExtendedInt64qTraits<boost_int1024q>::type
 ExtendedInt64qTraits<boost_int1024q>::make(base_type numerator, base_type denominator) {
 	return type(numerator, denominator);
 }
 
+ExtendedInt64qTraits<boost_int1024q>::type
+ExtendedInt64qTraits<boost_int1024q>::make(int128 numerator, int128 denominator) {
+	return type(numerator_type(numerator), denominator_type(denominator));
+}
+
+ExtendedInt64qTraits<boost_int1024q>::type
+ExtendedInt64qTraits<boost_int1024q>::add(int128 a, int128 b, int128 c, int128 d) {
+	return make(a, b) + make(c, d);
+}
+
+ExtendedInt64qTraits<boost_int1024q>::type
+ExtendedInt64qTraits<boost_int1024q>::mul(int128 a, int128 b, int128 c, int128 d) {
+	return make(a, b) * make(c, d);
+}
+
+ExtendedInt64qTraits<boost_int1024q>::type
+ExtendedInt64qTraits<boost_int1024q>::mul_unreduced(int128 a, int128 b, int128 c, int128 d) {
+	return make(a, b) * make(c, d);
+}
+
 ExtendedInt64qTraits<boost_int1024q>::type
 ExtendedInt64qTraits<boost_int1024q>::make(base_type numerator, unsigned_base_type denominator) {
 	if (numerator < 0) {
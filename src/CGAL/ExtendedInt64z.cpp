@@ -2,8 +2,6 @@
 
 namespace CGAL {
 
-uint64_t ExtendedInt64z::number_of_extended_allocations = 0;
-
 ExtendedInt64z::ExtendedInt64z() :
 m_isExtended(false)
 {
@@ -25,7 +23,7 @@ ExtendedInt64z::ExtendedInt64z(ExtendedInt64z && other) :
 m_isExtended(false)
 {
 	if (other.isExtended()) {
-		set(m_v.ptr);
+		set(other.ptr());
 		other.set((extension_type*)0);
 	}
 	else {
@@ -77,6 +75,12 @@ m_isExtended(false)
 	set( extension_type(str, base) );
 }
 
+ExtendedInt64z::~ExtendedInt64z() {
+	if (isExtended()) {
+		deleteExt();
+	}
+}
+
 
 ExtendedInt64z& ExtendedInt64z::operator=(const ExtendedInt64z & other) {
 	if (other.isExtended()) {
@@ -129,15 +133,24 @@ Sign ExtendedInt64z::sign() const {
 ExtendedInt64z & ExtendedInt64z::operator+=(const ExtendedInt64z & other) {
 	if (isExtended() && other.isExtended()) {
 		getExtended() += other.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() += other.getExtendedPrimitive();
+		demote();
 	}
 	else if (other.isExtended()) {
 		set(asExtended() + other.getExtended());
 	}
-	else {//TODO: fast imp
-		set(asExtended() + other.asExtended());
+	else {
+		base_type result;
+		if (__builtin_add_overflow(get(), other.get(), &result)) {
+			set(config_traits::make(int128(get()) + int128(other.get())));
+			ExtendedInt64Stats::onPromotion(ExtendedInt64Stats::K_INTEGER);
+		}
+		else {
+			get() = result;
+		}
 	}
 	return *this;
 }
@@ -145,15 +158,24 @@ ExtendedInt64z & ExtendedInt64z::operator+=(const ExtendedInt64z & other) {
 ExtendedInt64z & ExtendedInt64z::operator-=(const ExtendedInt64z & other) {
 	if (isExtended() && other.isExtended()) {
 		getExtended() -= other.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() -= other.getExtendedPrimitive();
+		demote();
 	}
 	else if (other.isExtended()) {
 		set(asExtended() - other.getExtended());
 	}
-	else {//TODO: fast imp
-		set(asExtended() - other.asExtended());
+	else {
+		base_type result;
+		if (__builtin_sub_overflow(get(), other.get(), &result)) {
+			set(config_traits::make(int128(get()) - int128(other.get())));
+			ExtendedInt64Stats::onPromotion(ExtendedInt64Stats::K_INTEGER);
+		}
+		else {
+			get() = result;
+		}
 	}
 	return *this;
 }
@@ -161,15 +183,24 @@ ExtendedInt64z & ExtendedInt64z::operator-=(const ExtendedInt64z & other) {
 ExtendedInt64z & ExtendedInt64z::operator*=(const ExtendedInt64z & other) {
 	if (isExtended() && other.isExtended()) {
 		getExtended() *= other.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() *= other.getExtendedPrimitive();
+		demote();
 	}
 	else if (other.isExtended()) {
 		set(asExtended() * other.getExtended());
 	}
-	else {//TODO: fast imp
-		set(asExtended() * other.asExtended());
+	else {
+		base_type result;
+		if (__builtin_mul_overflow(get(), other.get(), &result)) {
+			set(config_traits::make(int128(get()) * int128(other.get())));
+			ExtendedInt64Stats::onPromotion(ExtendedInt64Stats::K_INTEGER);
+		}
+		else {
+			get() = result;
+		}
 	}
 	return *this;
 }
@@ -177,13 +208,19 @@ ExtendedInt64z & ExtendedInt64z::operator*=(const ExtendedInt64z & other) {
 ExtendedInt64z & ExtendedInt64z::operator/=(const ExtendedInt64z & other) {
 	if (isExtended() && other.isExtended()) {
 		getExtended() /= other.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() /= other.getExtendedPrimitive();
+		demote();
 	}
 	else if (other.isExtended()) {
 		set(asExtended() / other.getExtended());
 	}
+	else if (other.get() == -1) {
+		//btmin/-1 does not fit
+		*this = -(*this);
+	}
 	else {
 		get() /= other.get();
 	}
@@ -193,13 +230,18 @@ ExtendedInt64z & ExtendedInt64z::operator/=(const ExtendedInt64z & other) {
 ExtendedInt64z & ExtendedInt64z::operator%=(const ExtendedInt64z & other) {
 	if (isExtended() && other.isExtended()) {
 		getExtended() %= other.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() %= other.getExtendedPrimitive();
+		demote();
 	}
 	else if (other.isExtended()) {
 		set(asExtended() % other.getExtended());
 	}
+	else if (other.get() == -1) {
+		get() = 0;
+	}
 	else {
 		get() %= other.get();
 	}
@@ -209,9 +251,11 @@ ExtendedInt64z & ExtendedInt64z::operator%=(const ExtendedInt64z & other) {
 ExtendedInt64z & ExtendedInt64z::operator&=(const ExtendedInt64z & other) {
 	if (isExtended() && other.isExtended()) {
 		getExtended() &= other.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() &= other.getExtendedPrimitive();
+		demote();
 	}
 	else if (other.isExtended()) {
 		set(asExtended() & other.getExtended());
@@ -225,9 +269,11 @@ ExtendedInt64z & ExtendedInt64z::operator&=(const ExtendedInt64z & other) {
 ExtendedInt64z & ExtendedInt64z::operator|=(const ExtendedInt64z & other) {
 	if (isExtended() && other.isExtended()) {
 		getExtended() |= other.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() |= other.getExtendedPrimitive();
+		demote();
 	}
 	else if (other.isExtended()) {
 		set(asExtended() | other.getExtended());
@@ -241,9 +287,11 @@ ExtendedInt64z & ExtendedInt64z::operator|=(const ExtendedInt64z & other) {
 ExtendedInt64z & ExtendedInt64z::operator^=(const ExtendedInt64z & other) {
 	if (isExtended() && other.isExtended()) {
 		getExtended() ^= other.getExtended();
+		demote();
 	}
 	else if (isExtended()) {
 		getExtended() ^= other.getExtendedPrimitive();
+		demote();
 	}
 	else if (other.isExtended()) {
 		set(asExtended() ^ other.getExtended());
@@ -284,6 +332,10 @@ bool ExtendedInt64z::operator==(const ExtendedInt64z & other) const {
 	}
 }
 
+ExtendedInt64Stats::Counters ExtendedInt64z::stats() {
+	return ExtendedInt64Stats::get(ExtendedInt64Stats::K_INTEGER);
+}
+
 ExtendedInt64z ExtendedInt64z::operator+() const {
 	return *this;
 }
@@ -292,6 +344,10 @@ ExtendedInt64z ExtendedInt64z::operator-() const {
 	if (isExtended()) {
 		return ExtendedInt64z( -getExtended() );
 	}
+	else if (get() == btmin) {
+		ExtendedInt64Stats::onPromotion(ExtendedInt64Stats::K_INTEGER);
+		return ExtendedInt64z( -asExtended() );
+	}
 	else {
 		return ExtendedInt64z( -get() );
 	}
@@ -302,11 +358,15 @@ ExtendedInt64z & ExtendedInt64z::operator<<=(const unsigned long& i) {
 		getExtended() <<= i;
 	}
 	else {
-		if (false) { //TODO: do correct overflow check here
-			get() <<= i;
+		base_type result;
+		if (i < 63 && !__builtin_mul_overflow(get(), base_type(1) << i, &result)) {
+			get() = result;
 		}
 		else {
 			set( asExtended() << i );
+			if (isExtended()) {
+				ExtendedInt64Stats::onPromotion(ExtendedInt64Stats::K_INTEGER);
+			}
 		}
 	}
 	return *this;
@@ -315,10 +375,12 @@ ExtendedInt64z & ExtendedInt64z::operator<<=(const unsigned long& i) {
 ExtendedInt64z& ExtendedInt64z::operator>>= (const unsigned long& i) {
 	if (isExtended()) {
 		getExtended() >>= i;
+		demote();
 	}
 	else {
-		if (false) { //TODO: do correct overflow check here
-			get() >>= i;
+		//Gmpz rounds towards zero, the builtin shift towards -inf
+		if (get() >= 0) {
+			get() = (i < 64 ? get() >> i : 0);
 		}
 		else {
 			set( asExtended() >> i );
@@ -330,6 +392,7 @@ ExtendedInt64z& ExtendedInt64z::operator>>= (const unsigned long& i) {
 ExtendedInt64z& ExtendedInt64z::operator++() {
 	if (isExtended()) {
 		++getExtended();
+		demote();
 	}
 	else {
 		if (get() < btmax) {
@@ -345,6 +408,7 @@ ExtendedInt64z& ExtendedInt64z::operator++() {
 ExtendedInt64z& ExtendedInt64z::operator--() {
 	if (isExtended()) {
 		--getExtended();
+		demote();
 	}
 	else {
 		if (get() > btmin) {
@@ -415,9 +479,34 @@ void ExtendedInt64z::set(const extension_type & v) {
 			getExtended() = v;
 		}
 		else {
-			set( new extension_type(v) );
-			++number_of_extended_allocations;
+			set( internal::ExtendedInt64Pool<extension_type>::create(v) );
+			ExtendedInt64Stats::onExtendedAllocation(ExtendedInt64Stats::K_INTEGER);
+		}
+		ExtendedInt64Stats::onExtendedValue(ExtendedInt64Stats::K_INTEGER, ::mpz_sizeinbase(getExtended().mpz(), 2));
+	}
+}
+
+void ExtendedInt64z::set(extension_type && v) {
+	if (::mpz_fits_slong_p(v.mpz())) {
+		set( ::mpz_get_si(v.mpz()) );
+	}
+	else {
+		if (isExtended()) {
+			getExtended() = std::move(v);
+		}
+		else {
+			set( internal::ExtendedInt64Pool<extension_type>::create(std::move(v)) );
+			ExtendedInt64Stats::onExtendedAllocation(ExtendedInt64Stats::K_INTEGER);
 		}
+		ExtendedInt64Stats::onExtendedValue(ExtendedInt64Stats::K_INTEGER, ::mpz_sizeinbase(getExtended().mpz(), 2));
+	}
+}
+
+void ExtendedInt64z::demote() {
+	assert(isExtended());
+	if (::mpz_fits_slong_p(getExtended().mpz())) {
+		set( ::mpz_get_si(getExtended().mpz()) );
+		ExtendedInt64Stats::onDemotion(ExtendedInt64Stats::K_INTEGER);
 	}
 }
 
@@ -428,8 +517,8 @@ void ExtendedInt64z::set(ExtendedInt64z::extension_type* v) {
 
 void ExtendedInt64z::deleteExt() {
 	assert(isExtended());
-	delete m_v.ptr;
-	--number_of_extended_allocations;
+	internal::ExtendedInt64Pool<extension_type>::release(m_v.ptr);
+	ExtendedInt64Stats::onExtendedDeallocation(ExtendedInt64Stats::K_INTEGER);
 	set( (extension_type*)0 );
 }
 
@@ -445,6 +534,22 @@ ExtendedInt64zTraits<CGAL::Gmpz>::make(uint64_t v) {
 	return type(LIB_RATSS_NAMESPACE::gmp_uint64_t(v));
 }
 
+ExtendedInt64zTraits<CGAL::Gmpz>::type
+ExtendedInt64zTraits<CGAL::Gmpz>::make(int128 v) {
+#ifdef __SIZEOF_INT128__
+	__uint128_t absv = (v < 0 ? -__uint128_t(v) : __uint128_t(v));
+	uint64_t limbs[2] = { uint64_t(absv), uint64_t(absv >> 64) };
+	type result;
+	::mpz_import(result.mpz(), 2, -1, sizeof(uint64_t), 0, 0, limbs);
+	if (v < 0) {
+		::mpz_neg(result.mpz(), result.mpz());
+	}
+	return result;
+#else
+	return type(v.str());
+#endif
+}
+
 ExtendedInt64zTraits<CGAL::Gmpz>::primitive_type
 ExtendedInt64zTraits<CGAL::Gmpz>::make_primitive(int64_t v) {
 	return primitive_type(v);
@@ -460,6 +565,11 @@ ExtendedInt64zTraits<boost_int1024>::make(uint64_t v) {
 	return type(LIB_RATSS_NAMESPACE::gmp_uint64_t(v));
 }
 
+ExtendedInt64zTraits<boost_int1024>::type
+ExtendedInt64zTraits<boost_int1024>::make(int128 v) {
+	return type(v);
+}
+
 ExtendedInt64zTraits<boost_int1024>::primitive_type
 ExtendedInt64zTraits<boost_int1024>::make_primitive(int64_t v) {
 	return primitive_type(v);
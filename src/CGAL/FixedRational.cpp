@@ -0,0 +1,879 @@
+#include <libratss/CGAL/FixedRational.h>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace CGAL {
+
+//BEGIN mpn helpers
+namespace {
+
+using size_type = mp_size_t;
+
+#if GMP_NUMB_BITS == 64 && GMP_NAIL_BITS == 0
+	#define LIBRATSS_FIXED_RATIONAL_LEHMER
+#endif
+
+inline size_type abs_size(size_type s) {
+	return (s < 0 ? -s : s);
+}
+
+inline size_type normalize(const mp_limb_t * p, size_type n) {
+	while (n > 0 && !p[n-1]) {
+		--n;
+	}
+	return n;
+}
+
+inline bool is_one(const mp_limb_t * p, size_type n) {
+	return n == 1 && p[0] == 1;
+}
+
+inline int cmp_abs(const mp_limb_t * a, size_type an, const mp_limb_t * b, size_type bn) {
+	if (an != bn) {
+		return (an < bn ? -1 : 1);
+	}
+	return ::mpn_cmp(a, b, an);
+}
+
+///r = a + b with signed sizes, r needs max(|as|, |bs|)+1 limbs
+size_type add_signed(mp_limb_t * r, const mp_limb_t * a, size_type as, const mp_limb_t * b, size_type bs) {
+	size_type an = abs_size(as), bn = abs_size(bs);
+	if (an < bn) {
+		std::swap(a, b);
+		std::swap(as, bs);
+		std::swap(an, bn);
+	}
+	if (!bn) {
+		std::copy(a, a+an, r);
+		return as;
+	}
+	if ((as < 0) == (bs < 0)) {
+		r[an] = ::mpn_add(r, a, an, b, bn);
+		size_type n = an + (r[an] ? 1 : 0);
+		return (as < 0 ? -n : n);
+	}
+	if (an == bn && ::mpn_cmp(a, b, an) < 0) {
+		::mpn_sub_n(r, b, a, an);
+		size_type n = normalize(r, an);
+		return (bs < 0 ? -n : n);
+	}
+	::mpn_sub(r, a, an, b, bn);
+	size_type n = normalize(r, an);
+	return (as < 0 ? -n : n);
+}
+
+///r = a * b with a, b > 0, r needs an+bn limbs and must not overlap a or b
+size_type mul_abs(mp_limb_t * r, const mp_limb_t * a, size_type an, const mp_limb_t * b, size_type bn) {
+	if (an < bn) {
+		std::swap(a, b);
+		std::swap(an, bn);
+	}
+	::mpn_mul(r, a, an, b, bn);
+	return normalize(r, an+bn);
+}
+
+///q = a / d if d divides a, q needs an-dn+1 limbs, rem is scratch space of dn limbs
+size_type divexact_abs(mp_limb_t * q, const mp_limb_t * a, size_type an, const mp_limb_t * d, size_type dn, mp_limb_t * rem) {
+	if (!an) {
+		return 0;
+	}
+	if (is_one(d, dn)) {
+		std::copy(a, a+an, q);
+		return an;
+	}
+	::mpn_tdiv_qr(q, rem, 0, a, an, d, dn);
+	return normalize(q, an-dn+1);
+}
+
+#ifdef LIBRATSS_FIXED_RATIONAL_LEHMER
+///the 62 most significant bits of {p, n} if the most significant limb of the larger operand has k leading zeros, n >= 2
+inline mp_limb_t leading_bits(const mp_limb_t * p, size_type n, int k) {
+	mp_limb_t top = (k ? (p[n-1] << k) | (p[n-2] >> (GMP_NUMB_BITS-k)) : p[n-1]);
+	return top >> 2;
+}
+#endif
+
+///r = x*a - y*b >= 0 where x and y have n limbs, r needs n+1 limbs
+inline size_type lin_comb(mp_limb_t * r, const mp_limb_t * x, const mp_limb_t * y, size_type n, mp_limb_t a, mp_limb_t b) {
+	//the result is non-negative and smaller than 2^(GMP_NUMB_BITS*(n+1)), hence the top limb may wrap around
+	r[n] = ::mpn_mul_1(r, x, n, a);
+	r[n] -= ::mpn_submul_1(r, y, n, b);
+	return normalize(r, n+1);
+}
+
+///r = A*u + B*v where A and B have opposite signs or one of them is zero
+inline size_type lin_comb(mp_limb_t * r, const mp_limb_t * u, const mp_limb_t * v, size_type n, int64_t A, int64_t B) {
+	if (B <= 0) {
+		return lin_comb(r, u, v, n, mp_limb_t(A), mp_limb_t(-B));
+	}
+	return lin_comb(r, v, u, n, mp_limb_t(B), mp_limb_t(-A));
+}
+
+inline size_type signed_size(mpz_srcptr v) {
+	size_type n = size_type(::mpz_size(v));
+	return (mpz_sgn(v) < 0 ? -n : n);
+}
+
+///g = gcd(a, b) with a, b > 0 and at most T_MAX_LIMBS limbs, g needs min(an, bn) limbs
+///Lehmer's algorithm on the 62 leading bits, see Knuth, TAOCP Vol. 2, Algorithm 4.5.2 L.
+///Without 64 bit limbs this is Euclid's algorithm.
+template<size_type T_MAX_LIMBS>
+size_type gcd_abs(mp_limb_t * g, const mp_limb_t * a, size_type an, const mp_limb_t * b, size_type bn) {
+	if (is_one(a, an) || is_one(b, bn)) {
+		g[0] = 1;
+		return 1;
+	}
+	if (cmp_abs(a, an, b, bn) < 0) {
+		std::swap(a, b);
+		std::swap(an, bn);
+	}
+	mp_limb_t buffers[4][T_MAX_LIMBS+1];
+	mp_limb_t * u = buffers[0];
+	mp_limb_t * v = buffers[1];
+	mp_limb_t * t = buffers[2];
+	mp_limb_t * s = buffers[3];
+	size_type un = an, vn = bn;
+	std::copy(a, a+an, u);
+	std::copy(b, b+bn, v);
+	std::fill(v+bn, v+an, mp_limb_t(0));
+	//u >= v and v is padded with zeros to un limbs
+	while (vn > 1) {
+		int64_t A = 1, B = 0, C = 0, D = 1;
+#ifdef LIBRATSS_FIXED_RATIONAL_LEHMER
+		int k = __builtin_clzll(u[un-1]);
+		int64_t uh = int64_t(leading_bits(u, un, k));
+		int64_t vh = int64_t(leading_bits(v, un, k));
+		while (vh + C > 0 && vh + D > 0 && uh + A >= 0 && uh + B >= 0) {
+			int64_t q = (uh + A) / (vh + C);
+			if (q != (uh + B) / (vh + D)) {
+				break;
+			}
+			int64_t tmp = A - q*C;
+			A = C;
+			C = tmp;
+			tmp = B - q*D;
+			B = D;
+			D = tmp;
+			tmp = uh - q*vh;
+			uh = vh;
+			vh = tmp;
+		}
+#endif
+		if (B == 0) {
+			//no quotient could be simulated, one multi precision step
+			::mpn_tdiv_qr(s, t, 0, u, un, v, vn);
+			std::swap(u, v);
+			std::swap(v, t);
+			un = vn;
+			vn = normalize(v, un);
+		}
+		else {
+			size_type tn = lin_comb(t, u, v, un, A, B);
+			size_type sn = lin_comb(s, u, v, un, C, D);
+			std::swap(u, t);
+			std::swap(v, s);
+			un = tn;
+			vn = sn;
+		}
+	}
+	if (!vn) {
+		std::copy(u, u+un, g);
+		return un;
+	}
+	g[0] = mp_limb_t(internal::gcd64(v[0], ::mpn_mod_1(u, un, v[0])));
+	return 1;
+}
+
+} //end namespace
+//END mpn helpers
+
+//BEGIN FixedInteger
+
+template<int T_BITS>
+FixedInteger<T_BITS>::FixedInteger() :
+m_size(0)
+{}
+
+template<int T_BITS>
+FixedInteger<T_BITS>::FixedInteger(int v) :
+FixedInteger((long long) v)
+{}
+
+template<int T_BITS>
+FixedInteger<T_BITS>::FixedInteger(long v) :
+FixedInteger((long long) v)
+{}
+
+template<int T_BITS>
+FixedInteger<T_BITS>::FixedInteger(long long v) {
+	uint64_t w = (v < 0 ? uint64_t(0) - uint64_t(v) : uint64_t(v));
+	setWords(v < 0, &w, 1);
+}
+
+template<int T_BITS>
+FixedInteger<T_BITS>::FixedInteger(unsigned long v) :
+FixedInteger((unsigned long long) v)
+{}
+
+template<int T_BITS>
+FixedInteger<T_BITS>::FixedInteger(unsigned long long v) {
+	uint64_t w = v;
+	setWords(false, &w, 1);
+}
+
+template<int T_BITS>
+FixedInteger<T_BITS>::FixedInteger(internal::int128 v) {
+	internal::uint128 absv = internal::abs128(v);
+	uint64_t w[2] = {static_cast<uint64_t>(absv), static_cast<uint64_t>(absv >> 64)};
+	setWords(v < 0, w, 2);
+}
+
+template<int T_BITS>
+FixedInteger<T_BITS>::FixedInteger(const CGAL::Gmpz & v) :
+FixedInteger(::mpz_limbs_read(v.mpz()), signed_size(v.mpz()))
+{}
+
+template<int T_BITS>
+FixedInteger<T_BITS>::FixedInteger(const mp_limb_t * limbs, mp_size_t size) {
+	mp_size_t n = normalize(limbs, abs_size(size));
+	if (n > LIMBS) {
+		throw std::overflow_error("CGAL::FixedInteger: value does not fit");
+	}
+	std::copy(limbs, limbs+n, m_limbs);
+	m_size = (size < 0 ? -n : n);
+}
+
+template<int T_BITS>
+void
+FixedInteger<T_BITS>::setWords(bool negative, const uint64_t * words, int count) {
+	constexpr int LIMBS_PER_WORD = 64 / GMP_NUMB_BITS;
+	mp_limb_t limbs[2*LIMBS_PER_WORD];
+	for(int i(0); i < count; ++i) {
+		for(int j(0); j < LIMBS_PER_WORD; ++j) {
+			limbs[i*LIMBS_PER_WORD+j] = mp_limb_t(words[i] >> (j*GMP_NUMB_BITS));
+		}
+	}
+	mp_size_t n = normalize(limbs, count*LIMBS_PER_WORD);
+	if (n > LIMBS) {
+		throw std::overflow_error("CGAL::FixedInteger: value does not fit");
+	}
+	std::copy(limbs, limbs+n, m_limbs);
+	m_size = (negative ? -n : n);
+}
+
+template<int T_BITS>
+uint32_t
+FixedInteger<T_BITS>::bits() const {
+	mpz_t view;
+	return uint32_t(::mpz_sizeinbase(mpz(view), 2));
+}
+
+template<int T_BITS>
+bool
+FixedInteger<T_BITS>::fits_int64() const {
+	mpz_t view;
+	return ::mpz_fits_slong_p(mpz(view));
+}
+
+template<int T_BITS>
+int64_t
+FixedInteger<T_BITS>::to_int64() const {
+	mpz_t view;
+	return ::mpz_get_si(mpz(view));
+}
+
+template<int T_BITS>
+double
+FixedInteger<T_BITS>::to_double() const {
+	mpz_t view;
+	return ::mpz_get_d(mpz(view));
+}
+
+template<int T_BITS>
+mpz_srcptr
+FixedInteger<T_BITS>::mpz(mpz_ptr view) const {
+	return ::mpz_roinit_n(view, m_limbs, m_size);
+}
+
+template<int T_BITS>
+CGAL::Gmpz
+FixedInteger<T_BITS>::to_gmpz() const {
+	mpz_t view;
+	CGAL::Gmpz result;
+	::mpz_set(result.mpz(), mpz(view));
+	return result;
+}
+
+template<int T_BITS>
+FixedInteger<T_BITS>
+FixedInteger<T_BITS>::operator-() const {
+	FixedInteger result(*this);
+	result.m_size = -m_size;
+	return result;
+}
+
+template<int T_BITS>
+FixedInteger<T_BITS>
+FixedInteger<T_BITS>::operator*(const FixedInteger & other) const {
+	if (!m_size || !other.m_size) {
+		return FixedInteger();
+	}
+	mp_limb_t r[2*LIMBS];
+	mp_size_t n = mul_abs(r, m_limbs, abs_size(m_size), other.m_limbs, abs_size(other.m_size));
+	return FixedInteger(r, ((m_size < 0) != (other.m_size < 0) ? -n : n));
+}
+
+template<int T_BITS>
+bool
+FixedInteger<T_BITS>::operator==(const FixedInteger & other) const {
+	return m_size == other.m_size && ::mpn_cmp(m_limbs, other.m_limbs, abs_size(m_size)) == 0;
+}
+
+template<int T_BITS>
+bool
+FixedInteger<T_BITS>::operator<(const FixedInteger & other) const {
+	if (sign() != other.sign()) {
+		return sign() < other.sign();
+	}
+	int cmp = cmp_abs(m_limbs, abs_size(m_size), other.m_limbs, abs_size(other.m_size));
+	return (m_size < 0 ? cmp > 0 : cmp < 0);
+}
+
+template<int T_BITS>
+std::ostream & operator<<(std::ostream & out, const FixedInteger<T_BITS> & v) {
+	return out << v.to_gmpz();
+}
+
+//END FixedInteger
+
+//BEGIN FixedRational
+
+template<int T_BITS>
+FixedRational<T_BITS>::FixedRational() :
+m_num(0),
+m_den(1)
+{}
+
+template<int T_BITS>
+FixedRational<T_BITS>::FixedRational(int v) :
+m_num(v),
+m_den(1)
+{}
+
+template<int T_BITS>
+FixedRational<T_BITS>::FixedRational(long v) :
+m_num(v),
+m_den(1)
+{}
+
+template<int T_BITS>
+FixedRational<T_BITS>::FixedRational(long long v) :
+m_num(v),
+m_den(1)
+{}
+
+template<int T_BITS>
+FixedRational<T_BITS>::FixedRational(double v) {
+	if (!std::isfinite(v)) {
+		throw std::domain_error("CGAL::FixedRational: value is not finite");
+	}
+	mpq_t tmp;
+	::mpq_init(tmp);
+	::mpq_set_d(tmp, v);
+	assignAndClear(tmp);
+}
+
+template<int T_BITS>
+FixedRational<T_BITS>::FixedRational(const numerator_type & n) :
+m_num(n),
+m_den(1)
+{}
+
+template<int T_BITS>
+FixedRational<T_BITS>::FixedRational(const numerator_type & n, const denominator_type & d) {
+	assign(n.limbs(), n.size(), d.limbs(), d.size());
+}
+
+template<int T_BITS>
+FixedRational<T_BITS>::FixedRational(const CGAL::Gmpz & n) :
+m_num(n),
+m_den(1)
+{}
+
+template<int T_BITS>
+FixedRational<T_BITS>::FixedRational(const CGAL::Gmpz & n, const CGAL::Gmpz & d) {
+	if (::mpz_size(n.mpz()) <= numerator_type::LIMBS && ::mpz_size(d.mpz()) <= denominator_type::LIMBS) {
+		assign(::mpz_limbs_read(n.mpz()), signed_size(n.mpz()), ::mpz_limbs_read(d.mpz()), signed_size(d.mpz()));
+	}
+	else {
+		if (!mpz_sgn(d.mpz())) {
+			throw std::domain_error("CGAL::FixedRational: division by zero");
+		}
+		mpq_t tmp;
+		::mpq_init(tmp);
+		::mpz_set(mpq_numref(tmp), n.mpz());
+		::mpz_set(mpq_denref(tmp), d.mpz());
+		assignAndClear(tmp);
+	}
+}
+
+template<int T_BITS>
+FixedRational<T_BITS>::FixedRational(mpq_srcptr v) :
+m_num(::mpz_limbs_read(mpq_numref(v)), signed_size(mpq_numref(v))),
+m_den(::mpz_limbs_read(mpq_denref(v)), signed_size(mpq_denref(v)))
+{}
+
+template<int T_BITS>
+FixedRational<T_BITS>::FixedRational(const std::string & str, int base) {
+	mpq_t tmp;
+	::mpq_init(tmp);
+	if (::mpq_set_str(tmp, str.c_str(), base) != 0 || !mpz_sgn(mpq_denref(tmp))) {
+		::mpq_clear(tmp);
+		throw std::invalid_argument("CGAL::FixedRational: invalid number " + str);
+	}
+	assignAndClear(tmp);
+}
+
+template<int T_BITS>
+FixedRational<T_BITS>
+FixedRational<T_BITS>::fromCanonical(const numerator_type & n, const denominator_type & d) {
+	FixedRational result;
+	result.m_num = n;
+	result.m_den = d;
+	return result;
+}
+
+template<int T_BITS>
+void
+FixedRational<T_BITS>::assign(const mp_limb_t * n, mp_size_t nsize, const mp_limb_t * d, mp_size_t dsize) {
+	constexpr mp_size_t LIMBS = numerator_type::LIMBS;
+	if (!dsize) {
+		throw std::domain_error("CGAL::FixedRational: division by zero");
+	}
+	if (!nsize) {
+		m_num = numerator_type();
+		m_den = denominator_type(1);
+		return;
+	}
+	bool negative = ((nsize < 0) != (dsize < 0));
+	mp_size_t nn = abs_size(nsize), dn = abs_size(dsize);
+	mp_limb_t g[LIMBS], rem[LIMBS], q[LIMBS];
+	mp_size_t gn = gcd_abs<LIMBS>(g, n, nn, d, dn);
+	mp_size_t qn = divexact_abs(q, n, nn, g, gn, rem);
+	m_num = numerator_type(q, (negative ? -qn : qn));
+	qn = divexact_abs(q, d, dn, g, gn, rem);
+	m_den = denominator_type(q, qn);
+}
+
+template<int T_BITS>
+void
+FixedRational<T_BITS>::assignAndClear(mpq_ptr v) {
+	::mpq_canonicalize(v);
+	bool fits = ::mpz_size(mpq_numref(v)) <= numerator_type::LIMBS && ::mpz_size(mpq_denref(v)) <= denominator_type::LIMBS;
+	if (fits) {
+		*this = FixedRational(v);
+	}
+	::mpq_clear(v);
+	if (!fits) {
+		throw std::overflow_error("CGAL::FixedRational: value does not fit");
+	}
+}
+
+template<int T_BITS>
+double
+FixedRational<T_BITS>::to_double() const {
+	mpq_t view;
+	return ::mpq_get_d(mpq(view));
+}
+
+template<int T_BITS>
+std::pair<double, double>
+FixedRational<T_BITS>::to_interval() const {
+	double d = to_double();
+	//mpq_get_d truncates, the result is exact for integers with at most 53 bits
+	if (m_den.size() == 1 && m_den.limbs()[0] == 1 && m_num.bits() <= uint32_t(std::numeric_limits<double>::digits)) {
+		return std::pair<double, double>(d, d);
+	}
+	if (sign() < 0) {
+		return std::pair<double, double>(std::nextafter(d, -std::numeric_limits<double>::infinity()), d);
+	}
+	return std::pair<double, double>(d, std::nextafter(d, std::numeric_limits<double>::infinity()));
+}
+
+template<int T_BITS>
+mpq_srcptr
+FixedRational<T_BITS>::mpq(mpq_ptr view) const {
+	m_num.mpz(mpq_numref(view));
+	m_den.mpz(mpq_denref(view));
+	return view;
+}
+
+template<int T_BITS>
+CGAL::Gmpq
+FixedRational<T_BITS>::to_gmpq() const {
+	mpq_t view;
+	CGAL::Gmpq result;
+	::mpq_set(result.mpq(), mpq(view));
+	return result;
+}
+
+template<int T_BITS>
+void
+FixedRational<T_BITS>::add(const FixedRational & other, bool subtract) {
+	//as in mpq_add, if gcd(b, d) == 1 then the result a*d + c*b / b*d is canonical
+	constexpr mp_size_t LIMBS = numerator_type::LIMBS;
+	constexpr mp_size_t MAX_LIMBS = 2*LIMBS+1;
+	const mp_limb_t * a = m_num.limbs();
+	const mp_limb_t * b = m_den.limbs();
+	const mp_limb_t * c = other.m_num.limbs();
+	const mp_limb_t * d = other.m_den.limbs();
+	mp_size_t as = m_num.size(), bn = m_den.size(), dn = other.m_den.size();
+	mp_size_t cs = (subtract ? -other.m_num.size() : other.m_num.size());
+	if (!cs) {
+		return;
+	}
+	if (!as) {
+		m_num = numerator_type(c, cs);
+		m_den = other.m_den;
+		return;
+	}
+	mp_limb_t t1[MAX_LIMBS], t2[MAX_LIMBS], t[MAX_LIMBS];
+	if (is_one(b, bn) && is_one(d, dn)) {
+		mp_size_t tn = add_signed(t, a, as, c, cs);
+		m_num = numerator_type(t, tn);
+		return;
+	}
+	mp_limb_t g[LIMBS];
+	mp_size_t gn = gcd_abs<LIMBS>(g, b, bn, d, dn);
+	if (is_one(g, gn)) {
+		mp_size_t t1n = mul_abs(t1, a, abs_size(as), d, dn);
+		mp_size_t t2n = mul_abs(t2, c, abs_size(cs), b, bn);
+		mp_size_t tn = add_signed(t, t1, (as < 0 ? -t1n : t1n), t2, (cs < 0 ? -t2n : t2n));
+		if (!tn) {
+			*this = FixedRational();
+			return;
+		}
+		mp_size_t t1n2 = mul_abs(t1, b, bn, d, dn);
+		m_num = numerator_type(t, tn);
+		m_den = denominator_type(t1, t1n2);
+		return;
+	}
+	mp_limb_t bg[LIMBS], dg[LIMBS], rem[LIMBS];
+	mp_size_t bgn = divexact_abs(bg, b, bn, g, gn, rem);
+	mp_size_t dgn = divexact_abs(dg, d, dn, g, gn, rem);
+	mp_size_t t1n = mul_abs(t1, a, abs_size(as), dg, dgn);
+	mp_size_t t2n = mul_abs(t2, c, abs_size(cs), bg, bgn);
+	mp_size_t ts = add_signed(t, t1, (as < 0 ? -t1n : t1n), t2, (cs < 0 ? -t2n : t2n));
+	if (!ts) {
+		*this = FixedRational();
+		return;
+	}
+	mp_size_t tn = abs_size(ts);
+	//t and bg*dg*g can only have factors of g in common
+	mp_limb_t g2[LIMBS];
+	mp_size_t g2n = gcd_abs<MAX_LIMBS>(g2, t, tn, g, gn);
+	mp_size_t numn = divexact_abs(t1, t, tn, g2, g2n, rem);
+	mp_size_t dg2n = divexact_abs(t2, d, dn, g2, g2n, rem);
+	mp_size_t denn = mul_abs(t, bg, bgn, t2, dg2n);
+	m_num = numerator_type(t1, (ts < 0 ? -numn : numn));
+	m_den = denominator_type(t, denn);
+}
+
+template<int T_BITS>
+void
+FixedRational<T_BITS>::mul(const FixedRational & other, bool divide) {
+	//a/b * c/d = (a/g1 * c/g2) / (b/g2 * d/g1) with g1 = gcd(a, d) and g2 = gcd(c, b) as in mpq_mul
+	constexpr mp_size_t LIMBS = numerator_type::LIMBS;
+	if (divide && !other.sign()) {
+		throw std::domain_error("CGAL::FixedRational: division by zero");
+	}
+	if (!sign() || !other.sign()) {
+		*this = FixedRational();
+		return;
+	}
+	bool negative = ((sign() < 0) != (other.sign() < 0));
+	const mp_limb_t * a = m_num.limbs();
+	const mp_limb_t * b = m_den.limbs();
+	const mp_limb_t * c = (divide ? other.m_den.limbs() : other.m_num.limbs());
+	const mp_limb_t * d = (divide ? other.m_num.limbs() : other.m_den.limbs());
+	mp_size_t an = abs_size(m_num.size()), bn = m_den.size();
+	mp_size_t cn = abs_size(divide ? other.m_den.size() : other.m_num.size());
+	mp_size_t dn = abs_size(divide ? other.m_num.size() : other.m_den.size());
+	mp_limb_t g[LIMBS], rem[LIMBS];
+	mp_limb_t ar[LIMBS], br[LIMBS], cr[LIMBS], dr[LIMBS];
+	mp_size_t gn = gcd_abs<LIMBS>(g, a, an, d, dn);
+	if (!is_one(g, gn)) {
+		an = divexact_abs(ar, a, an, g, gn, rem);
+		dn = divexact_abs(dr, d, dn, g, gn, rem);
+		a = ar;
+		d = dr;
+	}
+	gn = gcd_abs<LIMBS>(g, c, cn, b, bn);
+	if (!is_one(g, gn)) {
+		cn = divexact_abs(cr, c, cn, g, gn, rem);
+		bn = divexact_abs(br, b, bn, g, gn, rem);
+		c = cr;
+		b = br;
+	}
+	mp_limb_t num[2*LIMBS], den[2*LIMBS];
+	mp_size_t numn = mul_abs(num, a, an, c, cn);
+	mp_size_t denn = mul_abs(den, b, bn, d, dn);
+	m_num = numerator_type(num, (negative ? -numn : numn));
+	m_den = denominator_type(den, denn);
+}
+
+template<int T_BITS>
+FixedRational<T_BITS>
+FixedRational<T_BITS>::operator+() const {
+	return *this;
+}
+
+template<int T_BITS>
+FixedRational<T_BITS>
+FixedRational<T_BITS>::operator-() const {
+	return fromCanonical(-m_num, m_den);
+}
+
+template<int T_BITS>
+FixedRational<T_BITS> &
+FixedRational<T_BITS>::operator+=(const FixedRational & other) {
+	add(other, false);
+	return *this;
+}
+
+template<int T_BITS>
+FixedRational<T_BITS> &
+FixedRational<T_BITS>::operator-=(const FixedRational & other) {
+	add(other, true);
+	return *this;
+}
+
+template<int T_BITS>
+FixedRational<T_BITS> &
+FixedRational<T_BITS>::operator*=(const FixedRational & other) {
+	mul(other, false);
+	return *this;
+}
+
+template<int T_BITS>
+FixedRational<T_BITS> &
+FixedRational<T_BITS>::operator/=(const FixedRational & other) {
+	mul(other, true);
+	return *this;
+}
+
+template<int T_BITS>
+FixedRational<T_BITS>
+FixedRational<T_BITS>::operator+(const FixedRational & other) const {
+	FixedRational result(*this);
+	result.add(other, false);
+	return result;
+}
+
+template<int T_BITS>
+FixedRational<T_BITS>
+FixedRational<T_BITS>::operator-(const FixedRational & other) const {
+	FixedRational result(*this);
+	result.add(other, true);
+	return result;
+}
+
+template<int T_BITS>
+FixedRational<T_BITS>
+FixedRational<T_BITS>::operator*(const FixedRational & other) const {
+	FixedRational result(*this);
+	result.mul(other, false);
+	return result;
+}
+
+template<int T_BITS>
+FixedRational<T_BITS>
+FixedRational<T_BITS>::operator/(const FixedRational & other) const {
+	FixedRational result(*this);
+	result.mul(other, true);
+	return result;
+}
+
+template<int T_BITS>
+bool
+FixedRational<T_BITS>::operator==(const FixedRational & other) const {
+	return m_num == other.m_num && m_den == other.m_den;
+}
+
+template<int T_BITS>
+bool
+FixedRational<T_BITS>::operator<(const FixedRational & other) const {
+	constexpr mp_size_t LIMBS = numerator_type::LIMBS;
+	if (sign() != other.sign() || !sign()) {
+		return sign() < other.sign();
+	}
+	const mp_limb_t * b = m_den.limbs();
+	const mp_limb_t * d = other.m_den.limbs();
+	mp_size_t bn = m_den.size(), dn = other.m_den.size();
+	int cmp;
+	if (is_one(b, bn) && is_one(d, dn)) {
+		cmp = cmp_abs(m_num.limbs(), abs_size(m_num.size()), other.m_num.limbs(), abs_size(other.m_num.size()));
+	}
+	else {
+		mp_limb_t ad[2*LIMBS], cb[2*LIMBS];
+		mp_size_t adn = mul_abs(ad, m_num.limbs(), abs_size(m_num.size()), d, dn);
+		mp_size_t cbn = mul_abs(cb, other.m_num.limbs(), abs_size(other.m_num.size()), b, bn);
+		cmp = cmp_abs(ad, adn, cb, cbn);
+	}
+	return (sign() < 0 ? cmp > 0 : cmp < 0);
+}
+
+template<int T_BITS>
+std::ostream & operator<<(std::ostream & out, const FixedRational<T_BITS> & v) {
+	return out << v.to_gmpq();
+}
+
+//END FixedRational
+
+//BEGIN ExtendedInt64qTraits
+namespace internal {
+
+template<int T_BITS>
+void
+ExtendedInt64qTraits< FixedRational<T_BITS> >::simplify(type & /*v*/)
+{}
+
+template<int T_BITS>
+bool
+ExtendedInt64qTraits< FixedRational<T_BITS> >::fits_int64(const numerator_type & v) {
+	return v.fits_int64();
+}
+
+template<int T_BITS>
+int64_t
+ExtendedInt64qTraits< FixedRational<T_BITS> >::to_int64(const numerator_type & v) {
+	return v.to_int64();
+}
+
+template<int T_BITS>
+double
+ExtendedInt64qTraits< FixedRational<T_BITS> >::to_double(const type & v) {
+	return v.to_double();
+}
+
+template<int T_BITS>
+typename ExtendedInt64qTraits< FixedRational<T_BITS> >::numerator_type
+ExtendedInt64qTraits< FixedRational<T_BITS> >::numerator(const type & v) {
+	return v.numerator();
+}
+
+template<int T_BITS>
+typename ExtendedInt64qTraits< FixedRational<T_BITS> >::denominator_type
+ExtendedInt64qTraits< FixedRational<T_BITS> >::denominator(const type & v) {
+	return v.denominator();
+}
+
+template<int T_BITS>
+CGAL::ExtendedInt64z::extension_type
+ExtendedInt64qTraits< FixedRational<T_BITS> >::to_ei64z(const numerator_type & v) {
+	return v.to_gmpz();
+}
+
+template<int T_BITS>
+uint32_t
+ExtendedInt64qTraits< FixedRational<T_BITS> >::num_bits(const numerator_type & v) {
+	return v.bits();
+}
+
+template<int T_BITS>
+uint32_t
+ExtendedInt64qTraits< FixedRational<T_BITS> >::numerator_bits(const type & v) {
+	return v.numerator().bits();
+}
+
+template<int T_BITS>
+uint32_t
+ExtendedInt64qTraits< FixedRational<T_BITS> >::denominator_bits(const type & v) {
+	return v.denominator().bits();
+}
+
+template<int T_BITS>
+bool
+ExtendedInt64qTraits< FixedRational<T_BITS> >::to_int128(const type & v, int128 & numerator, int128 & denominator) {
+	if (v.numerator().bits() > 127 || v.denominator().bits() > 127) {
+		return false;
+	}
+	uint64_t words[2];
+	mpz_t view;
+	words[0] = words[1] = 0;
+	::mpz_export(words, 0, -1, sizeof(uint64_t), 0, 0, v.numerator().mpz(view));
+	numerator = join128(int64_t(words[1]), words[0]);
+	if (v.sign() < 0) {
+		numerator = -numerator;
+	}
+	words[0] = words[1] = 0;
+	::mpz_export(words, 0, -1, sizeof(uint64_t), 0, 0, v.denominator().mpz(view));
+	denominator = join128(int64_t(words[1]), words[0]);
+	return true;
+}
+
+template<int T_BITS>
+typename ExtendedInt64qTraits< FixedRational<T_BITS> >::type
+ExtendedInt64qTraits< FixedRational<T_BITS> >::make(base_type numerator, unsigned_base_type denominator) {
+	uint64_t g = gcd64(abs64(numerator), denominator);
+	uint64_t num = abs64(numerator) / g;
+	return type::fromCanonical(
+		(numerator < 0 ? -numerator_type((unsigned long long) num) : numerator_type((unsigned long long) num)),
+		denominator_type((unsigned long long) (denominator / g))
+	);
+}
+
+template<int T_BITS>
+typename ExtendedInt64qTraits< FixedRational<T_BITS> >::type
+ExtendedInt64qTraits< FixedRational<T_BITS> >::make(base_type numerator, base_type denominator) {
+	if (denominator < 0) {
+		//-INT64_MIN does not fit into int64_t
+		return -make(numerator, abs64(denominator));
+	}
+	return make(numerator, unsigned_base_type(denominator));
+}
+
+template<int T_BITS>
+typename ExtendedInt64qTraits< FixedRational<T_BITS> >::type
+ExtendedInt64qTraits< FixedRational<T_BITS> >::make(int128 numerator, int128 denominator) {
+	return type::fromCanonical(numerator_type(numerator), denominator_type(denominator));
+}
+
+template<int T_BITS>
+typename ExtendedInt64qTraits< FixedRational<T_BITS> >::type
+ExtendedInt64qTraits< FixedRational<T_BITS> >::add(int128 a, int128 b, int128 c, int128 d) {
+	return make(a, b) + make(c, d);
+}
+
+template<int T_BITS>
+typename ExtendedInt64qTraits< FixedRational<T_BITS> >::type
+ExtendedInt64qTraits< FixedRational<T_BITS> >::mul(int128 a, int128 b, int128 c, int128 d) {
+	//the fractions are already reduced, no need for the gcds of operator*
+	return type::fromCanonical(numerator_type(a) * numerator_type(c), denominator_type(b) * denominator_type(d));
+}
+
+template<int T_BITS>
+typename ExtendedInt64qTraits< FixedRational<T_BITS> >::type
+ExtendedInt64qTraits< FixedRational<T_BITS> >::mul_unreduced(int128 a, int128 b, int128 c, int128 d) {
+	return make(a, b) * make(c, d);
+}
+
+} //end namespace internal
+//END ExtendedInt64qTraits
+
+#define LIBRATSS_CGAL_FIXED_RATIONAL_INSTANTIATE(__BITS) \
+	template class FixedInteger<__BITS>; \
+	template class FixedRational<__BITS>; \
+	template std::ostream & operator<<(std::ostream &, const FixedInteger<__BITS> &); \
+	template std::ostream & operator<<(std::ostream &, const FixedRational<__BITS> &); \
+	namespace internal { template struct ExtendedInt64qTraits< FixedRational<__BITS> >; }
+
+LIBRATSS_CGAL_FIXED_RATIONAL_INSTANTIATE(256)
+LIBRATSS_CGAL_FIXED_RATIONAL_INSTANTIATE(512)
+LIBRATSS_CGAL_FIXED_RATIONAL_INSTANTIATE(1024)
+
+#undef LIBRATSS_CGAL_FIXED_RATIONAL_INSTANTIATE
+
+} //end namespace CGAL
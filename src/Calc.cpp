@@ -164,8 +164,9 @@ mpq_class fromRegContFrac(const std::vector<mpz_class> & cf) {
 	//we have a regular continous fraction in cf, let's reduce it
 	//the form is a_0 + ( 1 / (a_1 + 1 / (a_2 + 1 / (a_3 + ...))))
 	//we use the fast non-division form to reconstruct our fraction
-	mpz_class pn(cf.front()), pn1(1), pn2(0);
-	mpz_class qn(1), qn1(0), qn2(1);
+	//qn/pn is the current convergent, starting with a_0/1
+	mpz_class pn(1), pn1(1), pn2(0);
+	mpz_class qn(cf.front()), qn1(cf.front()), qn2(1);
 	for(auto it(cf.begin()+1), end(cf.end()); it != end; ++it) {
 		const mpz_class & a_i = *it;
 		pn = a_i * pn1 + pn2;
@@ -251,98 +252,9 @@ mpq_class Calc::within(const mpq_class & lower, const mpq_class & upper) const {
 }
 
 mpq_class Calc::contFrac(const mpq_class& value, int significands) const {
-	
-	if (value < 0) {
-		return -contFrac(-value, significands);
-	}
-	if (value == 0) {
-		return value;
-	}
-	mpz_class epsDenom(1);
-	epsDenom <<= significands;
-	mpq_class eps{mpz_class(1), epsDenom};
-	
-	if (value >= 1) {
-		mpz_class intPart = value.get_num() / value.get_den();
-		mpq_class remainder = value - intPart;
-		if (remainder < eps) {
-			return mpq_class(intPart);
-		}
-		return intPart + contFrac(remainder, significands);
-	}
-	//we now know that 0 < value < 1
-	
-#ifndef NDEBUG
-	std::vector<mpz_class> cf;
-#endif
-	mpz_class distUpperBoundDenom;
-	mpz_class intPart;
-	mpq_class tmp(value);
-
-	//take care of the first iteration
-	intPart = tmp.get_num() / tmp.get_den();
-	tmp -= intPart;
-	
-	if (tmp < eps) { //distance to real value is smaller than eps
-		if (intPart == 0) {
-			return mpq_class(0);
-		}
-		else {
-			return mpq_class(mpz_class(1), mpz_class(intPart));
-		}
-	}
-	
-#ifndef NDEBUG
-	cf.emplace_back( std::move(intPart) );
-#endif
-	//a_1 is now in cf, calculate a_2...
-	//eps is of the form 1/number, our bound is
-	//abs(value-p_n/q_n) < 1/(a_(n+1) * q_n**2 )
-	
-	//we have to calculate our continuous fraction on the fly in order to obey our significand as good as possible
-	#ifndef NDEBUG
-	mpz_class pn(cf.front());
-	#else
-	mpz_class pn(std::move(intPart));
-	#endif
-	mpz_class pn1(1), pn2(0);
-	mpz_class qn(1), qn1(0), qn2(1);
-
-	while(tmp > 0) {
-		tmp = 1 / tmp;
-		intPart = tmp.get_num() / tmp.get_den();
-		mpz_class qsq = cf.back()*cf.back();
-		distUpperBoundDenom = (intPart) * qsq;
-		
-		if (distUpperBoundDenom > epsDenom) {
-			break;
-		}
-		
-		tmp -= intPart;
-		#ifndef NDEBUG
-		cf.emplace_back( std::move(intPart) );
-		const mpz_class & a_i = cf.back();
-		#else
-		const mpz_class & a_i = intPart;
-		#endif
-		pn = a_i * pn1 + pn2;
-		pn2 = pn1;
-		pn1 = pn;
-		
-		qn = a_i * qn1 + qn2;
-		qn2 = qn1;
-		qn1 = qn;
-		assert(fromRegContFrac(cf) == mpq_class(qn, pn));
-		if (mpq_class(qn, pn) - value < eps) {
-			break;
-		}
-	}
-	mpq_class result(qn,pn);
-	result.canonicalize();
-	assert(fromRegContFrac(cf) == result);
-	
+	mpq_class result = ContinuedFraction(value).approximation(significands);
 	using std::abs;
-	assert( abs(result-value) <= mpq_class(mpz_class(1), epsDenom) );
+	assert( abs(result-value) <= mpq_class(mpz_class(1), mpz_class(1) << significands) );
 	return result;
 }
 
@@ -466,7 +378,6 @@ mpq_class Calc::snap(const mpfr::mpreal& v, int st, int significands) const {
 	if (st & ST_CF) {
 		if (significands < 0) {
 			mpq_class rat = Conversion<mpfr::mpreal>::toMpq(v);
-			return contFrac(rat, significands);
 			mpz_class tmp(1);
 			tmp <<= v.getPrecision();
 			mpq_class eps = mpq_class(mpz_class(1), tmp)/2;
@@ -514,10 +425,159 @@ mpq_class Calc::snap(const mpfr::mpreal& v, int st, int significands) const {
 	}
 }
 
+mpq_class Calc::snap(const mpq_class & v, int st, int significands) const {
+	if (st & ST_CF) {
+		if (significands < 0) {
+			return v;
+		}
+		return contFrac(v, significands);
+	}
+	else if (st & (ST_FX | ST_FL)) {
+		int precision = std::max<int>(2*significands, mpfr::mpreal::get_default_prec());
+		return snap(Conversion<mpq_class>::toMpreal(v, precision), st, significands);
+	}
+	else {
+		throw std::runtime_error("ratss::Calc::snap: Unsupported snap type");
+	}
+}
+
+mpq_class Calc::snap(const mpq_class & v, int st, const mpq_class & eps) const {
+	if (st & ST_CF) {
+		return within(v-eps, v+eps);
+	}
+	else {
+		throw std::runtime_error("ratss::Calc::snap: Unsupported snap type");
+	}
+}
+
 std::size_t Calc::maxBitCount(const mpq_class &v) const {
 	std::size_t sizeNum = mpz_sizeinbase(v.get_num().get_mpz_t(), 2);
 	std::size_t sizeDenom = mpz_sizeinbase(v.get_den().get_mpz_t(), 2);
 	return std::max<std::size_t>(sizeNum, sizeDenom);
 }
 
+bool Calc::absDifference(mpfr_ptr result, const mpfr::mpreal & a, const mpq_class & b) {
+	//a = m * 2^e, hence |a - b| = |m * den * 2^max(e, 0) - num * 2^max(-e, 0)| / den * 2^min(e, 0)
+	//the numerator is exact and the division truncates, no gcd is needed in contrast to mpq_class
+	mpz_class n;
+	mpfr_exp_t e = 0;
+	if (!mpfr_zero_p(a.mpfr_srcptr())) {
+		e = mpfr_get_z_2exp(n.get_mpz_t(), a.mpfr_srcptr());
+	}
+	n *= b.get_den();
+	if (e > 0) {
+		n <<= e;
+		n -= b.get_num();
+	}
+	else {
+		n -= mpz_class(b.get_num() << -e);
+	}
+	if (n == 0) {
+		mpfr_set_zero(result, 1);
+		return false;
+	}
+	n = abs(n);
+	//the quotient needs more bits than result such that truncating it costs less than an ulp of result
+	long shift = long(mpfr_get_prec(result)) + 2 + long(::mpz_sizeinbase(b.get_den_mpz_t(), 2)) - long(::mpz_sizeinbase(n.get_mpz_t(), 2));
+	shift = std::max<long>(shift, 0);
+	n <<= shift;
+	mpz_class r;
+	::mpz_tdiv_qr(n.get_mpz_t(), r.get_mpz_t(), n.get_mpz_t(), b.get_den_mpz_t());
+	int inexact = mpfr_set_z_2exp(result, n.get_mpz_t(), std::min<mpfr_exp_t>(e, 0) - shift, MPFR_RNDZ);
+	return inexact != 0 || r != 0;
+}
+
+ContinuedFraction::ContinuedFraction() :
+ContinuedFraction(mpq_class(0))
+{}
+
+ContinuedFraction::ContinuedFraction(const mpq_class & value) :
+m_sign(::sgn(value)),
+m_int(abs(value.get_num()) / value.get_den()),
+m_frac(abs(value) - m_int),
+m_significands(-1)
+{
+	reset();
+}
+
+mpq_class ContinuedFraction::approximation(int significands) {
+	if (significands < m_significands) {
+		reset();
+	}
+	m_significands = significands;
+	if (m_stage != S_EXACT) {
+		expand(significands);
+	}
+	mpq_class result(m_qn, m_pn);
+	result.canonicalize();
+	result += m_int;
+	if (m_sign < 0) {
+		result = -result;
+	}
+	return result;
+}
+
+void ContinuedFraction::reset() {
+	m_qn = 0;
+	m_pn = 1;
+	m_stage = (m_frac == 0 ? S_EXACT : S_START);
+}
+
+void ContinuedFraction::expand(int significands) {
+	using std::abs;
+	mpz_class epsDenom(1);
+	epsDenom <<= significands;
+	mpq_class eps{mpz_class(1), epsDenom};
+	
+	if (m_stage == S_START) {
+		if (m_frac < eps) { //distance to real value is smaller than eps
+			return;
+		}
+		m_tmp = m_frac;
+		m_pn1 = 1;
+		m_pn2 = 0;
+		m_qn1 = 0;
+		m_qn2 = 1;
+		m_stage = S_NEXT;
+	}
+	else if (m_stage == S_CONVERGENT) {
+		if (abs(mpq_class(m_qn, m_pn) - m_frac) < eps) {
+			return;
+		}
+		m_stage = S_NEXT;
+	}
+	
+	//eps is of the form 1/number, our bound is
+	//abs(value-p_n/q_n) < 1/(a_(n+1) * q_n**2 )
+	//we have to calculate our continuous fraction on the fly in order to obey our significand as good as possible
+	while (true) {
+		if (m_stage == S_NEXT) {
+			if (m_tmp == 0) {
+				m_stage = S_EXACT;
+				return;
+			}
+			m_tmp = 1 / m_tmp;
+			m_a = m_tmp.get_num() / m_tmp.get_den();
+			m_stage = S_QUOTIENT;
+		}
+		//m_pn1 is the denominator of the current approximation
+		if (m_a * m_pn1 * m_pn1 > epsDenom) {
+			return;
+		}
+		m_tmp -= m_a;
+		m_pn = m_a * m_pn1 + m_pn2;
+		m_pn2 = m_pn1;
+		m_pn1 = m_pn;
+		
+		m_qn = m_a * m_qn1 + m_qn2;
+		m_qn2 = m_qn1;
+		m_qn1 = m_qn;
+		if (abs(mpq_class(m_qn, m_pn) - m_frac) < eps) {
+			m_stage = S_CONVERGENT;
+			return;
+		}
+		m_stage = S_NEXT;
+	}
+}
+
 }//end namespace
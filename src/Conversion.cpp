@@ -2,6 +2,10 @@
 #include <libratss/mpreal.h>
 #include <libratss/types.h>
 
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
 namespace LIB_RATSS_NAMESPACE {
 
 //BEGIN double specializations
@@ -13,7 +17,11 @@ Conversion<double>::moveFrom(const mpq_class & v) {
 
 mpq_class
 Conversion<double>::toMpq(const type & v) {
-	return Conversion<mpfr::mpreal>::toMpq(mpfr::mpreal(v));
+	if (!std::isfinite(v)) {
+		throw std::domain_error("ratss::Conversion<double>::toMpq: value is not finite");
+	}
+	//exact and canonical
+	return mpq_class(v);
 }
 
 mpfr::mpreal
@@ -49,22 +57,41 @@ Conversion<mpfr::mpreal>::moveFrom(const mpq_class & v) {
 
 mpq_class
 Conversion<mpfr::mpreal>::toMpq(const type & v) {
-	mpf_t tmpf;
-	::mpf_init(tmpf);
-	::mpfr_get_f(tmpf, v.mpfr_srcptr(), ::mpfr_get_default_rounding_mode());
-	
-	mpq_t tmpq;
-	::mpq_init(tmpq);
-	::mpq_set_f(tmpq, tmpf);
-	
-	mpq_class result(tmpq);
-	
-	::mpf_clear(tmpf);
-	::mpq_clear(tmpq);
-
+	mpq_class result;
+	toMpq(v, result);
 	return result;
 }
 
+void
+Conversion<mpfr::mpreal>::toMpq(const type & v, mpq_class & result) {
+	if (!mpfr_number_p(v.mpfr_srcptr())) {
+		throw std::domain_error("ratss::Conversion<mpfr::mpreal>::toMpq: value is not finite");
+	}
+	mpz_ptr num = result.get_num_mpz_t();
+	mpz_ptr den = result.get_den_mpz_t();
+	::mpz_set_ui(den, 1);
+	if (mpfr_zero_p(v.mpfr_srcptr())) {
+		::mpz_set_ui(num, 0);
+		return;
+	}
+	//v = num * 2^exp exactly, the denominator is the power of two left after removing common factors
+	//This is mpfr_get_z_2exp without its reallocation of num.
+	mpfr_srcptr x = v.mpfr_srcptr();
+	mp_size_t n = (mpfr_get_prec(x) - 1) / GMP_NUMB_BITS + 1;
+	const mp_limb_t * mant = static_cast<const mp_limb_t*>(mpfr_custom_get_significand(x));
+	std::copy(mant, mant + n, ::mpz_limbs_write(num, n));
+	::mpz_limbs_finish(num, mpfr_signbit(x) ? -n : n);
+	mpfr_exp_t exp = mpfr_get_exp(x) - mpfr_exp_t(n) * GMP_NUMB_BITS;
+	if (exp >= 0) {
+		::mpz_mul_2exp(num, num, exp);
+	}
+	else {
+		mp_bitcnt_t shift = std::min<mp_bitcnt_t>(::mpz_scan1(num, 0), -exp);
+		::mpz_tdiv_q_2exp(num, num, shift);
+		::mpz_mul_2exp(den, den, -exp - shift);
+	}
+}
+
 const mpfr::mpreal &
 Conversion<mpfr::mpreal>::toMpreal(const type & v, int /*precision*/) {
 	return v;
@@ -89,7 +116,27 @@ Conversion<mpq_class>::toMpq(const Conversion<mpq_class>::type & v) {
 }
 
 mpfr::mpreal Conversion<mpq_class>::toMpreal(const type & v, int precision) {
-	return mpfr::mpreal(v.get_mpq_t(), precision);
+	mpfr::mpreal result(0, precision);
+	toMpreal(v, result.mpfr_ptr());
+	return result;
+}
+
+void Conversion<mpq_class>::toMpreal(const type & v, mpfr_ptr result) {
+	mpz_srcptr den = v.get_den_mpz_t();
+	mp_bitcnt_t shift = ::mpz_scan1(den, 0);
+	if (::mpz_sizeinbase(den, 2) == shift+1) { //den == 2^shift
+		mpfr_set_z_2exp(result, v.get_num_mpz_t(), -mpfr_exp_t(shift), mpfr_get_default_rounding_mode());
+	}
+	else {
+		mpfr_set_q(result, v.get_mpq_t(), mpfr_get_default_rounding_mode());
+	}
+}
+
+void Conversion<mpq_class>::toMpreal(const type & v, mpfr::mpreal & result, int precision) {
+	if (result.getPrecision() != precision) {
+		mpfr_set_prec(result.mpfr_ptr(), precision);
+	}
+	toMpreal(v, result.mpfr_ptr());
 }
 
 //END mpq_class specializations
@@ -0,0 +1,199 @@
+#include <libratss/Profiler.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace {
+
+///Counters of a single thread. Only the owning thread writes to them (except on reset),
+///other threads only read them during aggregation.
+struct ThreadCounters {
+	std::array<std::atomic<uint64_t>, Profiler::PS__NUMBER_OF_STAGES> calls;
+	std::array<std::atomic<uint64_t>, Profiler::PS__NUMBER_OF_STAGES> ticks;
+	std::array<std::atomic<uint64_t>, Profiler::DENOM_BITS_BUCKETS> denomBits;
+	ThreadCounters();
+	~ThreadCounters();
+	void clear();
+	void addTo(Profiler::Stats & stats) const;
+};
+
+///All live thread counters and the accumulated stats of finished threads
+struct Registry {
+	std::mutex lock;
+	std::vector<ThreadCounters*> threads;
+	Profiler::Stats finished;
+	static Registry & instance() {
+		static Registry r;
+		return r;
+	}
+};
+
+ThreadCounters::ThreadCounters() {
+	clear();
+	Registry & r = Registry::instance();
+	std::lock_guard<std::mutex> lck(r.lock);
+	r.threads.push_back(this);
+}
+
+ThreadCounters::~ThreadCounters() {
+	Registry & r = Registry::instance();
+	std::lock_guard<std::mutex> lck(r.lock);
+	addTo(r.finished);
+	r.threads.erase(std::find(r.threads.begin(), r.threads.end(), this));
+}
+
+void ThreadCounters::clear() {
+	for(std::size_t i(0); i < Profiler::PS__NUMBER_OF_STAGES; ++i) {
+		calls[i].store(0, std::memory_order_relaxed);
+		ticks[i].store(0, std::memory_order_relaxed);
+	}
+	for(auto & x : denomBits) {
+		x.store(0, std::memory_order_relaxed);
+	}
+}
+
+void ThreadCounters::addTo(Profiler::Stats & stats) const {
+	for(std::size_t i(0); i < Profiler::PS__NUMBER_OF_STAGES; ++i) {
+		stats.stages[i].calls += calls[i].load(std::memory_order_relaxed);
+		stats.stages[i].ticks += ticks[i].load(std::memory_order_relaxed);
+	}
+	for(std::size_t i(0); i < Profiler::DENOM_BITS_BUCKETS; ++i) {
+		stats.denomBits[i] += denomBits[i].load(std::memory_order_relaxed);
+	}
+}
+
+ThreadCounters & threadCounters() {
+	thread_local ThreadCounters tc;
+	return tc;
+}
+
+} //end namespace
+
+//BEGIN Profiler::Stats
+
+constexpr std::size_t Profiler::DENOM_BITS_BUCKET_WIDTH;
+constexpr std::size_t Profiler::DENOM_BITS_BUCKETS;
+
+Profiler::Stats::Stats() {
+	for(StageStats & x : stages) {
+		x.calls = 0;
+		x.ticks = 0;
+	}
+	denomBits.fill(0);
+}
+
+Profiler::Stats &
+Profiler::Stats::operator+=(const Stats & other) {
+	for(std::size_t i(0); i < PS__NUMBER_OF_STAGES; ++i) {
+		stages[i].calls += other.stages[i].calls;
+		stages[i].ticks += other.stages[i].ticks;
+	}
+	for(std::size_t i(0); i < DENOM_BITS_BUCKETS; ++i) {
+		denomBits[i] += other.denomBits[i];
+	}
+	return *this;
+}
+
+void Profiler::Stats::print(std::ostream & out) const {
+	out << "Stages:";
+	for(std::size_t i(0); i < PS__NUMBER_OF_STAGES; ++i) {
+		const StageStats & s = stages[i];
+		out << "\n\t" << toString((Stage) i) << ": calls=" << s.calls << " ticks=" << s.ticks;
+		if (s.calls) {
+			out << " ticks/call=" << s.ticks/s.calls;
+		}
+	}
+	out << "\nDenominator bits:";
+	for(std::size_t i(0); i < DENOM_BITS_BUCKETS; ++i) {
+		if (!denomBits[i]) {
+			continue;
+		}
+		out << "\n\t[" << i*DENOM_BITS_BUCKET_WIDTH << ", ";
+		if (i+1 < DENOM_BITS_BUCKETS) {
+			out << (i+1)*DENOM_BITS_BUCKET_WIDTH << "): ";
+		}
+		else {
+			out << "inf): ";
+		}
+		out << denomBits[i];
+	}
+}
+
+//END Profiler::Stats
+//BEGIN Profiler
+
+std::string Profiler::toString(Stage stage) {
+	switch (stage) {
+	case PS_SNAP:
+		return "snap";
+	case PS_NORMALIZE:
+		return "normalize";
+	case PS_SPHERE_TO_PLANE:
+		return "sphere2Plane";
+	case PS_TO_RATIONAL:
+		return "toRational";
+	case PS_PLANE_TO_SPHERE:
+		return "plane2Sphere";
+	case PS_SPHERE_TO_PLANE_TO_SPHERE:
+		return "sphere2Plane2Sphere";
+	case PS_AUTO_CANDIDATE:
+		return "auto candidate";
+	default:
+		return "invalid";
+	}
+}
+
+Profiler::Stats Profiler::stats() {
+	Registry & r = Registry::instance();
+	std::lock_guard<std::mutex> lck(r.lock);
+	Stats result(r.finished);
+	for(const ThreadCounters * tc : r.threads) {
+		tc->addTo(result);
+	}
+	return result;
+}
+
+Profiler::Stats Profiler::threadStats() {
+	Stats result;
+	threadCounters().addTo(result);
+	return result;
+}
+
+void Profiler::reset() {
+	Registry & r = Registry::instance();
+	std::lock_guard<std::mutex> lck(r.lock);
+	r.finished = Stats();
+	for(ThreadCounters * tc : r.threads) {
+		tc->clear();
+	}
+}
+
+void Profiler::record(Stage stage, uint64_t ticks) {
+	ThreadCounters & tc = threadCounters();
+	tc.calls[stage].fetch_add(1, std::memory_order_relaxed);
+	tc.ticks[stage].fetch_add(ticks, std::memory_order_relaxed);
+}
+
+void Profiler::recordDenominator(const mpq_class & v) {
+	using std::min;
+	std::size_t bits = mpz_sizeinbase(v.get_den().get_mpz_t(), 2);
+	std::size_t bucket = min(bits/DENOM_BITS_BUCKET_WIDTH, DENOM_BITS_BUCKETS-1);
+	threadCounters().denomBits[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+int & Profiler::depth() {
+	thread_local int d = 0;
+	return d;
+}
+
+//END Profiler
+
+std::ostream & operator<<(std::ostream & out, const Profiler::Stats & stats) {
+	stats.print(out);
+	return out;
+}
+
+} //end namespace LIB_RATSS_NAMESPACE
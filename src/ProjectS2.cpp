@@ -2,6 +2,10 @@
 
 namespace LIB_RATSS_NAMESPACE {
 
+void ProjectS2::toMpreal(const mpq_class & v, mpfr::mpreal & result, int precision) {
+	Conversion<mpq_class>::toMpreal(v, result, precision);
+}
+
 void ProjectS2::snap(const mpfr::mpreal& flxs, const mpfr::mpreal& flys, const mpfr::mpreal& flzs, mpq_class& xs, mpq_class& ys, mpq_class& zs, int significands, int snapType) const {
 	using ConstRefWrap = internal::ReferenceWrapper<const mpfr::mpreal>;
 	using RefWrap = internal::ReferenceWrapper<mpq_class>;
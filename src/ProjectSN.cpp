@@ -10,23 +10,37 @@ SnapConfig(ST_FX | ST_NORMALIZE | ST_PLANE, 53)
 ProjectSN::SnapConfig::SnapConfig(int st, int precision, int significands) :
 m_st(st),
 m_precision(precision),
-m_significands(significands)
+m_significands(significands),
+m_target(significands)
 {}
 
 ProjectSN::SnapConfig::SnapConfig(int st, int significands) :
 m_st(st),
 m_precision(-1),
-m_significands(significands)
+m_significands(significands),
+m_target(significands)
 {
 	if (significands < 1) {
 		throw std::underflow_error("ratss::ProjectSN::SnapConfig: significands < 1");
 	}
 }
 
+ProjectSN::SnapConfig::SnapConfig(int st, const Precision & target) :
+m_st(st),
+m_precision(-1),
+m_significands(target.maxBits),
+m_target(target)
+{
+	if (target.minBits < 1) {
+		throw std::underflow_error("ratss::ProjectSN::SnapConfig: minBits < 1");
+	}
+}
+
 ProjectSN::SnapConfig::SnapConfig(const SnapConfig & other) :
 m_st(other.m_st),
 m_precision(other.m_precision),
-m_significands(other.m_significands)
+m_significands(other.m_significands),
+m_target(other.m_target)
 {}
 
 ProjectSN::SnapConfig &
@@ -34,6 +48,7 @@ ProjectSN::SnapConfig::operator=(const SnapConfig & other) {
 	m_st = other.m_st;
 	m_precision = other.m_precision;
 	m_significands = other.m_significands;
+	m_target = other.m_target;
 	return *this;
 }
 
@@ -56,8 +71,259 @@ int ProjectSN::SnapConfig::precision(int dimensions) const {
 	}
 }
 
-int ProjectSN::SnapConfig::significands(int) const {
-	return m_significands;
+int ProjectSN::SnapConfig::significands(int dimensions) const {
+	if (m_target.fixed) {
+		return m_significands;
+	}
+	int inputPrecision = (m_precision < 0 ? std::numeric_limits<int>::max() : m_precision);
+	return ProjectSN::significands(m_st, m_target, dimensions, inputPrecision);
+}
+
+int ProjectSN::significands(int snapType, const Precision & target, std::size_t dimensions, int inputPrecision) {
+	if (target.fixed) {
+		return target.maxBits;
+	}
+	int methods = snapType;
+	if (snapType & ST_AUTO) {
+		methods >>= ST__INTERNAL_NUMBER_OF_SNAPPING_TYPES;
+	}
+	//makeFixpoint rounds to the significands before it truncates to the fixpoint
+	double coordError = ((methods & ST_FX) ? 1.5 : 1.0);
+	double factor;
+	if (snapType & ST_SPHERE) {
+		factor = 2*std::sqrt(2*double(dimensions));
+	}
+	else {
+		factor = 2*std::sqrt(double(std::max<std::size_t>(dimensions, 2)-1));
+	}
+	//the largest error of a snapped coordinate that keeps the bound
+	double eps = std::sqrt(target.maxSquaredDistance)/factor - std::ldexp(1.0, std::max<int>(-inputPrecision, -1000));
+	if (!(eps > 0)) {
+		return target.maxBits;
+	}
+	double result = std::ceil(std::log2(coordError/eps));
+	if (result >= target.maxBits) {
+		return target.maxBits;
+	}
+	return std::max<int>(target.minBits, int(result));
+}
+
+ProjectSN::Refinement::Refinement() :
+m_st(ST_NONE),
+m_significands(-1),
+m_pos(SP_INVALID)
+{}
+
+bool ProjectSN::Refinement::supports(int snapType) {
+	constexpr int unsupported = ST_PAPER | ST_JP | ST_FPLLL | ST_AUTO;
+	return !(snapType & unsupported) && (snapType & (ST_CF | ST_FX | ST_FL)) && (snapType & (ST_SPHERE | ST_PLANE));
+}
+
+const std::vector<mpq_class> & ProjectSN::Refinement::refine(int significands) {
+	if (significands < 1) {
+		throw std::underflow_error("ratss::ProjectSN::Refinement: significands < 1");
+	}
+	ProjectSN proj;
+	std::vector<mpq_class> snapped(m_coords.size());
+	{
+		Profiler::Scope scope(Profiler::PS_TO_RATIONAL);
+		for(std::size_t i(0), s(m_coords.size()); i < s; ++i) {
+			if (!(m_st & ST_CF)) {
+				snapped[i] = proj.calc().snap(m_coords[i], m_st, significands);
+			}
+			else if (m_coords[i].getPrecision() < significands) {
+				throw std::domain_error(
+					"ratss::ProjectSN::Refinement: Number of significands is " +
+					std::to_string(significands) +
+					" which is larger than the input precision which is " +
+					std::to_string(m_coords[i].getPrecision())
+				);
+			}
+			else {
+				snapped[i] = m_cf[i].approximation(significands);
+			}
+		}
+	}
+	if (m_st & ST_SPHERE) {
+		Profiler::Scope scope(Profiler::PS_SPHERE_TO_PLANE_TO_SPHERE);
+		if (proj.sphere2Plane2Sphere(snapped) == SP_INVALID) {
+			//all coordinates snapped to zero, like ProjectSN::snap there is no result
+			return m_result;
+		}
+		m_result.swap(snapped);
+	}
+	else {
+		Profiler::Scope scope(Profiler::PS_PLANE_TO_SPHERE);
+		proj.plane2Sphere(snapped.begin(), snapped.end(), m_pos, m_result.begin());
+	}
+	m_significands = significands;
+	return m_result;
+}
+
+void ProjectSN::Refinement::init() {
+	if (m_st & ST_CF) {
+		m_cf.reserve(m_coords.size());
+		for(const mpfr::mpreal & v : m_coords) {
+			m_cf.emplace_back(Conversion<mpfr::mpreal>::toMpq(v));
+		}
+	}
+	m_result.resize(m_coords.size());
+}
+
+PositionOnSphere ProjectSN::sphere2Plane2Sphere(std::vector<mpq_class> & coords) const {
+	PositionOnSphere pos = positionOnSphere(coords.begin(), coords.end());
+	if (pos == SP_INVALID) {
+		return pos;
+	}
+	std::size_t projCoord = std::abs((int) pos) - 1;
+	//coords[i] = a[i]/b with the common denominator b
+	//Unrelated denominators (i.e. from ST_CF) make b as large as their product.
+	//The rational operations then profit from reducing early, this is the case from about 6 such denominators on.
+	mpz_class b(1);
+	std::size_t maxDenomBits = 0;
+	for(const mpq_class & v : coords) {
+		::mpz_lcm(b.get_mpz_t(), b.get_mpz_t(), v.get_den_mpz_t());
+		maxDenomBits = std::max(maxDenomBits, ::mpz_sizeinbase(v.get_den_mpz_t(), 2));
+		if (::mpz_sizeinbase(b.get_mpz_t(), 2) > 5*maxDenomBits) {
+			std::vector<mpq_class> plane(coords.size());
+			pos = sphere2Plane(coords.begin(), coords.end(), plane.begin(), pos);
+			plane2Sphere(plane.begin(), plane.end(), pos, coords.begin());
+			return pos;
+		}
+	}
+	std::vector<mpz_class> a(coords.size());
+	for(std::size_t i(0), s(coords.size()); i < s; ++i) {
+		::mpz_divexact(a[i].get_mpz_t(), b.get_mpz_t(), coords[i].get_den_mpz_t());
+		a[i] *= coords[i].get_num();
+	}
+	//on the plane the coordinates are a[i]/c with c = b + |a[projCoord]|
+	mpz_class c(b);
+	if (pos < 0) {
+		c -= a[projCoord];
+	}
+	else {
+		c += a[projCoord];
+	}
+	//back on the sphere the coordinates are 2*a[i]*c/n with n = c^2 + sum_{i != projCoord} a[i]^2
+	mpz_class cc(c*c);
+	mpz_class n(cc);
+	for(std::size_t i(0), s(coords.size()); i < s; ++i) {
+		if (i != projCoord) {
+			::mpz_addmul(n.get_mpz_t(), a[i].get_mpz_t(), a[i].get_mpz_t());
+		}
+	}
+	//canonicalize 2*a[i]*c/n: with g = gcd(2c, n) and h = gcd(a[i], n/g) the result is (a[i]/h * 2c/g) / (n/(g*h))
+	//this only needs one gcd per coordinate of a[i] instead of the larger 2*a[i]*c
+	mpz_class pole(n - 2*cc);
+	if (pos > 0) {
+		::mpz_neg(pole.get_mpz_t(), pole.get_mpz_t());
+	}
+	c *= 2;
+	mpz_class g;
+	::mpz_gcd(g.get_mpz_t(), c.get_mpz_t(), n.get_mpz_t());
+	::mpz_divexact(c.get_mpz_t(), c.get_mpz_t(), g.get_mpz_t());
+	mpz_class nr;
+	::mpz_divexact(nr.get_mpz_t(), n.get_mpz_t(), g.get_mpz_t());
+	for(std::size_t i(0), s(coords.size()); i < s; ++i) {
+		mpq_class & v = coords[i];
+		if (i == projCoord) {
+			//+-(n - 2c^2)/n just like plane2Sphere
+			v.get_num().swap(pole);
+			v.get_den() = n;
+			v.canonicalize();
+			continue;
+		}
+		::mpz_gcd(g.get_mpz_t(), a[i].get_mpz_t(), nr.get_mpz_t());
+		::mpz_divexact(a[i].get_mpz_t(), a[i].get_mpz_t(), g.get_mpz_t());
+		::mpz_mul(v.get_num_mpz_t(), a[i].get_mpz_t(), c.get_mpz_t());
+		::mpz_divexact(v.get_den_mpz_t(), nr.get_mpz_t(), g.get_mpz_t());
+	}
+	return pos;
+}
+
+PositionOnSphere ProjectSN::snapPaper(std::vector<mpq_class> & coords, int snapType, int significands) const {
+	if (significands < 1) {
+		throw std::underflow_error("ratss::ProjectSN::snap: ST_PAPER needs significands > 0");
+	}
+	//the normalization is a positive factor and does not change the pole
+	PositionOnSphere pos = positionOnSphere(coords.begin(), coords.end());
+	if (pos == SP_INVALID) {
+		return pos;
+	}
+	std::size_t projCoord = std::abs((int) pos) - 1;
+	mpq_class absPole(abs(coords[projCoord]));
+	mpq_class sqLen(0);
+	{
+		Profiler::Scope scope(Profiler::PS_NORMALIZE);
+		for(const mpq_class & x : coords) {
+			sqLen += x*x;
+		}
+	}
+	//on the plane coordinate i is x_i/(len + |x_pole|).
+	//Like CORE's approx(2*significands, 2*significands) in the former implementation the snapping starts
+	//from an approximation within 2^-(2*significands) of the coordinate: the coordinate rounded to nearest with 2*significands bits.
+	const int apxPrecision = 2*significands;
+	mpfr::mpreal apx(0, apxPrecision), apxUpper(0, apxPrecision);
+	if (::mpz_perfect_square_p(sqLen.get_num_mpz_t()) && ::mpz_perfect_square_p(sqLen.get_den_mpz_t())) {
+		mpq_class denom;
+		::mpz_sqrt(denom.get_num_mpz_t(), sqLen.get_num_mpz_t());
+		::mpz_sqrt(denom.get_den_mpz_t(), sqLen.get_den_mpz_t());
+		denom += absPole;
+		Profiler::Scope scope(Profiler::PS_TO_RATIONAL);
+		for(std::size_t i(0), s(coords.size()); i < s; ++i) {
+			if (i == projCoord) {
+				coords[i] = 0;
+				continue;
+			}
+			mpfr_set_q(apx.mpfr_ptr(), mpq_class(coords[i] / denom).get_mpq_t(), MPFR_RNDN);
+			coords[i] = calc().snap(Conversion<mpfr::mpreal>::toMpq(apx), snapType, significands);
+		}
+		return pos;
+	}
+	//The coordinates are irrational, hence they are no ties of the rounding and the intervals eventually
+	//round to the same approximation at both ends. Rounding is monotone, so this is the rounding of the coordinate.
+	std::vector<std::size_t> pending;
+	for(std::size_t i(0), s(coords.size()); i < s; ++i) {
+		if (i != projCoord && coords[i] != 0) {
+			pending.push_back(i);
+		}
+	}
+	coords[projCoord] = 0;
+	int precision = apxPrecision + 32;
+	while (pending.size()) {
+		mpfr::mpreal invLower(0, precision), invUpper(0, precision), lower(0, precision), upper(0, precision);
+		{
+			Profiler::Scope scope(Profiler::PS_SPHERE_TO_PLANE);
+			mpfr_set_q(lower.mpfr_ptr(), sqLen.get_mpq_t(), MPFR_RNDD);
+			mpfr_sqrt(lower.mpfr_ptr(), lower.mpfr_srcptr(), MPFR_RNDD);
+			mpfr_add_q(lower.mpfr_ptr(), lower.mpfr_srcptr(), absPole.get_mpq_t(), MPFR_RNDD);
+			mpfr_ui_div(invUpper.mpfr_ptr(), 1, lower.mpfr_srcptr(), MPFR_RNDU);
+			mpfr_set_q(upper.mpfr_ptr(), sqLen.get_mpq_t(), MPFR_RNDU);
+			mpfr_sqrt(upper.mpfr_ptr(), upper.mpfr_srcptr(), MPFR_RNDU);
+			mpfr_add_q(upper.mpfr_ptr(), upper.mpfr_srcptr(), absPole.get_mpq_t(), MPFR_RNDU);
+			mpfr_ui_div(invLower.mpfr_ptr(), 1, upper.mpfr_srcptr(), MPFR_RNDD);
+		}
+		Profiler::Scope scope(Profiler::PS_TO_RATIONAL);
+		std::size_t numPending = 0;
+		for(std::size_t i : pending) {
+			const mpq_class & x = coords[i];
+			bool positive = (x > 0);
+			mpfr_mul_q(lower.mpfr_ptr(), (positive ? invLower : invUpper).mpfr_srcptr(), x.get_mpq_t(), MPFR_RNDD);
+			mpfr_mul_q(upper.mpfr_ptr(), (positive ? invUpper : invLower).mpfr_srcptr(), x.get_mpq_t(), MPFR_RNDU);
+			mpfr_set(apx.mpfr_ptr(), lower.mpfr_srcptr(), MPFR_RNDN);
+			mpfr_set(apxUpper.mpfr_ptr(), upper.mpfr_srcptr(), MPFR_RNDN);
+			if (mpfr_equal_p(apx.mpfr_srcptr(), apxUpper.mpfr_srcptr())) {
+				coords[i] = calc().snap(Conversion<mpfr::mpreal>::toMpq(apx), snapType, significands);
+			}
+			else {
+				pending[numPending] = i;
+				++numPending;
+			}
+		}
+		pending.resize(numPending);
+		precision *= 2;
+	}
+	return pos;
 }
 
 std::string ProjectSN::toString(ProjectSN::SnapType st) {
@@ -66,10 +332,12 @@ std::string ProjectSN::toString(ProjectSN::SnapType st) {
 	
 	PRINT_FIELD_NAME(ST_SPHERE)
 	PRINT_FIELD_NAME(ST_PLANE)
+	PRINT_FIELD_NAME(ST_PAPER)
 	PRINT_FIELD_NAME(ST_CF)
 	PRINT_FIELD_NAME(ST_FX)
 	PRINT_FIELD_NAME(ST_FL)
 	PRINT_FIELD_NAME(ST_JP)
+	PRINT_FIELD_NAME(ST_FPLLL)
 	PRINT_FIELD_NAME(ST_NORMALIZE)
 	
 	if (result.size()) {
@@ -78,4 +346,25 @@ std::string ProjectSN::toString(ProjectSN::SnapType st) {
 	return result;
 }
 
+int ProjectSN::symmetries(int snapType) {
+	//Every coordinate is snapped on its own by an odd function, sphere2Plane and plane2Sphere
+	//only depend on the magnitude of the pole and the normalization is done before canonicalizing.
+	//Jacobi-Perron and lll mix the coordinates, ST_PAPER is not covered.
+	constexpr int nonSymmetric = ST_PAPER | ST_JP | ST_FPLLL | ST_AUTO_JP | ST_AUTO_FPLLL;
+	int methods = ST_CF | ST_FX | ST_FL;
+	if (snapType & ST_AUTO) {
+		methods <<= ST__INTERNAL_NUMBER_OF_SNAPPING_TYPES;
+	}
+	if ((snapType & nonSymmetric) || !(snapType & methods)) {
+		return SY_NONE;
+	}
+	if (snapType & ST_SPHERE) {
+		return SY_SIGNS;
+	}
+	if (snapType & ST_PLANE) {
+		return SY_ALL;
+	}
+	return SY_NONE;
+}
+
 }//end namespace LIB_RATSS_NAMESPACE
\ No newline at end of file
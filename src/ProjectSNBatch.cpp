@@ -0,0 +1,113 @@
+#include <libratss/ProjectSNBatch.h>
+
+#include <cmath>
+#include <stdexcept>
+
+//With LIBRATSS_WITH_SIMD_CLONES the row kernels are compiled for AVX-512, AVX2 and the baseline,
+//the dynamic loader picks the best one the cpu supports.
+#if defined(LIB_RATSS_WITH_SIMD_CLONES) && defined(__x86_64__)
+	#define LIB_RATSS_ROW_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+	#define LIB_RATSS_ROW_KERNEL
+#endif
+
+namespace LIB_RATSS_NAMESPACE {
+namespace {
+
+///updates the coordinate with the largest absolute value by row i
+LIB_RATSS_ROW_KERNEL
+void maxAbsRow(const double * x, int32_t i, std::size_t n, double * maxAbs, double * pole, int32_t * poleIndex) {
+	for(std::size_t j(0); j < n; ++j) {
+		double a = std::abs(x[j]);
+		bool larger = a > maxAbs[j];
+		maxAbs[j] = (larger ? a : maxAbs[j]);
+		pole[j] = (larger ? x[j] : pole[j]);
+		poleIndex[j] = (larger ? i : poleIndex[j]);
+	}
+}
+
+///1 + x for a positive pole and 1 - x for a negative one
+LIB_RATSS_ROW_KERNEL
+void denomRow(const double * pole, const int32_t * poleIndex, std::size_t n, double * denom, int32_t * pos) {
+	for(std::size_t j(0); j < n; ++j) {
+		denom[j] = 1.0 + denom[j];
+		pos[j] = (pole[j] > 0 ? poleIndex[j]+1 : -(poleIndex[j]+1));
+	}
+}
+
+LIB_RATSS_ROW_KERNEL
+void divideRow(const double * x, const double * denom, std::size_t n, double * plane) {
+	for(std::size_t j(0); j < n; ++j) {
+		plane[j] = x[j] / denom[j];
+	}
+}
+
+}//end namespace
+
+ProjectSNBatch::ProjectSNBatch(int dimension) :
+m_size(0),
+m_coords(dimension),
+m_plane(dimension)
+{
+	if (dimension < 1) {
+		throw std::domain_error("ratss::ProjectSNBatch: dimension < 1");
+	}
+}
+
+void ProjectSNBatch::resize(std::size_t size) {
+	m_size = size;
+	for(std::vector<double> & row : m_coords) {
+		row.resize(size);
+	}
+	for(std::vector<double> & row : m_plane) {
+		row.clear();
+	}
+	m_denom.clear();
+	m_pos.clear();
+	m_order.clear();
+}
+
+void ProjectSNBatch::sphere2Plane() {
+	const std::size_t n = m_size;
+	const int d = dimension();
+	//the signed coordinate with the largest absolute value, the first one wins on ties just like in ProjectSN::positionOnSphere
+	std::vector<double> pole(n, 0.0);
+	std::vector<int32_t> poleIndex(n, -1);
+	m_denom.assign(n, 0.0);
+	for(int i(0); i < d; ++i) {
+		maxAbsRow(m_coords[i].data(), i, n, m_denom.data(), pole.data(), poleIndex.data());
+	}
+	m_pos.resize(n);
+	denomRow(pole.data(), poleIndex.data(), n, m_denom.data(), m_pos.data());
+	for(int i(0); i < d; ++i) {
+		m_plane[i].resize(n);
+		divideRow(m_coords[i].data(), m_denom.data(), n, m_plane[i].data());
+	}
+	//the coordinate of the pole is zero on the plane
+	for(std::size_t j(0); j < n; ++j) {
+		if (poleIndex[j] >= 0) {
+			m_plane[poleIndex[j]][j] = 0.0;
+		}
+	}
+	//group the points by position
+	std::vector<uint32_t> offsets(2*d+2, 0);
+	for(int32_t pos : m_pos) {
+		++offsets[pos+d+1];
+	}
+	for(std::size_t k(1); k < offsets.size(); ++k) {
+		offsets[k] += offsets[k-1];
+	}
+	m_order.resize(n);
+	for(std::size_t j(0); j < n; ++j) {
+		m_order[offsets[m_pos[j]+d]++] = uint32_t(j);
+	}
+}
+
+void ProjectSNBatch::checkSnapType(int snapType) {
+	constexpr int unsupported = ProjectSN::ST_SPHERE | ProjectSN::ST_PAPER | ProjectSN::ST_JP | ProjectSN::ST_FPLLL | ProjectSN::ST_AUTO | ProjectSN::ST_NORMALIZE;
+	if (!(snapType & ProjectSN::ST_PLANE) || (snapType & unsupported) || !(snapType & (ProjectSN::ST_CF | ProjectSN::ST_FX | ProjectSN::ST_FL))) {
+		throw std::runtime_error("ratss::ProjectSNBatch::snap: Unsupported snap type");
+	}
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
@@ -0,0 +1,211 @@
+#include <libratss/SnapSize.h>
+
+#include <cmath>
+#include <stdexcept>
+
+namespace LIB_RATSS_NAMESPACE {
+
+SnapSize::Distribution::Distribution() :
+m_size(0),
+m_unbounded(0)
+{}
+
+void SnapSize::Distribution::add(const Bits & bits) {
+	++m_size;
+	if (!bits.bounded()) {
+		++m_unbounded;
+		m_max = Bits::unbounded();
+		return;
+	}
+	std::size_t b = std::size_t(bits.max());
+	if (m_count.size() <= b) {
+		m_count.resize(b+1, 0);
+	}
+	++m_count[b];
+	if (m_max.bounded()) {
+		m_max.numerator = std::max(m_max.numerator, bits.numerator);
+		m_max.denominator = std::max(m_max.denominator, bits.denominator);
+	}
+}
+
+std::size_t SnapSize::Distribution::count(int bits) const {
+	if (bits < 0 || std::size_t(bits) >= m_count.size()) {
+		return 0;
+	}
+	return m_count[bits];
+}
+
+double SnapSize::Distribution::fraction(int bits) const {
+	if (!m_size) {
+		return 0;
+	}
+	std::size_t fitting = 0;
+	for(int b(0); b <= bits && std::size_t(b) < m_count.size(); ++b) {
+		fitting += m_count[b];
+	}
+	return double(fitting)/double(m_size);
+}
+
+int SnapSize::Distribution::quantile(double q) const {
+	std::size_t needed = std::size_t(std::ceil(q*double(m_size)));
+	std::size_t fitting = 0;
+	if (!needed) {
+		return 0;
+	}
+	for(std::size_t b(0); b < m_count.size(); ++b) {
+		fitting += m_count[b];
+		if (fitting >= needed) {
+			return int(b);
+		}
+	}
+	return -1;
+}
+
+SnapSize::SnapSize() {}
+
+SnapSize::Bits SnapSize::bound(const ProjectSN::SnapConfig & sc, int dimensions) {
+	return bound(sc.snapType(), significands(sc, dimensions), dimensions, nullptr);
+}
+
+int SnapSize::snapTypes(int snapType) {
+	constexpr int methods = ProjectSN::ST_CF | ProjectSN::ST_FX | ProjectSN::ST_FL | ProjectSN::ST_JP | ProjectSN::ST_FPLLL;
+	if (snapType & ProjectSN::ST_AUTO) {
+		int candidates = (snapType >> ProjectSN::ST__INTERNAL_NUMBER_OF_SNAPPING_TYPES) & methods;
+		//without candidates ProjectSN::snap uses ST_FX
+		return (candidates ? candidates : int(ProjectSN::ST_FX));
+	}
+	return snapType & methods;
+}
+
+int SnapSize::significands(const ProjectSN::SnapConfig & sc, int dimensions) {
+	if (dimensions < 1) {
+		throw std::domain_error("ratss::SnapSize::bound: dimensions < 1");
+	}
+	int result = (sc.target().fixed ? sc.significands(dimensions) : sc.target().maxBits);
+	if (result < 1) {
+		throw std::underflow_error("ratss::SnapSize::bound: significands < 1");
+	}
+	return result;
+}
+
+SnapSize::Bits SnapSize::bound(int snapType, int significands, int dimensions, const std::vector<Coordinate> * coords) {
+	int methods = snapTypes(snapType);
+	//ProjectSN::snapPaper does not support auto snapping
+	bool unsupported = (snapType & ProjectSN::ST_PAPER) && (snapType & ProjectSN::ST_AUTO);
+	if (!methods || unsupported || !(snapType & (ProjectSN::ST_SPHERE | ProjectSN::ST_PLANE | ProjectSN::ST_PAPER))) {
+		throw std::runtime_error("ratss::SnapSize::bound: Unsupported snap type");
+	}
+	//ST_PAPER snaps on the plane even if ST_SPHERE is set
+	bool sphere = (snapType & ProjectSN::ST_SPHERE) && !(snapType & ProjectSN::ST_PAPER);
+	int count = (sphere ? dimensions : dimensions-1);
+
+	//the snapped coordinates x_i = a_i/b are projected onto the sphere by 2 a_i b / n and (b^2 - sum a_i^2) / n
+	//with n = b^2 + sum a_i^2, the denominators divide n and the numerators are at most n.
+	//ST_SPHERE projects onto the plane first, this adds |x_p| b to b where x_p is the projection coordinate.
+	//factor bounds n/b^2, every snapped coordinate is off by at most 1.5 * 2^-significands
+	double err = std::ldexp(1.5, -significands);
+	double factor;
+	if (!coords) {
+		if (sphere) {
+			//1 + 2|x_p| + sum x_i^2 on the unit sphere
+			double len = 1 + std::sqrt(double(dimensions))*err;
+			factor = 1 + 2*(1+err) + len*len;
+		}
+		else {
+			//the projection coordinate is the largest one, hence the other ones are at most 1/2 on the plane
+			factor = 1 + count*(0.5+err)*(0.5+err);
+		}
+	}
+	else {
+		double sq = 0;
+		double largest = 0;
+		for(const Coordinate & c : *coords) {
+			double m = (c.zero ? 0 : c.magnitude) + err;
+			sq += m*m;
+			largest = std::max(largest, m);
+		}
+		factor = 1 + sq + (sphere ? 2*largest : 0);
+	}
+	//rounding of the doubles and of the normalization in case of ST_PAPER
+	factor *= 1 + std::ldexp(1.0, -20);
+
+	long denomBits = 0;
+	for(int st : {ProjectSN::ST_CF, ProjectSN::ST_FX, ProjectSN::ST_FL, ProjectSN::ST_JP, ProjectSN::ST_FPLLL}) {
+		if (methods & st) {
+			long b = denominatorBits(st, snapType, significands, count, coords);
+			if (b < 0) {
+				return Bits::unbounded();
+			}
+			denomBits = std::max(denomBits, b);
+		}
+	}
+	int result = int(2*denomBits + std::ilogb(factor) + 1);
+	return Bits(result, result);
+}
+
+long SnapSize::denominatorBits(int st, int snapType, int significands, int count, const std::vector<Coordinate> * coords) {
+	//ST_PAPER snaps the exact coordinates whose exponents may be one smaller than the ones of the approximation
+	bool paper = snapType & ProjectSN::ST_PAPER;
+	long s = significands;
+	long result = 0;
+	switch (st) {
+	case ProjectSN::ST_FX:
+		//the coordinates are multiples of 2^-s, but Calc::makeFixpoint keeps 2 bits of coordinates close to 2^-s
+		if (!coords) {
+			return s+2;
+		}
+		for(const Coordinate & c : *coords) {
+			//rounding to s bits may increase the exponent by one, smaller coordinates are snapped to zero
+			if (c.zero || c.exponent + (paper ? 1 : 0) < -s-1) {
+				continue;
+			}
+			result = std::max<long>(result, std::max<long>(s, 2 - (c.exponent - (paper ? 1 : 0))));
+		}
+		return std::min(result, s+2);
+	case ProjectSN::ST_CF:
+		//the first convergent closer than 2^-s has a denominator of at most 2^s and of at most the one of the coordinate
+		if (!coords) {
+			return count*s;
+		}
+		for(const Coordinate & c : *coords) {
+			//|x| < 2^exponent, coordinates smaller than 2^-s are snapped to zero
+			if (c.zero || c.exponent <= -s - (paper ? 1 : 0)) {
+				continue;
+			}
+			result += (paper ? s : std::min<long>(s, std::max<long>(c.precision - c.exponent, 0)));
+		}
+		return result;
+	case ProjectSN::ST_FL:
+		if (!coords) {
+			return -1;
+		}
+		//x = m 2^exponent with 0.5 <= |m| < 1 is rounded to min(s, precision) bits
+		for(const Coordinate & c : *coords) {
+			if (c.zero) {
+				continue;
+			}
+			long bits = (paper ? s - (c.exponent - 1) : std::min<long>(s, c.precision) - c.exponent);
+			result = std::max(result, bits);
+		}
+		return result;
+	case ProjectSN::ST_JP:
+		if (paper || count != 2) {
+			throw std::domain_error("ratss::SnapSize::bound: Snapping with jacobiPerron only supports 2 coordinates");
+		}
+		if (!coords) {
+			return -1;
+		}
+		//the convergents have a denominator of at most the common denominator of the input,
+		//if the simultaneous approximation fails then single coordinates are snapped by continued fractions
+		for(const Coordinate & c : *coords) {
+			if (!c.zero) {
+				result = std::max<long>(result, c.precision - c.exponent);
+			}
+		}
+		return result + std::max(result, s);
+	default: //ST_FPLLL
+		return -1;
+	}
+}
+
+}//end namespace LIB_RATSS_NAMESPACE
@@ -0,0 +1,235 @@
+#include <libratss/SpherePredicates.h>
+
+#include <assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace LIB_RATSS_NAMESPACE {
+
+//BEGIN SpherePoint
+
+SpherePoint::SpherePoint() :
+m_c{{0, 0, 0, 1}}
+{
+	init();
+}
+
+SpherePoint::SpherePoint(const mpz_class & x, const mpz_class & y, const mpz_class & z, const mpz_class & w) :
+m_c{{x, y, z, w}}
+{
+	if (w <= 0) {
+		throw std::domain_error("ratss::SpherePoint: w has to be positive");
+	}
+	init();
+}
+
+SpherePoint::SpherePoint(const mpq_class & x, const mpq_class & y, const mpq_class & z) {
+	mpz_class & w = m_c[3];
+	::mpz_lcm(w.get_mpz_t(), x.get_den_mpz_t(), y.get_den_mpz_t());
+	::mpz_lcm(w.get_mpz_t(), w.get_mpz_t(), z.get_den_mpz_t());
+	const mpq_class * coords[3] = {&x, &y, &z};
+	for(int i(0); i < 3; ++i) {
+		::mpz_divexact(m_c[i].get_mpz_t(), w.get_mpz_t(), coords[i]->get_den_mpz_t());
+		m_c[i] *= coords[i]->get_num();
+	}
+	init();
+}
+
+bool SpherePoint::isOnSphere() const {
+	return x()*x() + y()*y() + z()*z() == w()*w();
+}
+
+void SpherePoint::init() {
+	m_bits = 0;
+	for(int i(0); i < 4; ++i) {
+		m_bits = std::max<int>(m_bits, ::mpz_sizeinbase(m_c[i].get_mpz_t(), 2));
+		m_d[i] = m_c[i].get_d();
+	}
+	if (m_bits <= SpherePredicates::MAX_WORD_BITS) {
+		for(int i(0); i < 4; ++i) {
+			m_i[i] = ::mpz_get_si(m_c[i].get_mpz_t());
+		}
+	}
+}
+
+//END SpherePoint
+
+//BEGIN filters and exact stages
+namespace {
+
+thread_local SpherePredicates::Stage threadLastStage = SpherePredicates::S_DOUBLE;
+
+///largest coordinate bit size for which the double filters cannot overflow
+constexpr int MAX_FILTER_BITS = 250;
+
+//Error bounds in multiples of 2^-53 * 2^(d*bits) with d the degree of the determinant.
+//The coordinates are converted by mpz_get_d which truncates, hence each has a relative error below 2u.
+//Every elementary product passes through 5 (det3) resp. 10 (det4) roundings in the evaluation order of det3 and det4,
+//so its relative error is at most gamma_5 + 6u resp. gamma_10 + 8u to first order.
+//There are 6 resp. 24 elementary products bounded by 2^(d*bits) which gives 66u resp. 432u plus higher order terms.
+constexpr double DET3_ERROR = 67.0;
+constexpr double DET4_ERROR = 433.0;
+
+///@return 0 if the filter fails
+int filtered(double det, double error, int degree, int bits) {
+	double bound = std::ldexp(error, degree*bits - std::numeric_limits<double>::digits);
+	return (det > bound ? 1 : (det < -bound ? -1 : 0));
+}
+
+///det(p, q, r) of the first three coordinates
+template<typename T>
+T det3(const std::array<T, 4> & p, const std::array<T, 4> & q, const std::array<T, 4> & r) {
+	return p[0]*(q[1]*r[2] - q[2]*r[1]) + p[1]*(q[2]*r[0] - q[0]*r[2]) + p[2]*(q[0]*r[1] - q[1]*r[0]);
+}
+
+///det(p, q, r, s) by expansion along the 2x2 minors of p, q and r, s
+template<typename T>
+T det4(const std::array<T, 4> & p, const std::array<T, 4> & q, const std::array<T, 4> & r, const std::array<T, 4> & s) {
+	auto m = [](const std::array<T, 4> & a, const std::array<T, 4> & b, int i, int j) -> T {
+		return a[i]*b[j] - a[j]*b[i];
+	};
+	return m(p, q, 0, 1)*m(r, s, 2, 3) - m(p, q, 0, 2)*m(r, s, 1, 3) + m(p, q, 0, 3)*m(r, s, 1, 2)
+		+ m(p, q, 1, 2)*m(r, s, 0, 3) - m(p, q, 1, 3)*m(r, s, 0, 2) + m(p, q, 2, 3)*m(r, s, 0, 1);
+}
+
+#ifdef __SIZEOF_INT128__
+
+using int128 = __int128;
+using uint128 = unsigned __int128;
+
+///two's complement 256 bit integer, additions wrap around
+class Int256 {
+public:
+	Int256() : m_low(0), m_high(0) {}
+	///exact product of a and b, |a|, |b| < 2^127
+	static Int256 mul(int128 a, int128 b) {
+		uint128 x = (a < 0 ? -uint128(a) : uint128(a));
+		uint128 y = (b < 0 ? -uint128(b) : uint128(b));
+		uint64_t x0 = uint64_t(x), x1 = uint64_t(x >> 64), y0 = uint64_t(y), y1 = uint64_t(y >> 64);
+		uint128 p00 = uint128(x0)*y0;
+		uint128 p01 = uint128(x0)*y1;
+		uint128 p10 = uint128(x1)*y0;
+		uint128 mid = (p00 >> 64) + uint64_t(p01) + uint64_t(p10);
+		Int256 result;
+		result.m_low = (mid << 64) | uint64_t(p00);
+		result.m_high = uint128(x1)*y1 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+		return ((a < 0) != (b < 0) ? -result : result);
+	}
+	Int256 operator-() const {
+		Int256 result;
+		result.m_low = ~m_low + 1;
+		result.m_high = ~m_high + (result.m_low == 0 ? 1 : 0);
+		return result;
+	}
+	Int256 & operator+=(const Int256 & other) {
+		m_low += other.m_low;
+		m_high += other.m_high + (m_low < other.m_low ? 1 : 0);
+		return *this;
+	}
+	Int256 & operator-=(const Int256 & other) {
+		return *this += -other;
+	}
+	///only meaningful if the exact value is smaller than 2^255
+	int sign() const {
+		if (m_high >> 127) {
+			return -1;
+		}
+		return ((m_high | m_low) ? 1 : 0);
+	}
+private:
+	uint128 m_low;
+	uint128 m_high;
+};
+
+///|det| < 6 * 2^189, all intermediate values are exact
+int det3Sign(const std::array<int64_t, 4> & p, const std::array<int64_t, 4> & q, const std::array<int64_t, 4> & r) {
+	auto m = [&q, &r](int i, int j) -> int128 {
+		return int128(q[i])*r[j] - int128(q[j])*r[i];
+	};
+	Int256 result(Int256::mul(p[0], m(1, 2)));
+	result -= Int256::mul(p[1], m(0, 2));
+	result += Int256::mul(p[2], m(0, 1));
+	return result.sign();
+}
+
+///The 2x2 minors are exact, the sum of their products wraps around.
+///|det| <= 4 * 2^252 by Hadamard's inequality since |(x, y, z, w)| = sqrt(2) * w for points on the sphere.
+///Only valid for points on the sphere: other points may have rows of norm 2^64 and the sum may wrap around.
+int det4Sign(const std::array<int64_t, 4> & p, const std::array<int64_t, 4> & q, const std::array<int64_t, 4> & r, const std::array<int64_t, 4> & s) {
+	auto m = [](const std::array<int64_t, 4> & a, const std::array<int64_t, 4> & b, int i, int j) -> int128 {
+		return int128(a[i])*b[j] - int128(a[j])*b[i];
+	};
+	Int256 result(Int256::mul(m(p, q, 0, 1), m(r, s, 2, 3)));
+	result -= Int256::mul(m(p, q, 0, 2), m(r, s, 1, 3));
+	result += Int256::mul(m(p, q, 0, 3), m(r, s, 1, 2));
+	result += Int256::mul(m(p, q, 1, 2), m(r, s, 0, 3));
+	result -= Int256::mul(m(p, q, 1, 3), m(r, s, 0, 2));
+	result += Int256::mul(m(p, q, 2, 3), m(r, s, 0, 1));
+	return result.sign();
+}
+
+#endif
+
+} //end namespace
+//END filters and exact stages
+
+//BEGIN SpherePredicates
+
+constexpr int SpherePredicates::MAX_WORD_BITS;
+
+int SpherePredicates::orientation(const SpherePoint & p, const SpherePoint & q, const SpherePoint & r) {
+	//w > 0, hence the sign of the homogeneous determinant is the sign of the rational one
+	int bits = std::max({p.bits(), q.bits(), r.bits()});
+	if (bits <= MAX_FILTER_BITS) {
+		int result = filtered(det3(p.m_d, q.m_d, r.m_d), DET3_ERROR, 3, bits);
+		if (result) {
+			threadLastStage = S_DOUBLE;
+			return result;
+		}
+	}
+#ifdef __SIZEOF_INT128__
+	if (bits <= MAX_WORD_BITS) {
+		threadLastStage = S_INT128;
+		return det3Sign(p.m_i, q.m_i, r.m_i);
+	}
+#endif
+	threadLastStage = S_GMP;
+	return ::sgn(det3(p.m_c, q.m_c, r.m_c));
+}
+
+int SpherePredicates::sideOfGreatCircle(const SpherePoint & a, const SpherePoint & b, const SpherePoint & p) {
+	return orientation(a, b, p);
+}
+
+int SpherePredicates::inCircle(const SpherePoint & p, const SpherePoint & q, const SpherePoint & r, const SpherePoint & s) {
+	//The points are on the circle through p, q, r iff they are on the plane through p, q, r.
+	//det(q-p, r-p, s-p) = -det((p, 1), (q, 1), (r, 1), (s, 1)) and scaling the rows by w > 0 keeps the sign.
+	assert(p.isOnSphere() && q.isOnSphere() && r.isOnSphere() && s.isOnSphere());
+	int bits = std::max({p.bits(), q.bits(), r.bits(), s.bits()});
+	if (bits <= MAX_FILTER_BITS) {
+		int result = filtered(det4(p.m_d, q.m_d, r.m_d, s.m_d), DET4_ERROR, 4, bits);
+		if (result) {
+			threadLastStage = S_DOUBLE;
+			return -result;
+		}
+	}
+#ifdef __SIZEOF_INT128__
+	if (bits <= MAX_WORD_BITS) {
+		threadLastStage = S_INT128;
+		return -det4Sign(p.m_i, q.m_i, r.m_i, s.m_i);
+	}
+#endif
+	threadLastStage = S_GMP;
+	return -::sgn(det4(p.m_c, q.m_c, r.m_c, s.m_c));
+}
+
+SpherePredicates::Stage SpherePredicates::lastStage() {
+	return threadLastStage;
+}
+
+//END SpherePredicates
+
+} //end namespace LIB_RATSS_NAMESPACE
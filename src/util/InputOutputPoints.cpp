@@ -11,53 +11,120 @@ void FloatPoint::setPrecision(int precision) {
 		v.setPrecision(precision, MPFR_RNDZ);
 	}
 }
-void FloatPoint::assign(std::istream & is, Format fmt, int precision, int dimension) {
+namespace {
+
+///Gives std::istream the interface of Tokenizer used for reading points
+class IStreamSource {
+public:
+	explicit IStreamSource(std::istream & is) : m_is(is) {}
+	bool lineEnd() { return !(m_is.good() && m_is.peek() != '\n'); }
+	template<typename T>
+	void read(T & v) { m_is >> v; }
+private:
+	std::istream & m_is;
+};
+
+template<typename T_SOURCE>
+void assignFloatPoint(FloatPoint & p, T_SOURCE & src, PointBase::Format fmt, int precision, int dimension) {
+	auto & coords = p.coords;
 	coords.clear();
-	if (fmt == FM_CARTESIAN_FLOAT || fmt == FM_CARTESIAN_FLOAT128) {
-		while (is.good() && is.peek() != '\n' && (int) coords.size() != dimension) {
+	if (fmt == PointBase::FM_CARTESIAN_FLOAT || fmt == PointBase::FM_CARTESIAN_FLOAT128) {
+		while (!src.lineEnd() && (int) coords.size() != dimension) {
 			mpfr::mpreal tmp;
-			is >> tmp;
+			src.read(tmp);
 			coords.emplace_back( std::move(tmp) );
 		}
 	}
-	else if (fmt == FM_CARTESIAN_RATIONAL) {
+	else if (fmt == PointBase::FM_CARTESIAN_RATIONAL) {
 		mpq_class tmp;
-		while (is.good() && is.peek() != '\n' && (int) coords.size() != dimension) {
-			is >> tmp;
-			coords.emplace_back( Conversion<mpq_class>::toMpreal(tmp, precision) );
+		while (!src.lineEnd() && (int) coords.size() != dimension) {
+			src.read(tmp);
+			coords.emplace_back();
+			Conversion<mpq_class>::toMpreal(tmp, coords.back(), precision);
 		}
 	}
-	else if (fmt == FM_CARTESIAN_SPLIT_RATIONAL) {
+	else if (fmt == PointBase::FM_CARTESIAN_SPLIT_RATIONAL) {
 		mpz_class num, denom;
 		mpq_class tmp;
-		while (is.good() && is.peek() != '\n' && (int) coords.size() != dimension) {
-			is >> num >> denom;
+		while (!src.lineEnd() && (int) coords.size() != dimension) {
+			src.read(num);
+			src.read(denom);
 			tmp = mpq_class(num, denom);
-			coords.emplace_back( Conversion<mpq_class>::toMpreal(tmp, precision) );
+			coords.emplace_back();
+			Conversion<mpq_class>::toMpreal(tmp, coords.back(), precision);
 		}
 	}
-	else if (fmt == FM_GEO) {
+	else if (fmt == PointBase::FM_GEO) {
 		coords.resize(3);
 		mpfr::mpreal lat, lon;
-		is >> lat >> lon;
+		src.read(lat);
+		src.read(lon);
 		precision = std::max<int>(precision, 53);
 		lat.setPrecision(precision);
 		lon.setPrecision(precision);
-		c.cartesian(lat, lon, coords[0], coords[1], coords[2]);
+		p.c.cartesian(lat, lon, coords[0], coords[1], coords[2]);
 	}
-	else if (fmt == FM_SPHERICAL) {
+	else if (fmt == PointBase::FM_SPHERICAL) {
 		coords.resize(3);
 		mpfr::mpreal theta, phi;
-		is >> theta >> phi;
+		src.read(theta);
+		src.read(phi);
 		precision = std::max<int>(precision, 53);
 		theta.setPrecision(precision);
 		phi.setPrecision(precision);
-		c.cartesianFromSpherical(theta, phi, coords[0], coords[1], coords[2]);
+		p.c.cartesianFromSpherical(theta, phi, coords[0], coords[1], coords[2]);
 	}
 	else {
 		throw std::runtime_error("ratss::FloatPoint: unsupported format");
 	}
 }
+
+template<typename T_SOURCE>
+void assignRationalPoint(RationalPoint & p, T_SOURCE & src, PointBase::Format fmt, int precision, int dimension) {
+	auto & coords = p.coords;
+	coords.clear();
+	if (fmt == PointBase::FM_CARTESIAN_RATIONAL) {
+		while (!src.lineEnd() && (int) coords.size() != dimension) {
+			mpq_class tmp;
+			src.read(tmp);
+			coords.emplace_back(std::move(tmp));
+		}
+	}
+	else if (fmt == PointBase::FM_CARTESIAN_SPLIT_RATIONAL) {
+		mpz_class num, denom;
+		while (!src.lineEnd() && (int) coords.size() != dimension) {
+			src.read(num);
+			src.read(denom);
+			mpq_class tmp = mpq_class(num, denom);
+			coords.emplace_back(std::move(tmp));
+		}
+	}
+	else {
+		FloatPoint fp;
+		try {
+			assignFloatPoint(fp, src, fmt, precision, dimension);
+		}
+		catch(std::runtime_error & e) {
+			throw std::runtime_error("ratss::RationalPoint: unsupported format");
+		}
+		coords.resize(fp.coords.size());
+		for(std::size_t i(0), s(fp.coords.size()); i < s; ++i) {
+			Conversion<mpfr::mpreal>::toMpq(fp.coords[i], coords[i]);
+		}
+	}
+}
+
+} //end namespace
+
+void FloatPoint::assign(std::istream & is, Format fmt, int precision, int dimension) {
+	IStreamSource src(is);
+	assignFloatPoint(*this, src, fmt, precision, dimension);
+}
+
+void FloatPoint::assign(Tokenizer & tokenizer, Format fmt, int precision, int dimension) {
+	assignFloatPoint(*this, tokenizer, fmt, precision, dimension);
+}
+
 void FloatPoint::print(std::ostream & out) const {
 	if (!coords.size()) {
 		return;
@@ -116,36 +183,12 @@ void RationalPoint::resize(std::size_t _n) {
 
 
 void RationalPoint::assign(std::istream & is, Format fmt, int precision, int dimension) {
-	coords.clear();
-	if (fmt == FM_CARTESIAN_RATIONAL) {
-		
-		while (is.good() && is.peek() != '\n' && (int) coords.size() != dimension) {
-			mpq_class tmp;
-			is >> tmp;
-			coords.emplace_back(std::move(tmp));
-		}
-	}
-	else if (fmt == FM_CARTESIAN_SPLIT_RATIONAL && (int) coords.size() != dimension) {
-		mpz_class num, denom;
-		while (is.good() && is.peek() != '\n') {
-			is >> num >> denom;
-			mpq_class tmp = mpq_class(num, denom);
-			coords.emplace_back(std::move(tmp));
-		}
-	}
-	else {
-		FloatPoint fp;
-		try {
-			fp.assign(is, fmt, precision, dimension);
-		}
-		catch(std::runtime_error & e) {
-			throw std::runtime_error("ratss::RationalPoint: unsupported format");
-		}
-		coords.resize(fp.coords.size());
-		for(std::size_t i(0), s(fp.coords.size()); i < s; ++i) {
-			coords[i] = Conversion<mpfr::mpreal>::toMpq(fp.coords[i]);
-		}
-	}
+	IStreamSource src(is);
+	assignRationalPoint(*this, src, fmt, precision, dimension);
+}
+
+void RationalPoint::assign(Tokenizer & tokenizer, Format fmt, int precision, int dimension) {
+	assignRationalPoint(*this, tokenizer, fmt, precision, dimension);
 }
 
 void RationalPoint::print(std::ostream & out, Format fmt) const {
@@ -168,18 +211,24 @@ void RationalPoint::print(std::ostream & out, Format fmt) const {
 	else if (fmt == FM_FLOAT) {
 		std::streamsize prec = out.precision();
 		out.precision(std::numeric_limits<double>::digits10+1);
-		out << Conversion<mpq_class>::toMpreal(*it, 53).toDouble();
+		mpfr::mpreal tmp(0, 53);
+		Conversion<mpq_class>::toMpreal(*it, tmp.mpfr_ptr());
+		out << tmp.toDouble();
 		for(++it; it != end; ++it) {
-			out << ' ' << Conversion<mpq_class>::toMpreal(*it, 53).toDouble();
+			Conversion<mpq_class>::toMpreal(*it, tmp.mpfr_ptr());
+			out << ' ' << tmp.toDouble();
 		}
 		out.precision(prec);
 	}
 	else if (fmt == FM_FLOAT128) {
 		std::streamsize prec = out.precision();
 		out.precision(128);
-		out << Conversion<mpq_class>::toMpreal(*it, 128);
+		mpfr::mpreal tmp(0, 128);
+		Conversion<mpq_class>::toMpreal(*it, tmp.mpfr_ptr());
+		out << tmp;
 		for(++it; it != end; ++it) {
-			out << ' ' << Conversion<mpq_class>::toMpreal(*it, 128);
+			Conversion<mpq_class>::toMpreal(*it, tmp.mpfr_ptr());
+			out << ' ' << tmp;
 		}
 		out.precision(prec);
 	}
@@ -189,9 +238,10 @@ void RationalPoint::print(std::ostream & out, Format fmt) const {
 		}
 		std::streamsize prec = out.precision();
 		out.precision(std::numeric_limits<double>::digits10+1);
-		mpfr::mpreal x = Conversion<mpq_class>::toMpreal(coords.at(0), 128);
-		mpfr::mpreal y = Conversion<mpq_class>::toMpreal(coords.at(1), 128);
-		mpfr::mpreal z = Conversion<mpq_class>::toMpreal(coords.at(2), 128);
+		mpfr::mpreal x(0, 128), y(0, 128), z(0, 128);
+		Conversion<mpq_class>::toMpreal(coords.at(0), x.mpfr_ptr());
+		Conversion<mpq_class>::toMpreal(coords.at(1), y.mpfr_ptr());
+		Conversion<mpq_class>::toMpreal(coords.at(2), z.mpfr_ptr());
 		mpfr::mpreal lat, lon;
 		c.geo(x, y, z, lat, lon);
 		out << lat << ' ' << lon;
@@ -203,9 +253,10 @@ void RationalPoint::print(std::ostream & out, Format fmt) const {
 		}
 		std::streamsize prec = out.precision();
 		out.precision(std::numeric_limits<double>::digits10+1);
-		mpfr::mpreal x = Conversion<mpq_class>::toMpreal(coords.at(0), 128);
-		mpfr::mpreal y = Conversion<mpq_class>::toMpreal(coords.at(1), 128);
-		mpfr::mpreal z = Conversion<mpq_class>::toMpreal(coords.at(2), 128);
+		mpfr::mpreal x(0, 128), y(0, 128), z(0, 128);
+		Conversion<mpq_class>::toMpreal(coords.at(0), x.mpfr_ptr());
+		Conversion<mpq_class>::toMpreal(coords.at(1), y.mpfr_ptr());
+		Conversion<mpq_class>::toMpreal(coords.at(2), z.mpfr_ptr());
 		mpfr::mpreal theta, phi;
 		c.spherical(x, y, z, theta, phi);
 		out << theta << ' ' << phi;
@@ -213,6 +264,35 @@ void RationalPoint::print(std::ostream & out, Format fmt) const {
 	}
 }
 
+void RationalPoint::print(OutputBuffer & out, Format fmt) const {
+	if (!coords.size()) {
+		return;
+	}
+	std::vector<mpq_class>::const_iterator it(coords.begin()), end(coords.end());
+	if (fmt == FM_RATIONAL) {
+		out.write(*it);
+		for(++it; it != end; ++it) {
+			out.put(' ');
+			out.write(*it);
+		}
+	}
+	else if (fmt == FM_SPLIT_RATIONAL) {
+		out.write(it->get_num());
+		out.put(' ');
+		out.write(it->get_den());
+		for(++it; it != end; ++it) {
+			out.put(' ');
+			out.write(it->get_num());
+			out.put(' ');
+			out.write(it->get_den());
+		}
+	}
+	else {
+		out.flush();
+		print(out.stream(), fmt);
+	}
+}
+
 bool RationalPoint::valid() const {
 	mpq_class tmp(0);
 	for(const mpq_class & c : coords) {
@@ -0,0 +1,83 @@
+#include <libratss/util/OutputBuffer.h>
+
+#include <cstring>
+
+namespace LIB_RATSS_NAMESPACE {
+
+constexpr std::size_t OutputBuffer::DEFAULT_BUFFER_SIZE;
+
+OutputBuffer::OutputBuffer(std::ostream & out, std::size_t bufferSize) :
+m_out(&out),
+m_buf(std::max<std::size_t>(bufferSize, 16)),
+m_size(0)
+{}
+
+OutputBuffer::~OutputBuffer() {
+	flush();
+}
+
+std::ostream & OutputBuffer::stream() {
+	return *m_out;
+}
+
+void OutputBuffer::flush() {
+	if (!m_size) {
+		return;
+	}
+	std::streamsize written = m_out->rdbuf()->sputn(m_buf.data(), m_size);
+	if (written != (std::streamsize) m_size) {
+		m_out->setstate(std::ios_base::badbit);
+	}
+	m_size = 0;
+}
+
+void OutputBuffer::reserve(std::size_t size) {
+	if (m_size + size > m_buf.size()) {
+		flush();
+		//numbers larger than the whole buffer
+		if (size > m_buf.size()) {
+			m_buf.resize(size);
+		}
+	}
+}
+
+void OutputBuffer::put(char c) {
+	reserve(1);
+	m_buf[m_size] = c;
+	++m_size;
+}
+
+void OutputBuffer::write(const char * str, std::size_t size) {
+	if (size > m_buf.size()) {
+		flush();
+		if (m_out->rdbuf()->sputn(str, size) != (std::streamsize) size) {
+			m_out->setstate(std::ios_base::badbit);
+		}
+		return;
+	}
+	reserve(size);
+	::memcpy(m_buf.data()+m_size, str, size);
+	m_size += size;
+}
+
+void OutputBuffer::write(const std::string & str) {
+	write(str.data(), str.size());
+}
+
+void OutputBuffer::write(const mpz_class & v) {
+	//sign, digits and the terminating null, mpz_sizeinbase may be one too large
+	reserve(::mpz_sizeinbase(v.get_mpz_t(), 10) + 2);
+	char * dest = m_buf.data()+m_size;
+	::mpz_get_str(dest, 10, v.get_mpz_t());
+	m_size += ::strlen(dest);
+}
+
+void OutputBuffer::write(const mpq_class & v) {
+	write(v.get_num());
+	if (v.get_den() != 1) {
+		put('/');
+		write(v.get_den());
+	}
+}
+
+} //end namespace LIB_RATSS_NAMESPACE
@@ -0,0 +1,172 @@
+#include <libratss/util/Tokenizer.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace {
+
+inline bool isBlank(char c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool isSpace(char c) {
+	return c == '\n' || isBlank(c);
+}
+
+} //end namespace
+
+constexpr std::size_t Tokenizer::DEFAULT_BUFFER_SIZE;
+
+Tokenizer::Tokenizer(std::istream & in, std::size_t bufferSize) :
+m_in(&in),
+m_buf(std::max<std::size_t>(bufferSize, 16)+1),
+m_begin(0),
+m_end(0),
+m_saved(0),
+m_hasSaved(false)
+{}
+
+Tokenizer::Tokenizer(const std::string & data) :
+m_in(0),
+m_buf(data.size()+1),
+m_begin(0),
+m_end(data.size()),
+m_saved(0),
+m_hasSaved(false)
+{
+	::memcpy(m_buf.data(), data.data(), data.size());
+}
+
+Tokenizer::~Tokenizer() {}
+
+void Tokenizer::restore() {
+	if (m_hasSaved) {
+		m_buf[m_begin] = m_saved;
+		m_hasSaved = false;
+	}
+}
+
+bool Tokenizer::fill() {
+	if (!m_in) {
+		return false;
+	}
+	//keep the unconsumed data, this is at most a partial token
+	if (m_begin) {
+		::memmove(m_buf.data(), m_buf.data()+m_begin, m_end-m_begin);
+		m_end -= m_begin;
+		m_begin = 0;
+	}
+	//token is larger than our buffer, we always need space for the terminating null
+	if (m_end+1 >= m_buf.size()) {
+		m_buf.resize(2*m_buf.size());
+	}
+	std::streamsize n = m_in->rdbuf()->sgetn(m_buf.data()+m_end, m_buf.size()-1-m_end);
+	if (n <= 0) {
+		m_in->setstate(std::ios_base::eofbit);
+		return false;
+	}
+	m_end += n;
+	return true;
+}
+
+bool Tokenizer::good() {
+	return peek() != EOF;
+}
+
+int Tokenizer::peek() {
+	restore();
+	if (m_begin == m_end && !fill()) {
+		return EOF;
+	}
+	return (unsigned char) m_buf[m_begin];
+}
+
+bool Tokenizer::lineEnd() {
+	restore();
+	while (true) {
+		if (m_begin == m_end && !fill()) {
+			return true;
+		}
+		char c = m_buf[m_begin];
+		if (!isBlank(c)) {
+			return c == '\n';
+		}
+		++m_begin;
+	}
+}
+
+bool Tokenizer::newline() {
+	//blanks at the end of a line are not a token
+	if (lineEnd() && peek() == '\n') {
+		++m_begin;
+		return true;
+	}
+	return false;
+}
+
+const char * Tokenizer::token() {
+	if (lineEnd()) {
+		return 0;
+	}
+	std::size_t tokenEnd = m_begin;
+	while (true) {
+		if (tokenEnd == m_end) {
+			std::size_t tokenSize = tokenEnd - m_begin;
+			if (!fill()) {
+				break;
+			}
+			tokenEnd = m_begin + tokenSize;
+			continue;
+		}
+		if (isSpace(m_buf[tokenEnd])) {
+			break;
+		}
+		++tokenEnd;
+	}
+	const char * result = m_buf.data() + m_begin;
+	m_saved = m_buf[tokenEnd];
+	m_buf[tokenEnd] = 0;
+	m_hasSaved = true;
+	m_begin = tokenEnd;
+	return result;
+}
+
+const char * Tokenizer::nextToken(const char * what) {
+	const char * t = token();
+	if (!t) {
+		throw std::runtime_error(std::string("ratss::Tokenizer::read: expected ") + what + " but the line ended");
+	}
+	return t;
+}
+
+void Tokenizer::read(mpz_class & v) {
+	const char * t = nextToken("an integer");
+	if (*t == '+') {
+		++t;
+	}
+	if (::mpz_set_str(v.get_mpz_t(), t, 10) != 0) {
+		throw std::runtime_error(std::string("ratss::Tokenizer::read: invalid integer ") + t);
+	}
+}
+
+void Tokenizer::read(mpq_class & v) {
+	const char * t = nextToken("a rational");
+	if (*t == '+') {
+		++t;
+	}
+	if (::mpq_set_str(v.get_mpq_t(), t, 10) != 0) {
+		throw std::runtime_error(std::string("ratss::Tokenizer::read: invalid rational ") + t);
+	}
+}
+
+void Tokenizer::read(mpfr::mpreal & v) {
+	const char * t = nextToken("a float");
+	char * end = 0;
+	::mpfr_strtofr(v.mpfr_ptr(), t, &end, 10, mpfr::mpreal::get_default_rnd());
+	if (end == t || *end != 0) {
+		throw std::runtime_error(std::string("ratss::Tokenizer::read: invalid float ") + t);
+	}
+}
+
+} //end namespace LIB_RATSS_NAMESPACE
@@ -12,6 +12,11 @@ CPPUNIT_TEST_SUITE( CalcTest );
 // CPPUNIT_TEST( withinSpecial );
 // CPPUNIT_TEST( contFracRandom );
 CPPUNIT_TEST( jacobiPerron2D );
+CPPUNIT_TEST( contFracResume );
+CPPUNIT_TEST( contFracFirstConvergent );
+CPPUNIT_TEST( snapRational );
+CPPUNIT_TEST( snapInputPrecision );
+CPPUNIT_TEST( gradeBounds );
 CPPUNIT_TEST_SUITE_END();
 public:
 	static std::size_t num_random_test_points;
@@ -21,6 +26,11 @@ public:
 	void withinSpecial();
 	void contFracRandom();
 	void jacobiPerron2D();
+	void contFracResume();
+	void contFracFirstConvergent();
+	void snapRational();
+	void snapInputPrecision();
+	void gradeBounds();
 };
 
 std::size_t CalcTest::num_random_test_points;
@@ -56,6 +66,140 @@ void CalcTest::jacobiPerron2D() {
 	CPPUNIT_ASSERT_EQUAL(input2, output2);
 }
 
+void CalcTest::contFracResume() {
+	std::vector<mpq_class> values = {mpq_class(0), mpq_class(1), mpq_class("-3/16"), mpq_class("355/113"), mpq_class("-1/3")};
+	for(const SphericalCoord & c : getRandomPolarPoints(100)) {
+		values.emplace_back(c.theta);
+		values.emplace_back(c.phi);
+	}
+	for(const mpq_class & v : values) {
+		ContinuedFraction cf(v);
+		//the last one starts over
+		for(int sig : {1, 8, 23, 31, 53, 64, 113, 31}) {
+			CPPUNIT_ASSERT_EQUAL(calc.contFrac(v, sig), cf.approximation(sig));
+		}
+	}
+}
+
+void CalcTest::contFracFirstConvergent() {
+	using std::abs;
+	//the error bound 1/(a_(n+1) q_n^2) has to use the denominator q_n of the convergent and not the partial quotient a_n,
+	//and the distance to the convergent has to be absolute.
+	//Otherwise the expansion stops at convergents that are farther away than 2^-significands, e.g. at 1/2 for 5/8
+	std::vector<mpq_class> values = {mpq_class("5/8"), mpq_class("-5/8"), mpq_class("355/113"), mpq_class("1/3"), mpq_class("13/21"), mpq_class("89/233")};
+	for(const SphericalCoord & c : getRandomPolarPoints(100)) {
+		values.emplace_back(c.theta);
+		values.emplace_back(c.phi);
+	}
+	for(const mpq_class & v : values) {
+		//the convergents of v computed by the recurrence without any error bound
+		std::vector<mpq_class> convergents;
+		mpq_class tmp = abs(v);
+		mpz_class p1(1), p2(0), q1(0), q2(1);
+		while (true) {
+			mpz_class a = tmp.get_num() / tmp.get_den();
+			mpz_class p = a*p1 + p2, q = a*q1 + q2;
+			p2 = p1; p1 = p;
+			q2 = q1; q1 = q;
+			convergents.emplace_back(::sgn(v)*p, q);
+			convergents.back().canonicalize();
+			tmp -= a;
+			if (tmp == 0) {
+				break;
+			}
+			tmp = 1 / tmp;
+		}
+		for(int sig : {1, 2, 3, 5, 8, 16, 31, 53}) {
+			mpq_class eps(mpz_class(1), mpz_class(1) << sig);
+			mpq_class result = calc.contFrac(v, sig);
+			CPPUNIT_ASSERT(abs(result - v) <= eps);
+			//the first convergent that is closer than eps
+			auto it = std::find_if(convergents.begin(), convergents.end(), [&](const mpq_class & c) {
+				return abs(c - v) < eps;
+			});
+			CPPUNIT_ASSERT(it != convergents.end());
+			CPPUNIT_ASSERT_EQUAL(*it, result);
+		}
+	}
+}
+
+void CalcTest::snapRational() {
+	using std::abs;
+	for(const SphericalCoord & c : getRandomPolarPoints(100)) {
+		//theta is in [0, pi]
+		mpq_class v(c.theta);
+		mpq_class vs = v/4;
+		for(int sig : {8, 31, 53}) {
+			mpq_class eps(mpz_class(1), mpz_class(1) << sig);
+			CPPUNIT_ASSERT_EQUAL(calc.contFrac(v, sig), calc.snap(v, Calc::ST_CF, sig));
+			mpq_class fx = calc.snap(vs, Calc::ST_FX, sig);
+			CPPUNIT_ASSERT(abs(fx - vs) <= eps);
+			CPPUNIT_ASSERT(mpz_sizeinbase(fx.get_den().get_mpz_t(), 2) <= std::size_t(sig+2));
+			//values larger than 1 have a partial quotient a_0 != 0
+			for(const mpq_class & x : {v, vs, mpq_class(-v)}) {
+				mpq_class w = calc.snap(x, Calc::ST_CF, eps);
+				CPPUNIT_ASSERT(abs(w - x) <= eps);
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL(v, calc.snap(v, Calc::ST_CF, -1));
+	}
+	CPPUNIT_ASSERT_THROW(calc.snap(mpq_class(1, 3), Calc::ST_JP, 8), std::runtime_error);
+}
+
+void CalcTest::snapInputPrecision() {
+	using std::abs;
+	//negative significands snap to the simplest rational within half an ulp of the input precision
+	CPPUNIT_ASSERT_EQUAL(mpq_class(1, 10), calc.snap(mpfr::mpreal("0.1", 53), Calc::ST_CF, -1));
+	CPPUNIT_ASSERT_EQUAL(mpq_class(-1, 3), calc.snap(mpfr::mpreal(-1, 53)/3, Calc::ST_CF, -1));
+	for(const SphericalCoord & c : getRandomPolarPoints(100)) {
+		for(int prec : {24, 53, 128}) {
+			mpfr::mpreal v(c.theta, prec);
+			mpq_class rat = Conversion<mpfr::mpreal>::toMpq(v);
+			mpq_class eps(mpz_class(1), mpz_class(1) << (prec+1));
+			for(const mpfr::mpreal & x : {v, mpfr::mpreal(-v)}) {
+				mpq_class w = calc.snap(x, Calc::ST_CF, -1);
+				CPPUNIT_ASSERT(abs(w - abs(rat)*sgn(x)) <= eps);
+				CPPUNIT_ASSERT(w.get_den() <= rat.get_den());
+			}
+		}
+	}
+}
+
+void CalcTest::gradeBounds() {
+	std::vector<SphericalCoord> coords = getRandomPolarPoints(1000);
+	std::vector<mpfr::mpreal> a(3);
+	std::vector<mpq_class> b(3);
+	mpfr::mpreal lower(0, 64), upper(0, 64);
+	for(std::size_t i(0); i+1 < coords.size(); ++i) {
+		a[0] = mpfr::mpreal(coords[i].theta, 128);
+		a[1] = mpfr::mpreal(coords[i].phi, 128);
+		a[2] = (i % 5 == 0 ? a[0] : mpfr::mpreal(coords[i+1].theta, 128));
+		//close to a such that the differences are small
+		for(int j(0); j < 3; ++j) {
+			b[j] = calc.contFrac(Conversion<mpfr::mpreal>::toMpq(a[j]), 8 + int(i % 50));
+		}
+		mpq_class exact = calc.squaredDistance(a.begin(), a.end(), b.begin());
+		calc.squaredDistance(a.begin(), a.end(), b.begin(), lower, upper);
+		CPPUNIT_ASSERT(Conversion<mpfr::mpreal>::toMpq(lower) <= exact);
+		CPPUNIT_ASSERT(exact <= Conversion<mpfr::mpreal>::toMpq(upper));
+		
+		exact = calc.maxNorm(a.begin(), a.end(), b.begin());
+		calc.maxNorm(a.begin(), a.end(), b.begin(), lower, upper);
+		CPPUNIT_ASSERT(Conversion<mpfr::mpreal>::toMpq(lower) <= exact);
+		CPPUNIT_ASSERT(exact <= Conversion<mpfr::mpreal>::toMpq(upper));
+		
+		//dyadic differences are exact
+		calc.maxNorm(a.begin(), a.end(), a.begin(), lower, upper);
+		CPPUNIT_ASSERT_EQUAL(mpfr::mpreal(0), upper);
+		b[0] = Conversion<mpfr::mpreal>::toMpq(a[0]) + mpq_class(1, 1024);
+		b[1] = Conversion<mpfr::mpreal>::toMpq(a[1]);
+		b[2] = Conversion<mpfr::mpreal>::toMpq(a[2]);
+		calc.maxNorm(a.begin(), a.end(), b.begin(), lower, upper);
+		CPPUNIT_ASSERT_EQUAL(lower, upper);
+		CPPUNIT_ASSERT_EQUAL(mpq_class(1, 1024), Conversion<mpfr::mpreal>::toMpq(upper));
+	}
+}
+
 void CalcTest::withinSpecial() {
 	mpq_class lower, upper, within;
 	std::stringstream ss;
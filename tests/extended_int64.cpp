@@ -0,0 +1,290 @@
+#include <libratss/constants.h>
+#include <libratss/CGAL/ExtendedInt64q.h>
+#include <libratss/CGAL/ExtendedInt64Pool.h>
+
+#include "TestBase.h"
+
+#include <random>
+#include <thread>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace tests {
+
+class ExtendedInt64Test: public TestBase {
+CPPUNIT_TEST_SUITE( ExtendedInt64Test );
+CPPUNIT_TEST( integerBoundaries );
+CPPUNIT_TEST( rationalFromPq );
+CPPUNIT_TEST( rationalBoundaries );
+CPPUNIT_TEST( rationalMovedFrom );
+CPPUNIT_TEST( rationalProductCancels );
+CPPUNIT_TEST( pooledExtensions );
+CPPUNIT_TEST_SUITE_END();
+public:
+	static std::size_t num_random_test_points;
+public:
+	void integerBoundaries();
+	void rationalFromPq();
+	void rationalBoundaries();
+	void rationalMovedFrom();
+	void rationalProductCancels();
+	void pooledExtensions();
+private:
+	using Rational = CGAL::ExtendedInt64q<CGAL::Gmpq>;
+private:
+	static mpz_class toMpz(const CGAL::ExtendedInt64z & v);
+	///values around the limits of the 64 and 128 bit representations with both signs
+	static std::vector<mpz_class> boundaryIntegers();
+	///@expected and @actual have the same value and @actual uses the int64 representation iff the value fits into it
+	static void check(const CGAL::Gmpz & expected, const CGAL::ExtendedInt64z & actual);
+	///@expected and @actual have the same value and @actual is in lowest terms with a positive denominator.
+	///@actual uses the int64 representation iff numerator and denominator fit into it
+	static void check(const CGAL::Gmpq & expected, const Rational & actual);
+};
+
+std::size_t ExtendedInt64Test::num_random_test_points;
+
+}} // end namespace ratss::tests
+
+int main(int argc, char ** argv) {
+	LIB_RATSS_NAMESPACE::tests::TestBase::init(argc, argv);
+	LIB_RATSS_NAMESPACE::tests::ExtendedInt64Test::num_random_test_points = 32;
+	srand( 0 );
+	CppUnit::TextUi::TestRunner runner;
+	runner.addTest(  LIB_RATSS_NAMESPACE::tests::ExtendedInt64Test::suite() );
+	bool ok = runner.run();
+	return ok ? 0 : 1;
+}
+
+namespace LIB_RATSS_NAMESPACE {
+namespace tests {
+
+std::vector<mpz_class> ExtendedInt64Test::boundaryIntegers() {
+	std::vector<mpz_class> result;
+	for(int e : {0, 1, 31, 32, 62, 63, 64, 126, 127, 128}) {
+		mpz_class p(1);
+		p <<= e;
+		for(int d : {-1, 0, 1}) {
+			mpz_class v(p + d);
+			result.push_back(v);
+			result.push_back(-v);
+		}
+	}
+	std::mt19937_64 rng(0);
+	for(std::size_t i(0); i < num_random_test_points; ++i) {
+		result.emplace_back(gmp_int64_t(rng()));
+	}
+	return result;
+}
+
+mpz_class ExtendedInt64Test::toMpz(const CGAL::ExtendedInt64z & v) {
+	return v.isExtended() ? mpz_class(v.getExtended().mpz()) : mpz_class(v.get());
+}
+
+void ExtendedInt64Test::check(const CGAL::Gmpz & expected, const CGAL::ExtendedInt64z & actual) {
+	mpz_class e(expected.mpz());
+	mpz_class a(toMpz(actual));
+	CPPUNIT_ASSERT_EQUAL(e, a);
+	CPPUNIT_ASSERT_EQUAL(!e.fits_slong_p(), actual.isExtended());
+	CPPUNIT_ASSERT_EQUAL(int(CGAL::sign(expected)), int(actual.sign()));
+}
+
+void ExtendedInt64Test::integerBoundaries() {
+	using CGAL::Gmpz;
+	using CGAL::ExtendedInt64z;
+	std::vector<mpz_class> values = boundaryIntegers();
+	for(const mpz_class & av : values) {
+		Gmpz ga(av.get_mpz_t());
+		ExtendedInt64z a(ga);
+		check(ga, a);
+		check(-ga, -a);
+		{
+			ExtendedInt64z tmp(a);
+			check(ga+Gmpz(1), ++tmp);
+			tmp = a;
+			check(ga-Gmpz(1), --tmp);
+		}
+		for(long s : {1, 2, 31, 63, 64, 65}) {
+			check(ga << s, a << s);
+			check(ga >> s, a >> s);
+		}
+		for(const mpz_class & bv : values) {
+			Gmpz gb(bv.get_mpz_t());
+			ExtendedInt64z b(gb);
+			check(ga+gb, a+b);
+			check(ga-gb, a-b);
+			check(ga*gb, a*b);
+			if (bv != 0) {
+				check(ga/gb, a/b);
+				check(ga%gb, a%b);
+			}
+			CPPUNIT_ASSERT_EQUAL(ga < gb, a < b);
+			CPPUNIT_ASSERT_EQUAL(ga == gb, a == b);
+		}
+	}
+}
+
+void ExtendedInt64Test::check(const CGAL::Gmpq & expected, const Rational & actual) {
+	mpq_class e(expected.mpq());
+	mpz_class num(toMpz(actual.numerator())), den(toMpz(actual.denominator()));
+	CPPUNIT_ASSERT_EQUAL(e.get_num(), num);
+	CPPUNIT_ASSERT_EQUAL(e.get_den(), den);
+	bool fits = e.get_num().fits_slong_p() && e.get_den().fits_slong_p();
+	CPPUNIT_ASSERT_EQUAL(fits, actual.tier() == CGAL::ExtendedInt64Stats::T_INT64);
+	CPPUNIT_ASSERT_EQUAL(int(CGAL::sign(expected)), int(actual.sign()));
+}
+
+void ExtendedInt64Test::rationalFromPq() {
+	using PQ = Rational::PQ;
+	const gmp_int64_t btmin = std::numeric_limits<gmp_int64_t>::min();
+	const gmp_int64_t btmax = std::numeric_limits<gmp_int64_t>::max();
+	std::vector<std::pair<gmp_int64_t, gmp_int64_t>> pqs = {
+		{6, 4}, {6, -4}, {-6, -4}, {0, -5}, {btmin, 2}, {btmin, -2}, {btmin, -1},
+		{1, btmin}, {-2, btmin}, {btmax, btmax}, {btmax, -btmax}, {btmin, btmin}
+	};
+	for(const auto & x : pqs) {
+		mpq_class e(mpz_class(x.first), mpz_class(x.second));
+		e.canonicalize();
+		Rational r(PQ(x.first, x.second));
+		check(CGAL::Gmpq(e.get_mpq_t()), r);
+		//arithmetic relies on the canonical form
+		check(CGAL::Gmpq(mpq_class(e+1).get_mpq_t()), r+Rational(1));
+		CPPUNIT_ASSERT(r == Rational(CGAL::Gmpq(e.get_mpq_t())));
+	}
+	CPPUNIT_ASSERT_THROW(Rational(PQ(1, 0)), std::domain_error);
+}
+
+void ExtendedInt64Test::rationalBoundaries() {
+	using CGAL::Gmpq;
+	std::vector<mpz_class> nums;
+	for(int e : {0, 1, 62, 63, 64, 126, 127}) {
+		mpz_class p(1);
+		p <<= e;
+		for(int d : {-1, 0, 1}) {
+			nums.push_back(p + d);
+			nums.push_back(-(p + d));
+		}
+	}
+	std::vector<mpz_class> dens = {mpz_class(1), mpz_class(3)};
+	for(int e : {63, 127}) {
+		mpz_class p(1);
+		p <<= e;
+		dens.push_back(p-1);
+		dens.push_back(p);
+	}
+	std::vector<Gmpq> values;
+	for(const mpz_class & n : nums) {
+		for(const mpz_class & d : dens) {
+			mpq_class v(n, d);
+			v.canonicalize();
+			values.emplace_back(v.get_mpq_t());
+		}
+	}
+	for(const Gmpq & ga : values) {
+		Rational a(ga);
+		check(ga, a);
+		check(-ga, -a);
+		for(const Gmpq & gb : values) {
+			Rational b(gb);
+			check(ga+gb, a+b);
+			check(ga-gb, a-b);
+			check(ga*gb, a*b);
+			if (CGAL::sign(gb) != CGAL::ZERO) {
+				check(ga/gb, a/b);
+			}
+			CPPUNIT_ASSERT_EQUAL(ga < gb, a < b);
+			CPPUNIT_ASSERT_EQUAL(ga == gb, a == b);
+		}
+	}
+}
+
+void ExtendedInt64Test::rationalMovedFrom() {
+	mpq_class big(mpz_class(1) << 200, mpz_class(3));
+	Rational a((CGAL::Gmpq(big.get_mpq_t())));
+	CPPUNIT_ASSERT(a.isExtended());
+	Rational b(std::move(a));
+	check(CGAL::Gmpq(big.get_mpq_t()), b);
+	//a moved-from value is zero and usable
+	check(CGAL::Gmpq(0), a);
+	a += Rational(1);
+	check(CGAL::Gmpq(1), a);
+	Rational c((CGAL::Gmpq(big.get_mpq_t())));
+	b = std::move(c);
+	check(CGAL::Gmpq(0), c);
+	c *= Rational(2, 3);
+	check(CGAL::Gmpq(0), c);
+	c -= Rational(2, 3);
+	check(CGAL::Gmpq(mpq_class(-2, 3).get_mpq_t()), c);
+}
+
+void ExtendedInt64Test::rationalProductCancels() {
+	//operands of the 128 bit representation whose product looks like an overflow by their sizes
+	mpz_class p((mpz_class(1) << 120) + 1), q((mpz_class(1) << 110) + 3), r((mpz_class(1) << 100) + 7);
+	std::vector< std::pair<mpq_class, mpq_class> > factors = {
+		{mpq_class(p, q), mpq_class(q, p)},
+		{mpq_class(p, q), mpq_class(r*3, p)},
+		{mpq_class(-p, q), mpq_class(q, r)},
+		{mpq_class(p, q), mpq_class(r, p+2)}
+	};
+	for(auto & f : factors) {
+		f.first.canonicalize();
+		f.second.canonicalize();
+		Rational a((CGAL::Gmpq(f.first.get_mpq_t()))), b((CGAL::Gmpq(f.second.get_mpq_t())));
+		CPPUNIT_ASSERT_EQUAL(int(CGAL::ExtendedInt64Stats::T_INT128), int(a.tier()));
+		CPPUNIT_ASSERT_EQUAL(int(CGAL::ExtendedInt64Stats::T_INT128), int(b.tier()));
+		mpq_class e(f.first * f.second);
+		check(CGAL::Gmpq(e.get_mpq_t()), a*b);
+	}
+}
+
+void ExtendedInt64Test::pooledExtensions() {
+	CGAL::GmpLimbPool::install();
+	CPPUNIT_ASSERT(CGAL::GmpLimbPool::installed());
+	//values of different sizes such that recycled objects and limbs have to take smaller and larger values
+	std::vector<CGAL::Gmpq> values;
+	for(int e : {70, 200, 130, 1000, 65, 3000}) {
+		mpq_class v(mpz_class(1) << e, mpz_class(3));
+		values.emplace_back(mpq_class(v+1).get_mpq_t());
+		values.emplace_back(mpq_class(-v).get_mpq_t());
+	}
+	auto create = [&values](std::size_t offset) {
+		std::vector<Rational> result;
+		for(std::size_t i(0); i < values.size(); ++i) {
+			result.emplace_back(values[(i+offset) % values.size()]);
+		}
+		return result;
+	};
+	auto verify = [&values](const std::vector<Rational> & rs, std::size_t offset) {
+		for(std::size_t i(0); i < rs.size(); ++i) {
+			const CGAL::Gmpq & ga = values[(i+offset) % values.size()];
+			check(ga, rs[i]);
+			check(ga*ga, rs[i]*rs[i]);
+		}
+	};
+	for(std::size_t offset(0); offset < values.size(); ++offset) {
+		std::vector<Rational> rs = create(offset);
+		verify(rs, offset);
+		for(std::size_t i(0); i < rs.size(); ++i) {
+			rs[i] += Rational(1);
+			check(values[(i+offset) % values.size()] + CGAL::Gmpq(1), rs[i]);
+		}
+	}
+	//objects and limbs released by another thread than the one that created them
+	std::vector<Rational> fromWorker;
+	std::thread worker([&]() {
+		fromWorker = create(1);
+		std::vector<Rational> fromMain = create(2);
+		verify(fromMain, 2);
+	});
+	worker.join();
+	verify(fromWorker, 1);
+	fromWorker.clear();
+	verify(create(3), 3);
+	for(const mpz_class & v : boundaryIntegers()) {
+		CGAL::Gmpz gv(mpz_class(v << 100).get_mpz_t());
+		CGAL::ExtendedInt64z a(gv);
+		check(gv, a);
+		check(gv >> long(100), a >> long(100));
+	}
+}
+
+}} //end namespace ratss::tests
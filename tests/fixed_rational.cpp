@@ -0,0 +1,168 @@
+#include <libratss/constants.h>
+#include <libratss/CGAL/FixedRational.h>
+
+#include "TestBase.h"
+
+namespace LIB_RATSS_NAMESPACE {
+namespace tests {
+
+class FixedRationalTest: public TestBase {
+CPPUNIT_TEST_SUITE( FixedRationalTest );
+CPPUNIT_TEST( randomArithmetic );
+CPPUNIT_TEST( overflowBoundary );
+CPPUNIT_TEST_SUITE_END();
+public:
+	static std::size_t num_random_test_points;
+public:
+	void randomArithmetic();
+	void overflowBoundary();
+private:
+	template<int T_BITS>
+	void randomArithmetic(gmp_randclass & rnd);
+	template<int T_BITS>
+	void overflowBoundary();
+	///random rational whose numerator and denominator have up to @maxBits bits
+	static mpq_class random(gmp_randclass & rnd, int maxBits);
+	template<int T_BITS>
+	static bool fits(const mpq_class & v);
+	///@actual is @expected if that fits into T_BITS, otherwise computing it threw std::overflow_error
+	template<int T_BITS, typename T_OP>
+	static void check(const mpq_class & expected, T_OP op);
+	template<int T_BITS>
+	static mpq_class toMpq(const CGAL::FixedRational<T_BITS> & v);
+};
+
+std::size_t FixedRationalTest::num_random_test_points;
+
+}} // end namespace ratss::tests
+
+int main(int argc, char ** argv) {
+	LIB_RATSS_NAMESPACE::tests::TestBase::init(argc, argv);
+	LIB_RATSS_NAMESPACE::tests::FixedRationalTest::num_random_test_points = 2000;
+	srand( 0 );
+	CppUnit::TextUi::TestRunner runner;
+	runner.addTest(  LIB_RATSS_NAMESPACE::tests::FixedRationalTest::suite() );
+	bool ok = runner.run();
+	return ok ? 0 : 1;
+}
+
+namespace LIB_RATSS_NAMESPACE {
+namespace tests {
+
+mpq_class FixedRationalTest::random(gmp_randclass & rnd, int maxBits) {
+	mpz_class num(rnd.get_z_bits(1+rand()%maxBits));
+	mpz_class den(rnd.get_z_bits(1+rand()%maxBits));
+	if (den == 0) {
+		den = 1;
+	}
+	if (rand() % 2) {
+		num = -num;
+	}
+	mpq_class result(num, den);
+	result.canonicalize();
+	return result;
+}
+
+template<int T_BITS>
+bool FixedRationalTest::fits(const mpq_class & v) {
+	return mpz_sizeinbase(v.get_num_mpz_t(), 2) <= std::size_t(T_BITS) && mpz_sizeinbase(v.get_den_mpz_t(), 2) <= std::size_t(T_BITS);
+}
+
+template<int T_BITS>
+mpq_class FixedRationalTest::toMpq(const CGAL::FixedRational<T_BITS> & v) {
+	return mpq_class(v.to_gmpq().mpq());
+}
+
+template<int T_BITS, typename T_OP>
+void FixedRationalTest::check(const mpq_class & expected, T_OP op) {
+	std::stringstream ss;
+	ss << expected << " with " << T_BITS << " bits";
+	if (fits<T_BITS>(expected)) {
+		CGAL::FixedRational<T_BITS> actual;
+		CPPUNIT_ASSERT_NO_THROW_MESSAGE(ss.str(), actual = op());
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), expected, toMpq(actual));
+		CPPUNIT_ASSERT_EQUAL_MESSAGE(ss.str(), sgn(expected), actual.sign());
+		std::pair<double, double> iv = actual.to_interval();
+		CPPUNIT_ASSERT_MESSAGE(ss.str(), iv.first <= iv.second);
+		if (std::isfinite(iv.first)) {
+			CPPUNIT_ASSERT_MESSAGE(ss.str(), mpq_class(iv.first) <= expected);
+		}
+		if (std::isfinite(iv.second)) {
+			CPPUNIT_ASSERT_MESSAGE(ss.str(), expected <= mpq_class(iv.second));
+		}
+	}
+	else {
+		CPPUNIT_ASSERT_THROW_MESSAGE(ss.str(), op(), std::overflow_error);
+	}
+}
+
+template<int T_BITS>
+void FixedRationalTest::randomArithmetic(gmp_randclass & rnd) {
+	using FixedRational = CGAL::FixedRational<T_BITS>;
+	for(std::size_t i(0); i < num_random_test_points; ++i) {
+		//operands use up to all bits, so about half of the results overflow
+		mpq_class a(random(rnd, T_BITS)), b(random(rnd, T_BITS));
+		FixedRational fa(a.get_mpq_t()), fb(b.get_mpq_t());
+		CPPUNIT_ASSERT_EQUAL(a, toMpq(fa));
+		check<T_BITS>(mpq_class(a+b), [&]() { return fa + fb; });
+		check<T_BITS>(mpq_class(a-b), [&]() { return fa - fb; });
+		check<T_BITS>(mpq_class(a*b), [&]() { return fa * fb; });
+		if (b != 0) {
+			check<T_BITS>(mpq_class(a/b), [&]() { return fa / fb; });
+		}
+		check<T_BITS>(mpq_class(-a), [&]() { return -fa; });
+		CPPUNIT_ASSERT_EQUAL(a < b, fa < fb);
+		CPPUNIT_ASSERT_EQUAL(b < a, fb < fa);
+		CPPUNIT_ASSERT_EQUAL(a == b, fa == fb);
+		CPPUNIT_ASSERT(fa == FixedRational(a.get_mpq_t()));
+	}
+}
+
+template<int T_BITS>
+void FixedRationalTest::overflowBoundary() {
+	using FixedRational = CGAL::FixedRational<T_BITS>;
+	mpz_class p(1);
+	p <<= T_BITS;
+	mpz_class h(1);
+	h <<= T_BITS/2;
+	//largest magnitude that fits
+	mpq_class max(p-1);
+	FixedRational fmax(max.get_mpq_t());
+	FixedRational one(1);
+	check<T_BITS>(mpq_class(max), [&]() { return fmax; });
+	check<T_BITS>(mpq_class(-max), [&]() { return -fmax; });
+	check<T_BITS>(mpq_class(max+1), [&]() { return fmax + one; });
+	check<T_BITS>(mpq_class(-max-1), [&]() { return -fmax - one; });
+	check<T_BITS>(mpq_class(max-1), [&]() { return fmax - one; });
+	check<T_BITS>(mpq_class(1/max), [&]() { return one / fmax; });
+	check<T_BITS>(mpq_class(1/max/2), [&]() { return one / fmax / FixedRational(2); });
+	//products right at the boundary
+	mpq_class hq(h), hq1(h-1);
+	FixedRational fh(hq.get_mpq_t()), fh1(hq1.get_mpq_t());
+	check<T_BITS>(mpq_class(hq1*hq1), [&]() { return fh1 * fh1; });
+	check<T_BITS>(mpq_class(hq*hq1), [&]() { return fh * fh1; });
+	check<T_BITS>(mpq_class(hq*hq), [&]() { return fh * fh; });
+	check<T_BITS>(mpq_class(1/(hq*hq)), [&]() { return (one / fh) / fh; });
+	//results that fit after canonicalization
+	check<T_BITS>(mpq_class(max*(1/max)), [&]() { return fmax * (one / fmax); });
+	check<T_BITS>(mpq_class(1), [&]() { return (fh * fh1) / (fh1 * fh); });
+	CPPUNIT_ASSERT_THROW(FixedRational(CGAL::Gmpz(mpz_class(p).get_mpz_t())), std::overflow_error);
+	CPPUNIT_ASSERT_THROW(FixedRational(CGAL::Gmpz(1), CGAL::Gmpz(mpz_class(p).get_mpz_t())), std::overflow_error);
+	CPPUNIT_ASSERT_THROW(FixedRational(CGAL::Gmpz(1), CGAL::Gmpz(0)), std::domain_error);
+}
+
+void FixedRationalTest::randomArithmetic() {
+	gmp_randclass rnd(gmp_randinit_default);
+	rnd.seed(0);
+	randomArithmetic<256>(rnd);
+	randomArithmetic<512>(rnd);
+	randomArithmetic<1024>(rnd);
+}
+
+void FixedRationalTest::overflowBoundary() {
+	overflowBoundary<256>();
+	overflowBoundary<512>();
+	overflowBoundary<1024>();
+}
+
+}} //end namespace ratss::tests
@@ -0,0 +1,104 @@
+#include <libratss/constants.h>
+#include <libratss/util/InputOutputPoints.h>
+#include <libratss/util/OutputBuffer.h>
+#include <libratss/util/Tokenizer.h>
+
+#include "TestBase.h"
+
+#include <sstream>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace tests {
+
+class IoTest: public TestBase {
+CPPUNIT_TEST_SUITE( IoTest );
+CPPUNIT_TEST( outputBuffer );
+CPPUNIT_TEST( tokenizer );
+CPPUNIT_TEST_SUITE_END();
+public:
+	static std::size_t num_random_test_points;
+public:
+	void outputBuffer();
+	void tokenizer();
+private:
+	std::vector<RationalPoint> randomPoints();
+};
+
+std::size_t IoTest::num_random_test_points;
+
+}} // end namespace ratss::tests
+
+int main(int argc, char ** argv) {
+	LIB_RATSS_NAMESPACE::tests::TestBase::init(argc, argv);
+	LIB_RATSS_NAMESPACE::tests::IoTest::num_random_test_points = 1000;
+	srand( 0 );
+	CppUnit::TextUi::TestRunner runner;
+	runner.addTest(  LIB_RATSS_NAMESPACE::tests::IoTest::suite() );
+	bool ok = runner.run();
+	return ok ? 0 : 1;
+}
+
+namespace LIB_RATSS_NAMESPACE {
+namespace tests {
+
+std::vector<RationalPoint> IoTest::randomPoints() {
+	gmp_randclass rnd(gmp_randinit_default);
+	rnd.seed(0);
+	std::vector<RationalPoint> result(num_random_test_points);
+	for(std::size_t i(0); i < num_random_test_points; ++i) {
+		RationalPoint & p = result[i];
+		//mix tiny and huge numbers to hit the buffer boundaries
+		unsigned long int bits = (i % 10 == 0 ? 100000 : 1 + i % 200);
+		for(int j(0); j < 3; ++j) {
+			mpq_class v(rnd.get_z_bits(bits), rnd.get_z_bits(bits) + 1);
+			v.canonicalize();
+			if (j == 1) {
+				v = -v;
+			}
+			p.coords.emplace_back(std::move(v));
+		}
+	}
+	return result;
+}
+
+void IoTest::outputBuffer() {
+	std::vector<RationalPoint> points = randomPoints();
+	for(PointBase::Format fmt : {PointBase::FM_RATIONAL, PointBase::FM_SPLIT_RATIONAL, PointBase::FM_FLOAT}) {
+		std::stringstream expected, actual;
+		{
+			OutputBuffer out(actual, 64);
+			for(const RationalPoint & p : points) {
+				p.print(expected, fmt);
+				expected << '\n';
+				p.print(out, fmt);
+				out.put('\n');
+			}
+		}
+		CPPUNIT_ASSERT(expected.str() == actual.str());
+	}
+}
+
+void IoTest::tokenizer() {
+	std::vector<RationalPoint> points = randomPoints();
+	for(PointBase::Format fmt : {PointBase::FM_RATIONAL, PointBase::FM_SPLIT_RATIONAL}) {
+		std::stringstream ss;
+		for(std::size_t i(0); i < points.size(); ++i) {
+			points[i].print(ss, fmt);
+			//blanks at the end of a line and lines of blanks are skipped
+			ss << (i % 3 == 0 ? " \t \n" : "\n") << (i % 5 == 0 ? "  \n" : "\n");
+		}
+		ss << "\t ";
+		Tokenizer tokenizer(ss, 64);
+		for(const RationalPoint & p : points) {
+			while (tokenizer.newline()) {}
+			CPPUNIT_ASSERT(tokenizer.good());
+			RationalPoint rp;
+			rp.assign(tokenizer, fmt, 53);
+			CPPUNIT_ASSERT(p.coords == rp.coords);
+		}
+		while (tokenizer.newline()) {}
+		CPPUNIT_ASSERT(!tokenizer.good());
+	}
+}
+
+}} //end namespace ratss::tests
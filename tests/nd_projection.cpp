@@ -1,10 +1,15 @@
 #include <libratss/constants.h>
 #include <libratss/ProjectSN.h>
+#include <libratss/ProjectSNBatch.h>
+#include <libratss/SnapSize.h>
 #include <libratss/util/InputOutputPoints.h>
 
 #include "TestBase.h"
 #include "../common/generators.h"
 
+#include <numeric>
+#include <random>
+
 namespace LIB_RATSS_NAMESPACE {
 namespace tests {
 
@@ -24,6 +29,18 @@ CPPUNIT_TEST( snaplllSphere );
 // CPPUNIT_TEST( snapJpSphere );
 CPPUNIT_TEST( snapSpecial );
 CPPUNIT_TEST( snapRandomCore );
+CPPUNIT_TEST( snapCanonical );
+CPPUNIT_TEST( snapRefinement );
+CPPUNIT_TEST( snapRefinementInvalid );
+CPPUNIT_TEST( snapPrecision );
+CPPUNIT_TEST( snapPrecisionMissed );
+CPPUNIT_TEST( snapProfiled );
+CPPUNIT_TEST( batch );
+CPPUNIT_TEST( sphere2Plane2Sphere );
+CPPUNIT_TEST( snapPaper );
+CPPUNIT_TEST( snapPaperApproximation );
+CPPUNIT_TEST( snapAutoGrades );
+CPPUNIT_TEST( snapSize );
 CPPUNIT_TEST_SUITE_END();
 public:
 	using Projector = ProjectSN;
@@ -50,6 +67,18 @@ public:
 public:
 	void snapSpecial();
 	void snapRandomCore();
+	void snapCanonical();
+	void snapRefinement();
+	void snapRefinementInvalid();
+	void snapPrecision();
+	void snapPrecisionMissed();
+	void snapProfiled();
+	void batch();
+	void sphere2Plane2Sphere();
+	void snapPaper();
+	void snapPaperApproximation();
+	void snapAutoGrades();
+	void snapSize();
 protected:
 	void snapCore(const RationalPoint & pt, int significands);
 	void snapRandom(const std::vector<int> & snapMethod, const std::vector<int> & snapLocation);
@@ -167,6 +196,447 @@ void NDProjectionTest::snapRandomCore() {
 	}
 }
 
+void NDProjectionTest::snapCanonical() {
+	Projector p;
+	GeoCalc gc;
+	std::vector<int> snapTypes;
+	for(int sl : {ProjectSN::ST_PLANE, ProjectSN::ST_SPHERE}) {
+		for(int sm : {ProjectSN::ST_CF, ProjectSN::ST_FX, ProjectSN::ST_FL, ProjectSN::ST_JP}) {
+			//jacobi perron only snaps the two plane coordinates
+			if (sm == ProjectSN::ST_JP && sl == ProjectSN::ST_SPHERE) {
+				continue;
+			}
+			snapTypes.push_back(sm | sl);
+			snapTypes.push_back(sm | sl | ProjectSN::ST_NORMALIZE);
+		}
+		snapTypes.push_back(sl | ProjectSN::ST_AUTO | ProjectSN::ST_AUTO_CF | ProjectSN::ST_AUTO_FX | ProjectSN::ST_AUTO_POLICY_MIN_MAX_NORM);
+	}
+	std::array<mpfr::mpreal, 3> input, mirrored;
+	std::array<mpq_class, 3> expected, output, mirroredOutput;
+	for(int sig : {16, 31, 53}) {
+		for(std::size_t i(0); i < coords.size() && i < 500; ++i) {
+			gc.cartesianFromSpherical(mpfr::mpreal(coords[i].theta, 128), mpfr::mpreal(coords[i].phi, 128), input[0], input[1], input[2]);
+			if (i % 3 == 1) { //equally large coordinates
+				input[2] = -input[0];
+			}
+			for(int snapType : snapTypes) {
+				p.snap(input.begin(), input.end(), expected.begin(), snapType, sig);
+				p.snapCanonical(input.begin(), input.end(), output.begin(), snapType, sig);
+				CPPUNIT_ASSERT_MESSAGE(ProjectSN::toString((ProjectSN::SnapType) snapType), expected == output);
+				//ties decide the pole by the order of the coordinates
+				if (ProjectSN::symmetries(snapType) == ProjectSN::SY_ALL && i % 3 != 1) {
+					//(x, y, z) -> (-z, x, y) has the same canonical representative
+					mirrored = {{-input[2], input[0], input[1]}};
+					p.snapCanonical(mirrored.begin(), mirrored.end(), mirroredOutput.begin(), snapType & ~ProjectSN::ST_NORMALIZE, sig);
+					p.snapCanonical(input.begin(), input.end(), output.begin(), snapType & ~ProjectSN::ST_NORMALIZE, sig);
+					CPPUNIT_ASSERT_EQUAL(mpq_class(-output[2]), mirroredOutput[0]);
+					CPPUNIT_ASSERT_EQUAL(output[0], mirroredOutput[1]);
+					CPPUNIT_ASSERT_EQUAL(output[1], mirroredOutput[2]);
+				}
+			}
+		}
+	}
+}
+
+void NDProjectionTest::snapRefinement() {
+	Projector p;
+	GeoCalc gc;
+	std::array<mpfr::mpreal, 3> input;
+	std::array<mpq_class, 3> expected, output;
+	for(int sl : {ProjectSN::ST_PLANE, ProjectSN::ST_SPHERE}) {
+		for(int sm : {ProjectSN::ST_CF, ProjectSN::ST_FX, ProjectSN::ST_FL}) {
+			for(int snapType : {sm | sl, sm | sl | ProjectSN::ST_NORMALIZE}) {
+				for(std::size_t i(0); i < coords.size() && i < 200; ++i) {
+					gc.cartesianFromSpherical(mpfr::mpreal(coords[i].theta, 128), mpfr::mpreal(coords[i].phi, 128), input[0], input[1], input[2]);
+					Projector::Refinement refinement(input.begin(), input.end(), snapType);
+					//the last one starts over
+					for(int sig : {8, 23, 31, 53, 64, 113, 128, 16}) {
+						p.snap(input.begin(), input.end(), expected.begin(), snapType, sig);
+						refinement.refine(sig, output.begin());
+						CPPUNIT_ASSERT_MESSAGE(ProjectSN::toString((ProjectSN::SnapType) snapType), expected == output);
+					}
+				}
+			}
+		}
+	}
+}
+
+void NDProjectionTest::snapRefinementInvalid() {
+	Projector p;
+	//continued fractions with 1 significand snap all coordinates to zero
+	std::vector<mpfr::mpreal> input(16, mpfr::mpreal(1, 128)/4);
+	std::vector<mpq_class> expected(16), output(16, mpq_class(7));
+	int snapType = ProjectSN::ST_CF | ProjectSN::ST_SPHERE;
+	Projector::Refinement refinement(input.begin(), input.end(), snapType);
+	p.snap(input.begin(), input.end(), expected.begin(), snapType, 3);
+	CPPUNIT_ASSERT(refinement.refine(3) == expected);
+	p.snap(input.begin(), input.end(), output.begin(), snapType, 1);
+	CPPUNIT_ASSERT(output == std::vector<mpq_class>(16, mpq_class(7)));
+	refinement.refine(1, output.begin());
+	CPPUNIT_ASSERT(output == std::vector<mpq_class>(16, mpq_class(7)));
+	CPPUNIT_ASSERT_EQUAL(3, refinement.significands());
+	CPPUNIT_ASSERT(refinement.result() == expected);
+	p.snap(input.begin(), input.end(), expected.begin(), snapType, 2);
+	refinement.refine(2, output.begin());
+	CPPUNIT_ASSERT_EQUAL(2, refinement.significands());
+	CPPUNIT_ASSERT(output == expected);
+}
+
+void NDProjectionTest::snapPrecision() {
+	Projector p;
+	GeoCalc gc;
+	std::array<mpfr::mpreal, 3> input, normalized;
+	std::array<mpq_class, 3> output;
+	for(int sl : {ProjectSN::ST_PLANE, ProjectSN::ST_SPHERE}) {
+		for(int sm : {ProjectSN::ST_CF, ProjectSN::ST_FX, ProjectSN::ST_FL}) {
+			int snapType = sm | sl | ProjectSN::ST_NORMALIZE;
+			for(double maxDist : {1e-3, 1e-6, 1e-9, 1e-15, 1e-30}) {
+				Precision target(2, 128, maxDist*maxDist);
+				int expected = ProjectSN::significands(snapType, target, 3, 256);
+				for(std::size_t i(0); i < coords.size() && i < 200; ++i) {
+					gc.cartesianFromSpherical(mpfr::mpreal(coords[i].theta, 256), mpfr::mpreal(coords[i].phi, 256), input[0], input[1], input[2]);
+					int significands = p.snap(input.begin(), input.end(), output.begin(), snapType, target);
+					//the analytic bound holds without increasing the significands
+					CPPUNIT_ASSERT_EQUAL(expected, significands);
+					p.calc().normalize(input.begin(), input.end(), normalized.begin());
+					CPPUNIT_ASSERT(p.calc().squaredDistance(output.begin(), output.end(), normalized.begin()) <= mpq_class(target.maxSquaredDistance));
+				}
+			}
+		}
+	}
+}
+
+void NDProjectionTest::snapPrecisionMissed() {
+	Projector p;
+	GeoCalc gc;
+	std::array<mpfr::mpreal, 3> input, normalized;
+	std::array<mpq_class, 3> output;
+	for(int sm : {ProjectSN::ST_CF, ProjectSN::ST_FX, ProjectSN::ST_FL}) {
+		int snapType = sm | ProjectSN::ST_PLANE | ProjectSN::ST_NORMALIZE;
+		//16 bits cannot get closer than 1e-15
+		Precision target(2, 16, 1e-30);
+		for(std::size_t i(0); i < coords.size() && i < 50; ++i) {
+			gc.cartesianFromSpherical(mpfr::mpreal(coords[i].theta, 128), mpfr::mpreal(coords[i].phi, 128), input[0], input[1], input[2]);
+			int significands = p.snap(input.begin(), input.end(), output.begin(), snapType, target);
+			CPPUNIT_ASSERT_EQUAL(-16, significands);
+			p.calc().normalize(input.begin(), input.end(), normalized.begin());
+			CPPUNIT_ASSERT(p.calc().squaredDistance(output.begin(), output.end(), normalized.begin()) > mpq_class(target.maxSquaredDistance));
+			//the result is the one with the most significands
+			std::array<mpq_class, 3> expected;
+			p.snap(input.begin(), input.end(), expected.begin(), snapType, 16);
+			CPPUNIT_ASSERT(expected == output);
+		}
+	}
+}
+
+void NDProjectionTest::snapProfiled() {
+	Projector p;
+	std::vector<mpfr::mpreal> zero(3, mpfr::mpreal(0, 64));
+	std::vector<mpfr::mpreal> input = {mpfr::mpreal(0.6, 64), mpfr::mpreal(-0.8, 64), mpfr::mpreal(0, 64)};
+	std::vector<mpq_class> output(3);
+	auto denominators = [](const Profiler::Stats & stats) -> uint64_t {
+		return std::accumulate(stats.denomBits.begin(), stats.denomBits.end(), uint64_t(0));
+	};
+	//the zero point is not written, neither with nor without profiling
+	Profiler::reset();
+	std::vector<int> snapTypes = {
+		ProjectSN::ST_SPHERE | ProjectSN::ST_CF,
+		ProjectSN::ST_PLANE | ProjectSN::ST_FX,
+		ProjectSN::ST_PAPER | ProjectSN::ST_FL
+	};
+	for(int st : snapTypes) {
+		std::fill(output.begin(), output.end(), mpq_class(7));
+		p.snap(zero.begin(), zero.end(), output.begin(), st, 31);
+		CPPUNIT_ASSERT_MESSAGE(ProjectSN::toString((ProjectSN::SnapType) st), std::all_of(output.begin(), output.end(), [](const mpq_class & v) { return v == 7; }));
+	}
+	Profiler::Stats stats = Profiler::threadStats();
+	if (Profiler::enabled()) {
+		CPPUNIT_ASSERT_EQUAL(uint64_t(snapTypes.size()), stats.stages[Profiler::PS_SNAP].calls);
+		CPPUNIT_ASSERT_EQUAL(uint64_t(0), denominators(stats));
+	}
+	//nested snaps are recorded once with the result that is written
+	Profiler::reset();
+	int significands = p.snap(input.begin(), input.end(), output.begin(), ProjectSN::ST_PLANE | ProjectSN::ST_FX, Precision(2, 16, 1e-30));
+	CPPUNIT_ASSERT_EQUAL(-16, significands);
+	p.snapCanonical(input.begin(), input.end(), output.begin(), ProjectSN::ST_SPHERE | ProjectSN::ST_CF, 31);
+	stats = Profiler::threadStats();
+	if (Profiler::enabled()) {
+		CPPUNIT_ASSERT_EQUAL(uint64_t(2), stats.stages[Profiler::PS_SNAP].calls);
+		CPPUNIT_ASSERT_EQUAL(uint64_t(2*input.size()), denominators(stats));
+	}
+	else {
+		CPPUNIT_ASSERT_EQUAL(uint64_t(0), stats.stages[Profiler::PS_SNAP].calls);
+	}
+}
+
+void NDProjectionTest::batch() {
+	Projector p;
+	std::mt19937 gen(0);
+	std::uniform_real_distribution<double> dist(-1, 1);
+	for(int d : {2, 3, 5, 10}) {
+		std::size_t n = 1000;
+		ProjectSNBatch batch(d);
+		batch.resize(n);
+		std::vector< std::vector<double> > points(n, std::vector<double>(d));
+		for(std::size_t j(0); j < n; ++j) {
+			for(double & x : points[j]) {
+				x = dist(gen);
+			}
+			if (j % 4 == 1) { //equally large coordinates
+				points[j][d-1] = -points[j][0];
+			}
+			double len = std::sqrt(std::inner_product(points[j].begin(), points[j].end(), points[j].begin(), 0.0));
+			for(double & x : points[j]) {
+				x = (j % 100 == 3 ? 0.0 : x/len);
+			}
+			batch.set(j, points[j].begin());
+		}
+		batch.sphere2Plane();
+		std::vector<mpq_class> result(n*d);
+		batch.snap(result.begin(), ProjectSN::ST_FX | ProjectSN::ST_PLANE, 31);
+		std::vector<double> plane(d);
+		std::vector<mpfr::mpreal> input(d);
+		std::vector<mpq_class> expected(d);
+		for(std::size_t j(0); j < n; ++j) {
+			if (j % 100 == 3) {
+				CPPUNIT_ASSERT_EQUAL(SP_INVALID, batch.pos(j));
+				continue;
+			}
+			PositionOnSphere pos = p.sphere2Plane(points[j].begin(), points[j].end(), plane.begin());
+			CPPUNIT_ASSERT_EQUAL(pos, batch.pos(j));
+			for(int i(0); i < d; ++i) {
+				CPPUNIT_ASSERT_EQUAL(plane[i], batch.plane(i)[j]);
+				input[i] = mpfr::mpreal(points[j][i], 53);
+			}
+			p.snap(input.begin(), input.end(), expected.begin(), ProjectSN::ST_FX | ProjectSN::ST_PLANE, 31);
+			CPPUNIT_ASSERT(std::equal(expected.begin(), expected.end(), result.begin() + j*d));
+		}
+		//grouped by position
+		for(std::size_t k(1); k < n; ++k) {
+			CPPUNIT_ASSERT(batch.pos(batch.order()[k-1]) <= batch.pos(batch.order()[k]));
+		}
+	}
+}
+
+void NDProjectionTest::sphere2Plane2Sphere() {
+	Projector p;
+	std::mt19937 gen(0);
+	std::uniform_int_distribution<int> num(-1000000, 1000000);
+	std::uniform_int_distribution<int> den(1, 1000000);
+	for(int d : {1, 2, 3, 5, 10}) {
+		std::vector<mpq_class> coords(d), plane(d), expected(d);
+		for(int j(0); j < 1000; ++j) {
+			for(mpq_class & x : coords) {
+				//fixpoint, floating point and arbitrary denominators
+				mpz_class denom = (j % 3 == 0 ? mpz_class(1) << (j % 64) : mpz_class(den(gen)));
+				x = mpq_class(num(gen), denom);
+				x.canonicalize();
+			}
+			if (j % 4 == 1) { //equally large coordinates
+				coords[d-1] = -coords[0];
+			}
+			PositionOnSphere pos = p.sphere2Plane(coords.begin(), coords.end(), plane.begin());
+			p.plane2Sphere(plane.begin(), plane.end(), pos, expected.begin());
+			CPPUNIT_ASSERT_EQUAL(pos, p.sphere2Plane2Sphere(coords));
+			CPPUNIT_ASSERT(expected == coords);
+		}
+	}
+}
+
+void NDProjectionTest::snapPaper() {
+	Projector p;
+	std::mt19937 gen(0);
+	std::uniform_int_distribution<int> num(-1000000000, 1000000000);
+	for(int d : {2, 3, 5}) {
+		std::vector<mpfr::mpreal> input(d);
+		std::vector<mpq_class> expected(d), output(d), snapped(d);
+		std::vector<CORE::Expr> ptc(d);
+		for(int j(0); j < 200; ++j) {
+			for(mpfr::mpreal & x : input) {
+				x = mpfr::mpreal(num(gen), 128) / 1000000007;
+			}
+			if (j % 4 == 1) { //equally large coordinates
+				input[d-1] = -input[0];
+			}
+			if (j % 10 == 3) { //rational length
+				std::fill(input.begin(), input.end(), mpfr::mpreal(0, 128));
+				input[0] = 0.375;
+				input[d-1] = -0.5;
+			}
+			for(int sm : {ProjectSN::ST_CF, ProjectSN::ST_FX, ProjectSN::ST_FL}) {
+				for(int sig : {8, 16, 31, 53, 64}) {
+					//the former implementation with CORE
+					std::transform(input.begin(), input.end(), ptc.begin(), [](const mpfr::mpreal & x) -> CORE::Expr { return convert<CORE::Expr>(x); });
+					CORE::Expr len{0};
+					for(auto & x : ptc) {
+						len += x*x;
+					}
+					len = sqrt(len);
+					for(auto & x : ptc) {
+						x /= len;
+					}
+					PositionOnSphere pos = p.sphere2Plane(ptc.begin(), ptc.end(), ptc.begin());
+					//CORE may return any approximation within 2^-(2*sig) and so may snapPaper,
+					//both snap to the same point unless a coordinate is that close to a snapping boundary
+					mpq_class eps(mpz_class(1), mpz_class(1) << (2*sig));
+					bool ambiguous = false;
+					for(int i(0); i < d; ++i) {
+						mpq_class apx = convert<mpq_class>(ptc[i].approx(2*sig, 2*sig));
+						snapped[i] = p.calc().snap(apx, sm, sig);
+						if (ptc[i].sign() != 0) {
+							ambiguous = ambiguous || p.calc().snap(mpq_class(apx-eps), sm, sig) != snapped[i] || p.calc().snap(mpq_class(apx+eps), sm, sig) != snapped[i];
+						}
+					}
+					p.plane2Sphere(snapped.begin(), snapped.end(), pos, expected.begin());
+					
+					p.snap(input.begin(), input.end(), output.begin(), sm | ProjectSN::ST_PAPER, sig);
+					CPPUNIT_ASSERT_MESSAGE(ProjectSN::toString((ProjectSN::SnapType) sm), ambiguous || expected == output);
+				}
+			}
+		}
+	}
+}
+
+void NDProjectionTest::snapPaperApproximation() {
+	Projector p;
+	std::mt19937 gen(0);
+	std::uniform_int_distribution<int> num(-1000000000, 1000000000);
+	for(int d : {2, 3, 5}) {
+		std::vector<mpfr::mpreal> input(d), plane(d);
+		std::vector<mpq_class> expected(d), output(d), snapped(d);
+		for(int j(0); j < 200; ++j) {
+			for(mpfr::mpreal & x : input) {
+				x = mpfr::mpreal(num(gen), 128) / 1000000007;
+			}
+			if (j % 4 == 1) { //equally large coordinates
+				input[d-1] = -input[0];
+			}
+			if (j % 10 == 3) { //rational length
+				std::fill(input.begin(), input.end(), mpfr::mpreal(0, 128));
+				input[0] = 0.375;
+				input[d-1] = -0.5;
+			}
+			//a reference far more precise than 2*sig, it rounds differently only within 2^-4096 of a tie
+			mpfr::mpreal len(0, 4096);
+			for(int i(0); i < d; ++i) {
+				plane[i].setPrecision(4096);
+				mpfr_set(plane[i].mpfr_ptr(), input[i].mpfr_srcptr(), MPFR_RNDN);
+				len += plane[i]*plane[i];
+			}
+			len = mpfr::sqrt(len);
+			for(mpfr::mpreal & x : plane) {
+				x /= len;
+			}
+			PositionOnSphere pos = p.sphere2Plane(plane.begin(), plane.end(), plane.begin());
+			for(int sm : {ProjectSN::ST_CF, ProjectSN::ST_FX, ProjectSN::ST_FL}) {
+				for(int sig : {8, 16, 31, 53, 64, 200}) {
+					//the snapping of the approximation within CORE's approx(2*sig, 2*sig)
+					std::transform(plane.begin(), plane.end(), snapped.begin(), [&p, sm, sig](const mpfr::mpreal & x) -> mpq_class {
+						mpfr::mpreal apx(0, 2*sig);
+						mpfr_set(apx.mpfr_ptr(), x.mpfr_srcptr(), MPFR_RNDN);
+						return p.calc().snap(Conversion<mpfr::mpreal>::toMpq(apx), sm, sig);
+					});
+					p.plane2Sphere(snapped.begin(), snapped.end(), pos, expected.begin());
+					p.snap(input.begin(), input.end(), output.begin(), sm | ProjectSN::ST_PAPER, sig);
+					CPPUNIT_ASSERT_MESSAGE(ProjectSN::toString((ProjectSN::SnapType) sm), expected == output);
+				}
+			}
+		}
+	}
+}
+
+void NDProjectionTest::snapAutoGrades() {
+	Projector p;
+	GeoCalc gc;
+	std::array<mpfr::mpreal, 3> input;
+	std::array<mpq_class, 3> output, candidate, expected;
+	for(int policy : {ProjectSN::ST_AUTO_POLICY_MIN_SQUARED_DISTANCE, ProjectSN::ST_AUTO_POLICY_MIN_MAX_NORM}) {
+		for(int sl : {ProjectSN::ST_PLANE, ProjectSN::ST_SPHERE}) {
+			int snapType = sl | ProjectSN::ST_AUTO | ProjectSN::ST_AUTO_CF | ProjectSN::ST_AUTO_FX | ProjectSN::ST_AUTO_FL | policy;
+			for(int sig : {8, 16, 31, 53}) {
+				for(std::size_t i(0); i < coords.size() && i < 300; ++i) {
+					gc.cartesianFromSpherical(mpfr::mpreal(coords[i].theta, 128), mpfr::mpreal(coords[i].phi, 128), input[0], input[1], input[2]);
+					//the candidate with the exactly smallest grade, the first one on ties
+					mpq_class bestGrade;
+					for(int sm : {ProjectSN::ST_FL, ProjectSN::ST_FX, ProjectSN::ST_CF}) {
+						p.snap(input.begin(), input.end(), candidate.begin(), sm | sl, sig);
+						mpq_class grade = (policy == ProjectSN::ST_AUTO_POLICY_MIN_MAX_NORM ?
+							p.calc().maxNorm(input.begin(), input.end(), candidate.begin()) :
+							p.calc().squaredDistance(input.begin(), input.end(), candidate.begin()));
+						if (sm == ProjectSN::ST_FL || grade < bestGrade) {
+							bestGrade = grade;
+							expected = candidate;
+						}
+					}
+					p.snap(input.begin(), input.end(), output.begin(), snapType, sig);
+					CPPUNIT_ASSERT_MESSAGE(ProjectSN::toString((ProjectSN::SnapType) snapType), expected == output);
+				}
+			}
+		}
+	}
+}
+
+void NDProjectionTest::snapSize() {
+	SnapSize ss;
+	std::mt19937 gen(0);
+	std::uniform_real_distribution<double> dist(-1, 1);
+	constexpr int auto_cf_fx_fl = ProjectSN::ST_AUTO | ProjectSN::ST_AUTO_CF | ProjectSN::ST_AUTO_FX | ProjectSN::ST_AUTO_FL | ProjectSN::ST_AUTO_POLICY_MIN_MAX_DENOM;
+	//(31+2) bits on the plane, the projection doubles them and adds one
+	CPPUNIT_ASSERT_EQUAL(67, SnapSize::bound(ProjectSN::SnapConfig(ProjectSN::ST_FX | ProjectSN::ST_PLANE, 31), 3).denominator);
+	CPPUNIT_ASSERT(!SnapSize::bound(ProjectSN::SnapConfig(ProjectSN::ST_FL | ProjectSN::ST_PLANE, 31), 3).bounded());
+	//ProjectSN::snap does not write the zero point
+	{
+		std::vector<mpfr::mpreal> zero(3, mpfr::mpreal(0, 64));
+		for(int sl : {int(ProjectSN::ST_PLANE), int(ProjectSN::ST_SPHERE), int(ProjectSN::ST_PAPER)}) {
+			SnapSize::Bits bits = ss.bound(zero.begin(), zero.end(), ProjectSN::SnapConfig(ProjectSN::ST_FX | sl, 31));
+			CPPUNIT_ASSERT(!bits.bounded());
+			CPPUNIT_ASSERT(!bits.fits(63));
+		}
+	}
+	for(int d : {3, 5}) {
+		std::vector< std::vector<mpfr::mpreal> > points(200, std::vector<mpfr::mpreal>(d));
+		for(std::size_t j(0); j < points.size(); ++j) {
+			for(int i(0); i < d; ++i) {
+				//some small coordinates that have more bits with ST_FL
+				points[j][i] = mpfr::mpreal(dist(gen), 64) * (j % 7 == i ? mpfr::mpreal(1e-5, 64) : mpfr::mpreal(1, 64));
+			}
+		}
+		std::vector<int> snapTypes;
+		for(int sm : {int(ProjectSN::ST_FX), int(ProjectSN::ST_CF), int(ProjectSN::ST_FL), auto_cf_fx_fl}) {
+			snapTypes.push_back(sm | ProjectSN::ST_PLANE | ProjectSN::ST_NORMALIZE);
+			snapTypes.push_back(sm | ProjectSN::ST_SPHERE | ProjectSN::ST_NORMALIZE);
+			if (sm != auto_cf_fx_fl) {
+				snapTypes.push_back(sm | ProjectSN::ST_PAPER);
+			}
+		}
+		if (d == 3) {
+			snapTypes.push_back(ProjectSN::ST_JP | ProjectSN::ST_PLANE | ProjectSN::ST_NORMALIZE);
+		}
+		std::vector<mpq_class> snapped(d);
+		for(int st : snapTypes) {
+			for(int sig : {8, 31, 53}) {
+				ProjectSN::SnapConfig sc(st, sig);
+				std::string msg = ProjectSN::toString((ProjectSN::SnapType) st) + " sig=" + std::to_string(sig);
+				SnapSize::Bits all = SnapSize::bound(sc, d);
+				for(const auto & pt : points) {
+					SnapSize::Bits predicted = ss.bound(pt.begin(), pt.end(), sc);
+					ss.proj().snap(pt.begin(), pt.end(), snapped.begin(), sc);
+					SnapSize::Bits actual = SnapSize::bits(snapped.begin(), snapped.end());
+					CPPUNIT_ASSERT_MESSAGE(msg, predicted.bounded());
+					CPPUNIT_ASSERT_MESSAGE(msg, actual.numerator <= predicted.numerator);
+					CPPUNIT_ASSERT_MESSAGE(msg, actual.denominator <= predicted.denominator);
+					CPPUNIT_ASSERT_MESSAGE(msg, !all.bounded() || predicted.denominator <= all.denominator);
+				}
+				SnapSize::Distribution sample = ss.sample(points.begin(), points.end(), sc);
+				CPPUNIT_ASSERT_EQUAL(points.size(), sample.size());
+				CPPUNIT_ASSERT_EQUAL(sample.max().max(), sample.quantile(1.0));
+				CPPUNIT_ASSERT_EQUAL(1.0, sample.fraction(sample.max().max()));
+				CPPUNIT_ASSERT_MESSAGE(msg, !all.bounded() || sample.max().max() <= all.max());
+			}
+		}
+	}
+}
+
 void NDProjectionTest::snapCore(const RationalPoint & pt, int significand) {
 	Projector p;
 	GeoCalc gc;
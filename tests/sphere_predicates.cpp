@@ -0,0 +1,267 @@
+#include <libratss/constants.h>
+#include <libratss/ProjectS2.h>
+#include <libratss/SpherePredicates.h>
+
+#include "TestBase.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace LIB_RATSS_NAMESPACE {
+namespace tests {
+
+class SpherePredicatesTest: public TestBase {
+CPPUNIT_TEST_SUITE( SpherePredicatesTest );
+CPPUNIT_TEST( orientationRandom );
+CPPUNIT_TEST( inCircleRandom );
+CPPUNIT_TEST( degenerate );
+CPPUNIT_TEST( stages );
+CPPUNIT_TEST( truncation );
+CPPUNIT_TEST_SUITE_END();
+public:
+	static std::size_t num_random_test_points;
+public:
+	void orientationRandom();
+	void inCircleRandom();
+	void degenerate();
+	void stages();
+	void truncation();
+private:
+	struct Point {
+		mpq_class x, y, z;
+		SpherePoint sp;
+	};
+private:
+	///snapped points on the sphere, at most on the great circle z == 0 if equator is true
+	std::vector<Point> randomPoints(int snapType, int significands, bool equator = false);
+	static int orientation(const Point & p, const Point & q, const Point & r);
+	static int inCircle(const Point & p, const Point & q, const Point & r, const Point & s);
+	///point on the great circle z == 0 rotated by the quaternion (a, b, c, d)
+	///The point on the great circle is given by the pythagorean triple (m^2 - n^2, 2mn, m^2 + n^2).
+	static Point rotatedPoint(const mpz_class & a, const mpz_class & b, const mpz_class & c, const mpz_class & d, const mpz_class & m, const mpz_class & n);
+	///true if truncating v to double differs from rounding it to nearest
+	static bool truncates(const mpz_class & v);
+private:
+	ProjectS2 proj;
+};
+
+std::size_t SpherePredicatesTest::num_random_test_points;
+
+}} // end namespace ratss::tests
+
+int main(int argc, char ** argv) {
+	LIB_RATSS_NAMESPACE::tests::TestBase::init(argc, argv);
+	LIB_RATSS_NAMESPACE::tests::SpherePredicatesTest::num_random_test_points = 200;
+	srand( 0 );
+	CppUnit::TextUi::TestRunner runner;
+	runner.addTest(  LIB_RATSS_NAMESPACE::tests::SpherePredicatesTest::suite() );
+	bool ok = runner.run();
+	return ok ? 0 : 1;
+}
+
+namespace LIB_RATSS_NAMESPACE {
+namespace tests {
+
+std::vector<SpherePredicatesTest::Point>
+SpherePredicatesTest::randomPoints(int snapType, int significands, bool equator) {
+	std::mt19937 gen(significands);
+	std::uniform_real_distribution<double> lat(-90, 90), lon(-180, 180);
+	std::vector<Point> result(num_random_test_points);
+	for(Point & p : result) {
+		double la = (equator ? 0 : lat(gen))*M_PI/180;
+		double lo = lon(gen)*M_PI/180;
+		mpfr::mpreal x(std::cos(la)*std::cos(lo)), y(std::cos(la)*std::sin(lo)), z(std::sin(la));
+		proj.snap(x, y, z, p.x, p.y, p.z, significands, snapType);
+		p.sp = SpherePoint(p.x, p.y, p.z);
+		CPPUNIT_ASSERT(p.sp.isOnSphere());
+	}
+	return result;
+}
+
+SpherePredicatesTest::Point
+SpherePredicatesTest::rotatedPoint(const mpz_class & a, const mpz_class & b, const mpz_class & c, const mpz_class & d, const mpz_class & m, const mpz_class & n) {
+	mpz_class x = m*m - n*n, y = 2*m*n;
+	mpz_class rx = (a*a + b*b - c*c - d*d)*x + 2*(b*c - a*d)*y;
+	mpz_class ry = 2*(b*c + a*d)*x + (a*a - b*b + c*c - d*d)*y;
+	mpz_class rz = 2*(b*d - a*c)*x + 2*(c*d + a*b)*y;
+	mpz_class rw = (a*a + b*b + c*c + d*d)*(m*m + n*n);
+	Point p;
+	p.x = mpq_class(rx, rw);
+	p.y = mpq_class(ry, rw);
+	p.z = mpq_class(rz, rw);
+	p.x.canonicalize();
+	p.y.canonicalize();
+	p.z.canonicalize();
+	p.sp = SpherePoint(rx, ry, rz, rw);
+	return p;
+}
+
+bool SpherePredicatesTest::truncates(const mpz_class & v) {
+	int bits = ::mpz_sizeinbase(v.get_mpz_t(), 2);
+	if (bits <= std::numeric_limits<double>::digits) {
+		return false;
+	}
+	mpz_class remainder = abs(v - mpz_class(v.get_d()));
+	mpz_class halfUlp;
+	::mpz_ui_pow_ui(halfUlp.get_mpz_t(), 2, bits - std::numeric_limits<double>::digits - 1);
+	return remainder > halfUlp;
+}
+
+int SpherePredicatesTest::orientation(const Point & p, const Point & q, const Point & r) {
+	mpq_class det = p.x*(q.y*r.z - q.z*r.y) - p.y*(q.x*r.z - q.z*r.x) + p.z*(q.x*r.y - q.y*r.x);
+	return ::sgn(det);
+}
+
+int SpherePredicatesTest::inCircle(const Point & p, const Point & q, const Point & r, const Point & s) {
+	mpq_class ax(q.x-p.x), ay(q.y-p.y), az(q.z-p.z);
+	mpq_class bx(r.x-p.x), by(r.y-p.y), bz(r.z-p.z);
+	mpq_class cx(s.x-p.x), cy(s.y-p.y), cz(s.z-p.z);
+	mpq_class det = cx*(ay*bz - az*by) - cy*(ax*bz - az*bx) + cz*(ax*by - ay*bx);
+	return ::sgn(det);
+}
+
+void SpherePredicatesTest::orientationRandom() {
+	for(int snapType : {ProjectSN::ST_FX | ProjectSN::ST_PLANE | ProjectSN::ST_NORMALIZE, ProjectSN::ST_CF | ProjectSN::ST_SPHERE}) {
+		for(int significands : {20, 31, 53}) {
+			std::vector<Point> points = randomPoints(snapType, significands);
+			for(std::size_t i(0); i+2 < points.size(); ++i) {
+				const Point & p = points[i];
+				const Point & q = points[i+1];
+				const Point & r = points[i+2];
+				CPPUNIT_ASSERT_EQUAL(orientation(p, q, r), SpherePredicates::orientation(p.sp, q.sp, r.sp));
+				CPPUNIT_ASSERT_EQUAL(orientation(p, q, r), SpherePredicates::sideOfGreatCircle(p.sp, q.sp, r.sp));
+			}
+		}
+	}
+}
+
+void SpherePredicatesTest::inCircleRandom() {
+	for(int snapType : {ProjectSN::ST_FX | ProjectSN::ST_PLANE | ProjectSN::ST_NORMALIZE, ProjectSN::ST_CF | ProjectSN::ST_SPHERE}) {
+		for(int significands : {20, 31, 53}) {
+			std::vector<Point> points = randomPoints(snapType, significands);
+			for(std::size_t i(0); i+3 < points.size(); ++i) {
+				const Point & p = points[i];
+				const Point & q = points[i+1];
+				const Point & r = points[i+2];
+				const Point & s = points[i+3];
+				CPPUNIT_ASSERT_EQUAL(inCircle(p, q, r, s), SpherePredicates::inCircle(p.sp, q.sp, r.sp, s.sp));
+			}
+		}
+	}
+}
+
+void SpherePredicatesTest::degenerate() {
+	int snapType = ProjectSN::ST_FX | ProjectSN::ST_PLANE | ProjectSN::ST_NORMALIZE;
+	for(int significands : {20, 31, 53}) {
+		std::vector<Point> points = randomPoints(snapType, significands, true);
+		for(std::size_t i(0); i+3 < points.size(); ++i) {
+			const Point & p = points[i];
+			const Point & q = points[i+1];
+			const Point & r = points[i+2];
+			const Point & s = points[i+3];
+			CPPUNIT_ASSERT_EQUAL(orientation(p, q, r), SpherePredicates::orientation(p.sp, q.sp, r.sp));
+			CPPUNIT_ASSERT_EQUAL(0, SpherePredicates::inCircle(p.sp, q.sp, r.sp, s.sp));
+			CPPUNIT_ASSERT_EQUAL(0, SpherePredicates::inCircle(p.sp, q.sp, r.sp, p.sp));
+			CPPUNIT_ASSERT_EQUAL(0, SpherePredicates::orientation(p.sp, q.sp, p.sp));
+		}
+	}
+	//the north pole is inside every ccw circle on the equator
+	SpherePoint north(0, 0, 1, 1), south(0, 0, -1, 1);
+	SpherePoint a(1, 0, 0, 1), b(0, 1, 0, 1), c(-1, 0, 0, 1);
+	CPPUNIT_ASSERT_EQUAL(1, SpherePredicates::orientation(a, b, north));
+	CPPUNIT_ASSERT_EQUAL(1, SpherePredicates::inCircle(a, b, c, north));
+	CPPUNIT_ASSERT_EQUAL(-1, SpherePredicates::inCircle(a, b, c, south));
+	CPPUNIT_ASSERT_EQUAL(0, SpherePredicates::orientation(a, b, c));
+}
+
+void SpherePredicatesTest::stages() {
+	int snapType = ProjectSN::ST_FX | ProjectSN::ST_PLANE | ProjectSN::ST_NORMALIZE;
+	std::vector<Point> points = randomPoints(snapType, 31, true);
+	CPPUNIT_ASSERT_EQUAL(0, SpherePredicates::inCircle(points[0].sp, points[1].sp, points[2].sp, points[3].sp));
+	CPPUNIT_ASSERT(points[0].sp.bits() <= SpherePredicates::MAX_WORD_BITS);
+#ifdef __SIZEOF_INT128__
+	CPPUNIT_ASSERT_EQUAL(SpherePredicates::S_INT128, SpherePredicates::lastStage());
+#endif
+	points = randomPoints(snapType, 53, true);
+	CPPUNIT_ASSERT_EQUAL(0, SpherePredicates::inCircle(points[0].sp, points[1].sp, points[2].sp, points[3].sp));
+	CPPUNIT_ASSERT_EQUAL(SpherePredicates::S_GMP, SpherePredicates::lastStage());
+	points = randomPoints(snapType, 20);
+	SpherePredicates::orientation(points[0].sp, points[1].sp, points[2].sp);
+	CPPUNIT_ASSERT_EQUAL(SpherePredicates::S_DOUBLE, SpherePredicates::lastStage());
+}
+
+void SpherePredicatesTest::truncation() {
+	//Coordinates whose lower bits are all set lose almost an ulp when truncated to double.
+	//r = +-p +- q is on the great circle through p and q but the truncated coordinates are not.
+	std::mt19937 gen(0);
+	std::uniform_int_distribution<int> shift(1, 3), sign(0, 1);
+	std::uniform_int_distribution<long> middle(0, (long(1) << 20) - 1);
+	for(int bits : {63, 64, 80}) {
+		mpz_class low;
+		::mpz_ui_pow_ui(low.get_mpz_t(), 2, bits-std::numeric_limits<double>::digits);
+		for(int i(0); i < 1000; ++i) {
+			std::array<mpz_class, 3> c[3];
+			for(int j(0); j < 2; ++j) {
+				for(mpz_class & v : c[j]) {
+					::mpz_ui_pow_ui(v.get_mpz_t(), 2, bits-shift(gen));
+					v += (middle(gen)+1)*low - 1;
+					CPPUNIT_ASSERT(truncates(v));
+					if (sign(gen)) {
+						v = -v;
+					}
+				}
+			}
+			int s0 = 2*sign(gen)-1, s1 = 2*sign(gen)-1;
+			for(int k(0); k < 3; ++k) {
+				c[2][k] = s0*c[0][k] + s1*c[1][k];
+			}
+			SpherePoint p(c[0][0], c[0][1], c[0][2], 1), q(c[1][0], c[1][1], c[1][2], 1);
+			CPPUNIT_ASSERT_EQUAL(0, SpherePredicates::orientation(p, q, SpherePoint(c[2][0], c[2][1], c[2][2], 1)));
+			//r moved off the great circle by one unit
+			c[2][2] += 2*sign(gen)-1;
+			SpherePoint r(c[2][0], c[2][1], c[2][2], 1);
+			mpz_class det = p.x()*(q.y()*r.z() - q.z()*r.y()) - p.y()*(q.x()*r.z() - q.z()*r.x()) + p.z()*(q.x()*r.y() - q.y()*r.x());
+			CPPUNIT_ASSERT_EQUAL(::sgn(det), SpherePredicates::orientation(p, q, r));
+		}
+	}
+	//Points on rotated great circles. Their coordinates have about 62 resp. 102 bits.
+	for(int paramBits : {15, 25}) {
+		std::uniform_int_distribution<long> param(long(1) << (paramBits-1), (long(1) << paramBits) - 1);
+		mpz_class a(param(gen)), b(param(gen)), c(param(gen)), d(param(gen));
+		std::vector<Point> points;
+		int numTruncating = 0;
+		for(std::size_t i(0); i < 64; ++i) {
+			mpz_class m(param(gen)), n(param(gen));
+			if (i % 2) {
+				points.push_back(rotatedPoint(param(gen), param(gen), param(gen), param(gen), m, n));
+			}
+			else {
+				points.push_back(rotatedPoint(a, b, c, d, m, n));
+			}
+			const SpherePoint & sp = points.back().sp;
+			CPPUNIT_ASSERT(sp.isOnSphere());
+			numTruncating += truncates(sp.x()) + truncates(sp.y()) + truncates(sp.z()) + truncates(sp.w());
+		}
+		CPPUNIT_ASSERT(numTruncating > 0);
+		for(std::size_t i(0); i+3 < points.size(); ++i) {
+			const Point & p = points[i];
+			const Point & q = points[i+1];
+			const Point & r = points[i+2];
+			const Point & s = points[i+3];
+			CPPUNIT_ASSERT_EQUAL(orientation(p, q, r), SpherePredicates::orientation(p.sp, q.sp, r.sp));
+			CPPUNIT_ASSERT_EQUAL(inCircle(p, q, r, s), SpherePredicates::inCircle(p.sp, q.sp, r.sp, s.sp));
+		}
+		//every second point is on the same great circle
+		for(std::size_t i(0); i+6 < points.size(); i += 2) {
+			const Point & p = points[i];
+			const Point & q = points[i+2];
+			const Point & r = points[i+4];
+			const Point & s = points[i+6];
+			CPPUNIT_ASSERT_EQUAL(0, SpherePredicates::orientation(p.sp, q.sp, r.sp));
+			CPPUNIT_ASSERT_EQUAL(0, SpherePredicates::inCircle(p.sp, q.sp, r.sp, s.sp));
+		}
+	}
+}
+
+}} //end namespace ratss::tests
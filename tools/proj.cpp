@@ -1,4 +1,5 @@
 #include <libratss/ProjectSN.h>
+#include <libratss/Profiler.h>
 #include <libratss/util/BasicCmdLineOptions.h>
 #include <libratss/util/InputOutputPoints.h>
 #include <libratss/util/InputOutput.h>
@@ -14,10 +15,12 @@ class Config: public BasicCmdLineOptions {
 public:
 	bool stats;
 	bool check;
+	bool profile;
 public:
 	Config() :
 	stats(false),
-	check(false)
+	check(false),
+	profile(false)
 	{}
 	using BasicCmdLineOptions::parse;
 	virtual bool parse(const std::string & token, int &, int , char **) {
@@ -27,6 +30,9 @@ public:
 		else if (token == "-b") {
 			stats = true;
 		}
+		else if (token == "--profile") {
+			profile = true;
+		}
 		else {
 			return false;
 		}
@@ -37,12 +43,14 @@ public:
 		out << "prg OPTIONS\n"
 			"Options:\n"
 			"\t-b\talso print bitsize statistics\n"
-			"\t-c\tcheck projected points\n";
+			"\t-c\tcheck projected points\n"
+			"\t--profile\tprint per-stage timings of snapping (needs LIBRATSS_WITH_PROFILING)\n";
 		BasicCmdLineOptions::options_help(out);
 		out << std::endl;
 	}
 	void print(std::ostream & out) const {
 		out << "Check: " << (check ? "yes" : "no") << '\n';
+		out << "Profile: " << (profile ? "yes" : "no") << '\n';
 		BasicCmdLineOptions::options_selection(out);
 	}
 };
@@ -75,17 +83,18 @@ int main(int argc, char ** argv) {
 		io.info() << std::endl;
 	}
 	std::size_t counter = 0;
-	while( io.input().good() ) {
-		for( ; io.input().good() && io.input().peek() == '\n'; ) {
-			io.input().get();
-			io.output().put('\n');
+	Tokenizer tokenizer(io.input());
+	OutputBuffer out(io.output());
+	while( tokenizer.good() ) {
+		while (tokenizer.newline()) {
+			out.put('\n');
 		}
-		if (!io.input().good()) {
+		if (!tokenizer.good()) {
 			break;
 		}
 		bool opFromIp = !cfg.rationalPassThrough;
 		if (cfg.rationalPassThrough) {
-			op.assign(io.input(), cfg.inFormat, cfg.precision);
+			op.assign(tokenizer, cfg.inFormat, cfg.precision);
 			if (!op.valid()) {
 				if (!cfg.normalize) {
 					std::cerr << "Input point read that is not on sphere but no normalization was requested" << std::endl;
@@ -97,7 +106,7 @@ int main(int argc, char ** argv) {
 			}
 		}
 		else {
-			ip.assign(io.input(), cfg.inFormat, cfg.precision);
+			ip.assign(tokenizer, cfg.inFormat, cfg.precision);
 		}
 		
 		if (opFromIp) {
@@ -122,9 +131,10 @@ int main(int argc, char ** argv) {
 			io.info() << "Invalid projection for point " << ip << std::endl;
 			return -1;
 		}
-		op.print(io.output(), cfg.outFormat);
-		if (io.input().peek() != '\n') {
-			io.output().put(' ');
+		op.print(out, cfg.outFormat);
+		//blanks at the end of the line do not start another point
+		if (!tokenizer.lineEnd() || tokenizer.peek() != '\n') {
+			out.put(' ');
 		}
 		
 		++counter;
@@ -132,10 +142,20 @@ int main(int argc, char ** argv) {
 			io.info() << '\xd' << counter/1000 << "k" << std::flush;
 		}
 	}
+	out.flush();
 	
 	if (cfg.stats) {
 		io.info() << bc << std::endl;
 	}
 	
+	if (cfg.profile) {
+		if (!Profiler::enabled()) {
+			io.info() << "Profiling is not available, rebuild with LIBRATSS_WITH_PROFILING=ON" << std::endl;
+		}
+		else {
+			io.info() << Profiler::stats() << std::endl;
+		}
+	}
+	
 	return 0;
 }
\ No newline at end of file
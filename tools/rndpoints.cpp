@@ -3,11 +3,16 @@
 
 #include <random>
 #include <chrono>
-
-#ifdef LIB_RATSS_WITH_CGAL
-#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
-#include <CGAL/point_generators_3.h>
-#endif
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <array>
+#include <sstream>
+#include <limits>
+#include <cmath>
 
 #include <libratss/util/InputOutputPoints.h>
 
@@ -15,12 +20,65 @@ using namespace LIB_RATSS_NAMESPACE;
 
 typedef enum {GT_NPLANE, GT_NSPHERE, GT_CGAL, GT_GEO, GT_GEOGRID } GeneratorType;
 
+///Philox4x32-10 counter based random number generator, see
+///Salmon et al.: Parallel random numbers: as easy as 1, 2, 3
+///The output only depends on the seed, the stream and the position in the stream.
+///Every point uses its own stream, hence the points do not depend on the number of threads.
+class CounterEngine {
+public:
+	using result_type = uint64_t;
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+public:
+	CounterEngine(uint64_t seed, uint64_t stream) :
+	m_seed(seed),
+	m_stream(stream),
+	m_counter(0),
+	m_pos(2)
+	{}
+	result_type operator()() {
+		if (m_pos == 2) {
+			refill();
+		}
+		return m_out[m_pos++];
+	}
+private:
+	void refill() {
+		uint32_t c[4] = {uint32_t(m_counter), uint32_t(m_counter >> 32), uint32_t(m_stream), uint32_t(m_stream >> 32)};
+		uint32_t k[2] = {uint32_t(m_seed), uint32_t(m_seed >> 32)};
+		for(int round(0); round < 10; ++round) {
+			if (round) {
+				k[0] += 0x9E3779B9;
+				k[1] += 0xBB67AE85;
+			}
+			uint64_t p0 = uint64_t(0xD2511F53) * c[0];
+			uint64_t p1 = uint64_t(0xCD9E8D57) * c[2];
+			uint32_t c1 = c[1], c3 = c[3];
+			c[0] = uint32_t(p1 >> 32) ^ c1 ^ k[0];
+			c[1] = uint32_t(p1);
+			c[2] = uint32_t(p0 >> 32) ^ c3 ^ k[1];
+			c[3] = uint32_t(p0);
+		}
+		m_out[0] = (uint64_t(c[1]) << 32) | c[0];
+		m_out[1] = (uint64_t(c[3]) << 32) | c[2];
+		m_pos = 0;
+		++m_counter;
+	}
+private:
+	uint64_t m_seed;
+	uint64_t m_stream;
+	uint64_t m_counter;
+	uint64_t m_out[2];
+	int m_pos;
+};
+
 struct PointGenerator {
 	ProjectS2 proj;
 	GeoCalc gc;
 
 	virtual ~PointGenerator() {}
-	virtual RationalPoint generate(int dimension, bool snap) = 0;
+	///rng is the random stream of the point
+	virtual RationalPoint generate(int dimension, bool snap, CounterEngine & rng) = 0;
 	virtual bool supports(int dimension) const = 0;
 	template<typename T_FLOAT_ITERATOR>
 	RationalPoint toRationalPoint(T_FLOAT_ITERATOR begin, const T_FLOAT_ITERATOR & end, int snapType) {
@@ -37,21 +95,25 @@ struct PointGenerator {
 	}
 };
 
-#ifdef LIB_RATSS_WITH_CGAL
-
+///Uniformly distributed points on S^2 like CGAL::Random_points_on_sphere_3, snapped with continued fractions.
+///The points are normalized vectors of normal variates drawn from the stream of the point.
+///Seeding a CGAL::Random per point only took 32 bits of the stream, so points repeated.
 struct CGALPointGenerator: PointGenerator {
-	using K = CGAL::Exact_predicates_inexact_constructions_kernel;
-	using Rand = CGAL::Random_points_on_sphere_3<K::Point_3>;
-	
-	Rand rnd;
-	
-	CGALPointGenerator() : rnd(1.0) {}
 	virtual ~CGALPointGenerator() {}
 	
-	virtual RationalPoint generate(int /*dimension*/, bool snap) override {
-		K::Point_3 p = *rnd;
-		++rnd;
-		std::array<mpfr::mpreal, 3> vec = {{p.x(), p.y(), p.z()}};
+	virtual RationalPoint generate(int /*dimension*/, bool snap, CounterEngine & rng) override {
+		//a fresh distribution does not carry cached values over to the next point
+		std::normal_distribution<double> normalRnd(0.0, 1.0);
+		std::array<double, 3> p;
+		double sqLen = 0;
+		while (sqLen == 0) {
+			for(double & v : p) {
+				v = normalRnd(rng);
+			}
+			sqLen = p[0]*p[0] + p[1]*p[1] + p[2]*p[2];
+		}
+		double len = std::sqrt(sqLen);
+		std::array<mpfr::mpreal, 3> vec = {{p[0]/len, p[1]/len, p[2]/len}};
 		if (snap) {
 			return toRationalPoint(vec.begin(), vec.end(), ProjectSN::ST_CF | ProjectSN::ST_SPHERE | ProjectSN::ST_NORMALIZE);
 		}
@@ -64,34 +126,13 @@ struct CGALPointGenerator: PointGenerator {
 		return (dimension == 3);
 	}
 };
-#else
-	struct CGALPointGenerator: PointGenerator {
-		virtual ~CGALPointGenerator() {}
-		virtual RationalPoint generate(int, bool) override {
-			return RationalPoint();
-		}
-		virtual bool supports(int) const override {
-			return false;
-		}
-	};
-
-#endif
 
 struct GeoPointGenerator: PointGenerator {
-	std::uniform_real_distribution<double> urdLat;
-	std::uniform_real_distribution<double> urdLon;
-	std::default_random_engine gen;
-	
-	GeoPointGenerator() :
-		urdLat(-90, 90),
-		urdLon(-180, 180),
-		gen(std::chrono::system_clock::now().time_since_epoch().count())
-	{}
 	virtual ~GeoPointGenerator() {}
 	
-	virtual RationalPoint generate(int /*dimension*/, bool snap) override {
-		double lat = urdLat(gen);
-		double lon = urdLon(gen);
+	virtual RationalPoint generate(int /*dimension*/, bool snap, CounterEngine & rng) override {
+		double lat = std::uniform_real_distribution<double>(-90, 90)(rng);
+		double lon = std::uniform_real_distribution<double>(-180, 180)(rng);
 		
 		if (snap) {
 			RationalPoint ret(3);
@@ -110,81 +151,100 @@ struct GeoPointGenerator: PointGenerator {
 	}
 };
 
-struct GeoGridGenerator: PointGenerator {
+///Grid with nofSlices slices per quarter circle, consisting of the north pole,
+///2*nofSlices-1 latitude bands of 4*nofSlices points each and the south pole.
+///Every band is symmetric under sign changes of x and y and under swapping them.
+///Hence only the points with longitude in [0, 45] are snapped, the others are mirrored.
+struct GeoGridGenerator {
+	///a band has 4*nofSlices points which have to be countable with 32 bits
+	static constexpr uint32_t MAX_SLICES = std::numeric_limits<uint32_t>::max()/4;
 	ProjectS2 proj;
+	uint32_t nofSlices;
+	int significands;
 	
-	virtual ~GeoGridGenerator() {}
+	GeoGridGenerator(uint32_t nofSlices, int significands) : nofSlices(nofSlices), significands(significands) {}
 	
-	virtual RationalPoint generate(int, bool) override {
-		return RationalPoint();
+	bool supports(int dimension) const {
+		return (dimension == 3);
 	}
 	
-	virtual bool supports(int dimension) const override {
-		return (dimension == 3);
+	///number of bands including the poles
+	uint32_t numBands() const {
+		return (nofSlices ? 2*nofSlices+1 : 0);
 	}
-        
-	std::vector<RationalPoint> generateAll( uint32_t nofSlices ){
-		// nofSlices >= 1== number of slices on an eighth sphere
-		std::vector<RationalPoint> result(0);
-		if( nofSlices < 1)
-			return result;
-		
-		RationalPoint northPole(3);
-		northPole.coords = { 0, 0, 1 };
-		result.push_back( northPole );     // north pole
-		
-		// lat in [-90,+90]
-		// lon in [0,360)
-		
+	
+	///calls cb(const RationalPoint &) for every point of band by increasing longitude in [0, 360)
+	///band 0 is the north pole, band numBands()-1 the south pole
+	template<typename T_CALLBACK>
+	void generateBand(uint32_t band, T_CALLBACK cb) {
+		RationalPoint ret(3);
+		if (band == 0 || band == 2*nofSlices) {
+			ret.coords = { 0, 0, (band ? -1 : 1) };
+			cb(ret);
+			return;
+		}
 		const double angleInc = 90.0 / nofSlices;
+		double lat = +90.0 - angleInc * band;
 		
-		for( uint32_t sLat=1; sLat <2*nofSlices; ++sLat ){
-			double lat = +90.0 - angleInc * sLat;
-			
-			for( uint32_t sLon=0; sLon < 4*nofSlices; ++sLon ){
-				RationalPoint ret(3);
-				double lon = angleInc * sLon;
-				proj.projectFromGeo( mpfr::mpreal(lat), mpfr::mpreal(lon), ret.coords[0], ret.coords[1], ret.coords[2]);
-				result.push_back( ret );
-			}
+		//the points with lon = j*angleInc for j <= nofSlices/2
+		std::vector< std::array<mpq_class, 3> > octant(nofSlices/2+1);
+		for(uint32_t j(0); j < octant.size(); ++j) {
+			proj.projectFromGeo( mpfr::mpreal(lat), mpfr::mpreal(angleInc * j), octant[j][0], octant[j][1], octant[j][2], significands);
 		}
 		
-		RationalPoint southPole(3);
-		southPole.coords = { 0, 0, -1 };
-		result.push_back( southPole );     // south pole
-		
-		return result;
+		for(uint32_t sLon(0); sLon < 4*nofSlices; ++sLon) {
+			uint32_t quadrant = sLon / nofSlices;
+			uint32_t j = sLon % nofSlices;
+			mpq_class & x = ret.coords[0];
+			mpq_class & y = ret.coords[1];
+			//lon = 90 - lon' swaps x and y
+			const std::array<mpq_class, 3> & src = octant[std::min(j, nofSlices-j)];
+			x = src[j < octant.size() ? 0 : 1];
+			y = src[j < octant.size() ? 1 : 0];
+			ret.coords[2] = src[2];
+			//lon + 90 maps (x, y) to (-y, x)
+			for(uint32_t i(0); i < quadrant; ++i) {
+				::mpq_swap(x.get_mpq_t(), y.get_mpq_t());
+				x = -x;
+			}
+			cb(ret);
+		}
+	}
+	
+	///calls cb(const RationalPoint &) for every point from north to south
+	template<typename T_CALLBACK>
+	void generateAll(T_CALLBACK cb) {
+		for(uint32_t band(0); band < numBands(); ++band) {
+			generateBand(band, cb);
+		}
 	}
 };
 
 struct NPlanePointGenerator: PointGenerator {
-	std::uniform_real_distribution<double> circleRnd;
-	std::uniform_int_distribution<uint32_t> boolRnd;
-	std::default_random_engine gen;
 	ProjectSN proj;
 	
-	NPlanePointGenerator() : circleRnd(-1.0, 1.0), boolRnd(0, 1) {}
 	virtual ~NPlanePointGenerator() {}
 	
-	void gen_plane_point(std::size_t count, FloatPoint & ip) {
+	void gen_plane_point(std::size_t count, FloatPoint & ip, CounterEngine & rng) {
+		std::uniform_real_distribution<double> circleRnd(-1.0, 1.0);
 		ip.coords.resize(count);
 		for(mpfr::mpreal & v : ip.coords) {
-			v = circleRnd(gen);
+			v = circleRnd(rng);
 		}
 	}
 	
-	virtual RationalPoint generate(int dimension, bool snap) override {
+	virtual RationalPoint generate(int dimension, bool snap, CounterEngine & rng) override {
 		FloatPoint ip;
 		RationalPoint ret;
 		ret.resize(dimension); 
 		while (true) {
-			gen_plane_point(dimension-1, ip);
+			gen_plane_point(dimension-1, ip, rng);
 			if (ip.sqLen() <= 1.0) {
 				break;
 			}
 		}
 		ip.coords.emplace_back(0);
-		bool positiveSide = boolRnd(gen);
+		bool positiveSide = std::uniform_int_distribution<uint32_t>(0, 1)(rng);
 		if (snap) {
 			std::vector<mpq_class> snapVec(ip.coords.size());
 			proj.calc().toRational(ip.coords.begin(), ip.coords.end(), snapVec.begin(), Calc::ST_CF);
@@ -205,17 +265,16 @@ struct NPlanePointGenerator: PointGenerator {
 };
 
 struct NSpherePointGenerator: PointGenerator {
-	std::normal_distribution<double> circleRnd;
-	std::default_random_engine gen;
 	ProjectSN proj;
 	
-	NSpherePointGenerator() : circleRnd(0.0, 1.0) {}
 	virtual ~NSpherePointGenerator() {}
 	
-	virtual RationalPoint generate(int dimension, bool snap) override {
+	virtual RationalPoint generate(int dimension, bool snap, CounterEngine & rng) override {
+		//a fresh distribution does not carry cached values over to the next point
+		std::normal_distribution<double> circleRnd(0.0, 1.0);
 		std::vector<mpfr::mpreal> vec; 
 		for(int i(0); i < dimension; ++i) {
-			vec.emplace_back( circleRnd(gen) );
+			vec.emplace_back( circleRnd(rng) );
 		}
 		if (snap) {
 			return toRationalPoint(vec.begin(), vec.end(), ProjectSN::ST_FX | ProjectSN::ST_SPHERE | ProjectSN::ST_NORMALIZE);
@@ -236,7 +295,10 @@ void help(std::ostream & out) {
 		"-g generator\tgenerator = (nplane|nsphere|cgal|geo|geogrid)\n"
 		"-f format\tformat = (rational|split|float|float128|geo|spherical)\n"
 		"-d dimensions\n"
-		"-n number\tnumber of points to create\n"
+		"-n number\tnumber of points to create, number of slices per quarter circle for geogrid\n"
+		"-e significands\tsignificands used to snap geogrid points, defaults to the precision of the angles\n"
+		"-s, --seed seed\tseed of the random streams, defaults to the current time\n"
+		"-t threads\tnumber of threads, the output does not depend on it\n"
 		"--no-snap\tdon't snap points to the sphere"
 		<< std::endl;
 }
@@ -245,10 +307,22 @@ struct Config {
 	GeneratorType gt;
 	RationalPoint::Format ft;
 	int dimension;
-	uint32_t count;
+	uint64_t count;
+	uint64_t seed;
+	int significands;
+	int threads;
 	bool snap;
 	
-	Config() : gt(GT_NPLANE), ft(RationalPoint::FM_RATIONAL), dimension(3), count(0), snap(true) {}
+	Config() :
+	gt(GT_NPLANE),
+	ft(RationalPoint::FM_RATIONAL),
+	dimension(3),
+	count(0),
+	seed(std::chrono::system_clock::now().time_since_epoch().count()),
+	significands(-1),
+	threads(1),
+	snap(true)
+	{}
 	
 	int parse(int argc, char ** argv) {
 		for(int i(1); i < argc; ++i) {
@@ -326,7 +400,37 @@ struct Config {
 			}
 			else if (token == "-n") {
 				if (i+1 < argc) {
-					count = ::atoi(argv[i+1]);
+					count = ::strtoull(argv[i+1], 0, 10);
+					++i;
+				}
+				else {
+					help(std::cerr);
+					return -1;
+				}
+			}
+			else if (token == "-s" || token == "--seed") {
+				if (i+1 < argc) {
+					seed = ::strtoull(argv[i+1], 0, 10);
+					++i;
+				}
+				else {
+					help(std::cerr);
+					return -1;
+				}
+			}
+			else if (token == "-e") {
+				if (i+1 < argc) {
+					significands = ::atoi(argv[i+1]);
+					++i;
+				}
+				else {
+					help(std::cerr);
+					return -1;
+				}
+			}
+			else if (token == "-t") {
+				if (i+1 < argc) {
+					threads = std::max(1, ::atoi(argv[i+1]));
 					++i;
 				}
 				else {
@@ -352,52 +456,151 @@ struct Config {
 	}
 };
 
+PointGenerator * createGenerator(GeneratorType gt) {
+	switch (gt) {
+	case GT_NPLANE:
+		return new NPlanePointGenerator();
+	case GT_NSPHERE:
+		return new NSpherePointGenerator();
+	case GT_CGAL:
+		return new CGALPointGenerator();
+	case GT_GEO:
+		return new GeoPointGenerator();
+	default:
+		return 0;
+	}
+}
+
+///Renders numChunks chunks on threads threads and writes them in order.
+///At most 2*threads finished chunks wait for the output.
+class ChunkWriter {
+public:
+	///renders one chunk, every thread uses its own renderer
+	using Renderer = std::function<void(uint64_t chunk, OutputBuffer & out)>;
+public:
+	ChunkWriter(uint64_t numChunks, int threads) :
+	m_numChunks(numChunks),
+	m_threads(threads),
+	m_slots(2*threads),
+	m_nextChunk(0),
+	m_written(0)
+	{}
+	///makeRenderer is called once per thread
+	void run(std::ostream & out, const std::function<Renderer()> & makeRenderer) {
+		std::vector<std::thread> workers;
+		for(int i(0); i < m_threads; ++i) {
+			workers.emplace_back([this, &makeRenderer]() { work(makeRenderer()); });
+		}
+		for(; m_written < m_numChunks;) {
+			Slot & slot = m_slots[m_written % m_slots.size()];
+			std::string data;
+			{
+				std::unique_lock<std::mutex> lck(m_lock);
+				m_cv.wait(lck, [this, &slot]() { return slot.ready && slot.chunk == m_written; });
+				data.swap(slot.data);
+				slot.ready = false;
+			}
+			out.write(data.data(), data.size());
+			{
+				std::lock_guard<std::mutex> lck(m_lock);
+				++m_written;
+			}
+			m_cv.notify_all();
+		}
+		for(std::thread & t : workers) {
+			t.join();
+		}
+		out.flush();
+	}
+private:
+	struct Slot {
+		std::string data;
+		uint64_t chunk = 0;
+		bool ready = false;
+	};
+private:
+	void work(Renderer render) {
+		std::ostringstream ss;
+		OutputBuffer out(ss);
+		for(uint64_t chunk(m_nextChunk++); chunk < m_numChunks; chunk = m_nextChunk++) {
+			render(chunk, out);
+			out.flush();
+			Slot & slot = m_slots[chunk % m_slots.size()];
+			{
+				std::unique_lock<std::mutex> lck(m_lock);
+				m_cv.wait(lck, [this, chunk]() { return chunk < m_written + m_slots.size(); });
+				slot.data = ss.str();
+				slot.chunk = chunk;
+				slot.ready = true;
+			}
+			m_cv.notify_all();
+			ss.str(std::string());
+		}
+	}
+private:
+	uint64_t m_numChunks;
+	int m_threads;
+	std::vector<Slot> m_slots;
+	std::atomic<uint64_t> m_nextChunk;
+	uint64_t m_written;
+	std::mutex m_lock;
+	std::condition_variable m_cv;
+};
+
+///number of random points per chunk
+constexpr uint64_t CHUNK_SIZE = 4096;
+
 int main(int argc, char ** argv) {
 	Config cfg;
-	PointGenerator * pg = 0;
 	
 	int ret = cfg.parse(argc, argv);
 	if (ret <= 0) {
 		return ret;
 	}
 	
-	if (cfg.gt == GT_NPLANE) {
-		pg = new NPlanePointGenerator();
-	}
-	else if (cfg.gt == GT_NSPHERE) {
-		pg = new NSpherePointGenerator();
-	}
-	else if (cfg.gt == GT_CGAL) {
-		pg = new CGALPointGenerator();
-	}
-	else if (cfg.gt == GT_GEO) {
-		pg = new GeoPointGenerator();
-	}
-	else if (cfg.gt == GT_GEOGRID) {
-		GeoGridGenerator myPg;
-		if (!myPg.supports(cfg.dimension)) {
-			std::cerr << "Selected generator does not support the selected dimension" << std::endl;
+	if (cfg.gt == GT_GEOGRID) {
+		if (cfg.count > GeoGridGenerator::MAX_SLICES) {
+			std::cerr << "Number of slices has to be at most " << GeoGridGenerator::MAX_SLICES << std::endl;
 			return -1;
 		}
-		std::vector<RationalPoint> gridPoints = myPg.generateAll( cfg.count );
-		for( RationalPoint & p : gridPoints ){
-			p.print(std::cout, cfg.ft);
-			std::cout << '\n';
+		GeoGridGenerator grid(cfg.count, cfg.significands);
+		if (!grid.supports(cfg.dimension)) {
+			std::cerr << "Selected generator does not support the selected dimension" << std::endl;
+			return -1;
 		}
+		//one chunk per band
+		ChunkWriter writer(grid.numBands(), cfg.threads);
+		writer.run(std::cout, [&cfg]() -> ChunkWriter::Renderer {
+			std::shared_ptr<GeoGridGenerator> g = std::make_shared<GeoGridGenerator>(cfg.count, cfg.significands);
+			return [g, &cfg](uint64_t chunk, OutputBuffer & out) {
+				g->generateBand(chunk, [&cfg, &out](const RationalPoint & p) {
+					p.print(out, cfg.ft);
+					out.put('\n');
+				});
+			};
+		});
 		return 0;
 	}
-
+	
+	std::unique_ptr<PointGenerator> pg( createGenerator(cfg.gt) );
 	if (!pg->supports(cfg.dimension)) {
 		std::cerr << "Selected generator does not support the selected dimension" << std::endl;
-		delete pg;
 		return -1;
 	}
 	
-	for(uint32_t i(0); i < cfg.count; ++i) {
-		RationalPoint p = pg->generate(cfg.dimension, cfg.snap);
-		p.print(std::cout, cfg.ft);
-		std::cout << '\n';
-	}
-	delete pg;
+	//point i uses the random stream i
+	ChunkWriter writer((cfg.count + CHUNK_SIZE - 1) / CHUNK_SIZE, cfg.threads);
+	writer.run(std::cout, [&cfg]() -> ChunkWriter::Renderer {
+		std::shared_ptr<PointGenerator> pg( createGenerator(cfg.gt) );
+		return [pg, &cfg](uint64_t chunk, OutputBuffer & out) {
+			uint64_t end = std::min(cfg.count, (chunk+1)*CHUNK_SIZE);
+			for(uint64_t i(chunk*CHUNK_SIZE); i < end; ++i) {
+				CounterEngine rng(cfg.seed, i);
+				RationalPoint p = pg->generate(cfg.dimension, cfg.snap, rng);
+				p.print(out, cfg.ft);
+				out.put('\n');
+			}
+		};
+	});
 	return 0;
-}
\ No newline at end of file
+}